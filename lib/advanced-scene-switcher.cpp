@@ -13,6 +13,7 @@
 #include "tab-helpers.hpp"
 #include "utility.hpp"
 #include "version.h"
+#include "wakeup-helpers.hpp"
 #include "websocket-api.hpp"
 
 #include <obs-frontend-api.h>
@@ -21,7 +22,9 @@
 #include <QLibrary>
 #include <QMainWindow>
 #include <QTextStream>
+#include <chrono>
 #include <regex>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -40,8 +43,6 @@ AdvSceneSwitcher::AdvSceneSwitcher(QWidget *parent)
 {
 	switcher->settingsWindowOpened = true;
 	ui->setupUi(this);
-	std::lock_guard<std::mutex> lock(switcher->m);
-	switcher->Prune();
 	LoadUI();
 }
 
@@ -116,23 +117,30 @@ void AdvSceneSwitcher::LoadUI()
 	DisplayMissingDependencyWarning();
 	DisplayCorruptedInstallWarning();
 
-	SetupGeneralTab();
-	SetupTitleTab();
-	SetupExecutableTab();
-	SetupRegionTab();
-	SetupPauseTab();
-	SetupSequenceTab();
-	SetupTransitionsTab();
-	SetupIdleTab();
-	SetupRandomTab();
-	SetupMediaTab();
-	SetupFileTab();
-	SetupTimeTab();
-	SetupAudioTab();
-	SetupVideoTab();
-	SetupSceneGroupTab();
+	{
+		std::lock_guard<std::mutex> lock(switcher->m);
+		switcher->Prune();
+		SetupGeneralTab();
+		SetupTitleTab();
+		SetupExecutableTab();
+		SetupRegionTab();
+		SetupPauseTab();
+		SetupSequenceTab();
+		SetupTransitionsTab();
+		SetupIdleTab();
+		SetupRandomTab();
+		SetupMediaTab();
+		SetupFileTab();
+		SetupTimeTab();
+		SetupAudioTab();
+		SetupVideoTab();
+		SetupSceneGroupTab();
+		SetupOtherTabs(ui->tabWidget);
+	}
+
+	// The macro list is only ever modified by the UI thread, so there is no
+	// need to block the macro checks while the macro tab is set up
 	SetupMacroTab();
-	SetupOtherTabs(ui->tabWidget);
 
 	SetDeprecationWarnings();
 	SetTabOrder(ui->tabWidget);
@@ -266,7 +274,24 @@ void SwitcherData::Thread()
 		vblog(LOG_INFO, "try to sleep for %ld",
 		      (long int)duration.count());
 		SetWaitScene();
-		cv.wait_for(lock, duration);
+		bool wokenByWakeup = false;
+		if (eventDrivenMacroChecks && !sleep) {
+			wokenByWakeup = WaitForIntervalOrWakeup(lock, duration);
+		} else {
+			cv.wait_for(lock, duration);
+		}
+		lastHandledWakeup = GetWakeupCount();
+
+		if (wokenByWakeup) {
+			Prune();
+			if (stop) {
+				break;
+			}
+			// Keep startTime unchanged so the next regular interval
+			// is not delayed by the event triggered check
+			RunWakeupTriggeredInterval();
+			continue;
+		}
 
 		startTime = std::chrono::high_resolution_clock::now();
 		sleep = 0;
@@ -330,22 +355,88 @@ void SwitcherData::Thread()
 	blog(LOG_INFO, "stopped");
 }
 
+bool SwitcherData::WaitForIntervalOrWakeup(std::unique_lock<std::mutex> &lock,
+					   std::chrono::milliseconds duration)
+{
+	// Limit how often wakeup sources can trigger condition checks
+	static constexpr std::chrono::milliseconds minWakeupSpacing(10);
+
+	const auto deadline = std::chrono::high_resolution_clock::now() +
+			      duration;
+	cv.wait_for(lock, std::min(duration, minWakeupSpacing));
+	if (stop) {
+		return false;
+	}
+
+	// A wakeup signaled after the predicate was evaluated but before
+	// waitingForWakeup is set might only be handled in the next interval
+	waitingForWakeup = true;
+	const bool wakeupPending = cv.wait_until(lock, deadline, [this]() {
+		return stop || GetWakeupCount() != lastHandledWakeup;
+	});
+	waitingForWakeup = false;
+
+	return wakeupPending && !stop &&
+	       std::chrono::high_resolution_clock::now() < deadline;
+}
+
+void SwitcherData::RunWakeupTriggeredInterval()
+{
+	vblog(LOG_INFO, "wakeup source fired - checking affected macros");
+	if (checkPause()) {
+		return;
+	}
+	InvalidateMacroTempVarValues();
+
+	wakeupTriggeredInterval = true;
+	bool match = CheckMacros();
+	wakeupTriggeredInterval = false;
+	if (stop) {
+		return;
+	}
+
+	checkSwitchCooldown(match);
+	RunIntervalResetSteps();
+	if (match) {
+		RunMacros();
+	}
+}
+
+// Compiled expressions of the ignored windows.
+// Invalid expressions are stored as nullptr.
+static std::unordered_map<std::string, std::unique_ptr<std::regex>>
+	ignoreWindowExpressions;
+
+static bool matchesIgnoredWindow(const std::string &title,
+				 const std::string &window)
+{
+	auto it = ignoreWindowExpressions.find(window);
+	if (it == ignoreWindowExpressions.end()) {
+		std::unique_ptr<std::regex> expr;
+		try {
+			expr = std::make_unique<std::regex>(window);
+		} catch (const std::regex_error &) {
+		}
+		it = ignoreWindowExpressions.emplace(window, std::move(expr))
+			     .first;
+	}
+	return it->second && std::regex_match(title, *it->second);
+}
+
 void SwitcherData::SetPreconditions()
 {
 	// Window title
 	lastTitle = currentTitle;
 	std::string title;
 	GetCurrentWindowTitle(title);
+	if (ignoreWindowExpressions.size() > ignoreWindowsSwitches.size()) {
+		ignoreWindowExpressions.clear();
+	}
 	for (auto &window : ignoreWindowsSwitches) {
 		bool equals = (title == window);
 		bool matches = false;
 		if (!equals) {
-			try {
-				std::regex expr(window);
-				matches = std::regex_match(title, expr);
-
-			} catch (const std::regex_error &) {
-			}
+			matches = matchesIgnoredWindow(title, window);
 		}
 		if (equals || matches) {
 			title = lastTitle;
@@ -522,6 +613,7 @@ extern "C" EXPORT void FreeSceneSwitcher()
 	PlatformCleanup();
 	RunPluginCleanupSteps();
 
+	SetWakeupNotifyCallback({});
 	delete switcher;
 	switcher = nullptr;
 }
@@ -678,6 +770,7 @@ static void OBSEvent(enum obs_frontend_event event, void *switcher)
 	default:
 		break;
 	}
+	SignalWakeup(WakeupSource::FRONTEND_EVENT);
 }
 
 static void LoadPlugins()
@@ -697,9 +790,14 @@ static void LoadPlugins()
 		blog(LOG_INFO, "attempting to load \"%s\"",
 		     file.toStdString().c_str());
 		auto lib = new QLibrary(file, nullptr);
+		const auto start = std::chrono::steady_clock::now();
 		if (lib->load()) {
-			blog(LOG_INFO, "successfully loaded \"%s\"",
-			     file.toStdString().c_str());
+			const auto duration = std::chrono::duration_cast<
+				std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - start);
+			blog(LOG_INFO, "successfully loaded \"%s\" (%lld ms)",
+			     file.toStdString().c_str(),
+			     static_cast<long long>(duration.count()));
 		} else {
 			blog(LOG_WARNING, "failed to load \"%s\": %s",
 			     file.toStdString().c_str(),
@@ -763,6 +861,11 @@ extern "C" EXPORT void InitSceneSwitcher(obs_module_t *module,
 	blog(LOG_INFO, "version: %s", g_GIT_SHA1);
 
 	switcher = new SwitcherData(module, translate);
+	SetWakeupNotifyCallback([]() {
+		if (switcher && switcher->waitingForWakeup) {
+			switcher->cv.notify_all();
+		}
+	});
 
 	PlatformInit();
 	LoadPlugins();
@@ -68,11 +68,15 @@ public slots:
 	void on_uiHintsDisable_stateChanged(int state);
 	void on_disableComboBoxFilter_stateChanged(int state);
 	void on_disableMacroWidgetCache_stateChanged(int state);
+	void on_macroWidgetCacheSize_valueChanged(int value);
+	void on_macroWidgetCacheMemoryLimit_valueChanged(int value);
+	void on_eventDrivenMacroChecks_stateChanged(int state);
 	void on_warnPluginLoadFailure_stateChanged(int state);
 	void on_hideLegacyTabs_stateChanged(int state);
 	void on_priorityUp_clicked();
 	void on_priorityDown_clicked();
 	void on_threadPriority_currentTextChanged(const QString &text);
+	void on_macroConditionCheckThreadCount_valueChanged(int value);
 
 	/* --- End of legacy tab section --- */
 
@@ -96,6 +100,8 @@ public:
 	void PopulateMacroActions(Macro &m, uint32_t afterIdx = 0);
 	void PopulateMacroElseActions(Macro &m, uint32_t afterIdx = 0);
 	void PopulateMacroConditions(Macro &m, uint32_t afterIdx = 0);
+	void PrefetchMacroSegmentWidgets(Macro &m);
+	void PrefetchNeighbourMacroWidgets(const std::shared_ptr<Macro> &);
 	void SetActionData(Macro &m) const;
 	void SetElseActionData(Macro &m) const;
 	void SetConditionData(Macro &m) const;
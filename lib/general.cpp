@@ -15,6 +15,7 @@
 #include "variable.hpp"
 #include "version.h"
 
+#include <chrono>
 #include <obs-frontend-api.h>
 #include <QFileDialog>
 
@@ -154,6 +155,16 @@ void AdvSceneSwitcher::on_checkInterval_valueChanged(int value)
 	SetCheckIntervalTooLowVisibility();
 }
 
+void AdvSceneSwitcher::on_macroConditionCheckThreadCount_valueChanged(int value)
+{
+	if (loading) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	switcher->macroConditionCheckThreadCount = value;
+}
+
 void AdvSceneSwitcher::closeEvent(QCloseEvent *)
 {
 	if (!switcher) {
@@ -213,6 +224,50 @@ void AdvSceneSwitcher::on_disableMacroWidgetCache_stateChanged(int state)
 
 	switcher->disableMacroWidgetCache = state;
 	MacroSegmentList::SetCachingEnabled(!state);
+	ui->macroWidgetCacheSize->setDisabled(state);
+	ui->macroWidgetCacheMemoryLimit->setDisabled(state);
+}
+
+static void setMacroWidgetCacheLimits()
+{
+	// The limits apply to each of the condition, action and else action
+	// lists separately
+	static constexpr size_t listCount = 3;
+	const size_t memoryLimit =
+		static_cast<size_t>(switcher->macroWidgetCacheMemoryLimit) *
+		1024 * 1024;
+	MacroSegmentList::SetCacheLimits(switcher->macroWidgetCacheSize,
+					 memoryLimit / listCount);
+}
+
+void AdvSceneSwitcher::on_macroWidgetCacheSize_valueChanged(int value)
+{
+	if (loading) {
+		return;
+	}
+
+	switcher->macroWidgetCacheSize = value;
+	setMacroWidgetCacheLimits();
+}
+
+void AdvSceneSwitcher::on_macroWidgetCacheMemoryLimit_valueChanged(int value)
+{
+	if (loading) {
+		return;
+	}
+
+	switcher->macroWidgetCacheMemoryLimit = value;
+	setMacroWidgetCacheLimits();
+}
+
+void AdvSceneSwitcher::on_eventDrivenMacroChecks_stateChanged(int state)
+{
+	if (loading) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(switcher->m);
+	switcher->eventDrivenMacroChecks = state;
 }
 
 void AdvSceneSwitcher::on_warnPluginLoadFailure_stateChanged(int state)
@@ -444,26 +499,44 @@ void AdvSceneSwitcher::on_adjustActiveTransitionType_stateChanged(int state)
 	switcher->adjustActiveTransitionType = state;
 }
 
+static long long getElapsedMs(std::chrono::steady_clock::time_point &start)
+{
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed =
+		std::chrono::duration_cast<std::chrono::milliseconds>(now -
+								      start);
+	start = now;
+	return elapsed.count();
+}
+
 void SwitcherData::LoadSettings(obs_data_t *obj)
 {
 	if (!obj) {
 		return;
 	}
 
+	auto start = std::chrono::steady_clock::now();
+
 	// New post load steps to be declared during load
-	postLoadSteps.clear();
+	{
+		std::lock_guard<std::mutex> lock(postLoadStepsMutex);
+		postLoadSteps.clear();
+	}
 
 	// Needs to be loaded before any entries which might rely on scene group
 	// selections to be available.
 	loadSceneGroups(obj);
 	LoadVariables(obj);
+	const auto variablesMs = getElapsedMs(start);
 
 	for (const auto &func : loadSteps) {
 		func(obj);
 	}
+	const auto loadStepsMs = getElapsedMs(start);
 
 	LoadMacros(obj);
 	LoadGlobalMacroSettings(obj);
+	const auto macrosMs = getElapsedMs(start);
 	loadWindowTitleSwitches(obj);
 	loadScreenRegionSwitches(obj);
 	loadPauseSwitches(obj);
@@ -480,8 +553,23 @@ void SwitcherData::LoadSettings(obs_data_t *obj)
 	LoadGeneralSettings(obj);
 	LoadHotkeys(obj);
 	LoadUISettings(obj);
+	const auto otherMs = getElapsedMs(start);
 
 	RunPostLoadSteps();
+	const auto postLoadStepsMs = getElapsedMs(start);
+
+	size_t lazilyLoadedMacros = 0;
+	for (const auto &macro : GetMacros()) {
+		if (!macro->SegmentsLoaded()) {
+			lazilyLoadedMacros++;
+		}
+	}
+	blog(LOG_INFO,
+	     "settings loaded (variables: %lld ms, load steps: %lld ms, "
+	     "macros: %lld ms, %zu macros loaded lazily, other: %lld ms, "
+	     "post load steps: %lld ms)",
+	     variablesMs, loadStepsMs, macrosMs, lazilyLoadedMacros, otherMs,
+	     postLoadStepsMs);
 
 	// Reset on startup and scene collection change
 	ResetLastOpenedTab();
@@ -552,12 +640,19 @@ void SwitcherData::SaveGeneralSettings(obs_data_t *obj)
 			  disableFilterComboboxFilter);
 	obs_data_set_bool(obj, "disableMacroWidgetCache",
 			  disableMacroWidgetCache);
+	obs_data_set_int(obj, "macroWidgetCacheSize", macroWidgetCacheSize);
+	obs_data_set_int(obj, "macroWidgetCacheMemoryLimit",
+			 macroWidgetCacheMemoryLimit);
+	obs_data_set_bool(obj, "eventDrivenMacroChecks",
+			  eventDrivenMacroChecks);
 	obs_data_set_bool(obj, "warnPluginLoadFailure", warnPluginLoadFailure);
 	obs_data_set_bool(obj, "hideLegacyTabs", hideLegacyTabs);
 
 	SaveFunctionPriorities(obj, functionNamesByPriority);
 
 	obs_data_set_int(obj, "threadPriority", threadPriority);
+	obs_data_set_int(obj, "macroConditionCheckThreadCount",
+			 macroConditionCheckThreadCount);
 
 	obs_data_set_bool(obj, "transitionOverrideOverride",
 			  transitionOverrideOverride);
@@ -611,6 +706,13 @@ void SwitcherData::LoadGeneralSettings(obs_data_t *obj)
 		obs_data_get_bool(obj, "disableFilterComboboxFilter");
 	disableMacroWidgetCache =
 		obs_data_get_bool(obj, "disableMacroWidgetCache");
+	obs_data_set_default_int(obj, "macroWidgetCacheSize", 20);
+	macroWidgetCacheSize = obs_data_get_int(obj, "macroWidgetCacheSize");
+	obs_data_set_default_int(obj, "macroWidgetCacheMemoryLimit", 150);
+	macroWidgetCacheMemoryLimit =
+		obs_data_get_int(obj, "macroWidgetCacheMemoryLimit");
+	eventDrivenMacroChecks =
+		obs_data_get_bool(obj, "eventDrivenMacroChecks");
 	obs_data_set_default_bool(obj, "warnPluginLoadFailure", true);
 	warnPluginLoadFailure = obs_data_get_bool(obj, "warnPluginLoadFailure");
 	obs_data_set_default_bool(obj, "hideLegacyTabs", true);
@@ -625,6 +727,9 @@ void SwitcherData::LoadGeneralSettings(obs_data_t *obj)
 	obs_data_set_default_int(obj, "threadPriority",
 				 QThread::NormalPriority);
 	threadPriority = obs_data_get_int(obj, "threadPriority");
+	obs_data_set_default_int(obj, "macroConditionCheckThreadCount", 1);
+	macroConditionCheckThreadCount =
+		obs_data_get_int(obj, "macroConditionCheckThreadCount");
 
 	transitionOverrideOverride =
 		obs_data_get_bool(obj, "transitionOverrideOverride");
@@ -909,11 +1014,23 @@ void AdvSceneSwitcher::SetupGeneralTab()
 	ui->disableMacroWidgetCache->setChecked(
 		switcher->disableMacroWidgetCache);
 	MacroSegmentList::SetCachingEnabled(!switcher->disableMacroWidgetCache);
+	ui->macroWidgetCacheSize->setValue(switcher->macroWidgetCacheSize);
+	ui->macroWidgetCacheSize->setDisabled(
+		switcher->disableMacroWidgetCache);
+	ui->macroWidgetCacheMemoryLimit->setValue(
+		switcher->macroWidgetCacheMemoryLimit);
+	ui->macroWidgetCacheMemoryLimit->setDisabled(
+		switcher->disableMacroWidgetCache);
+	setMacroWidgetCacheLimits();
+	ui->eventDrivenMacroChecks->setChecked(
+		switcher->eventDrivenMacroChecks);
 	ui->warnPluginLoadFailure->setChecked(switcher->warnPluginLoadFailure);
 	ui->hideLegacyTabs->setChecked(switcher->hideLegacyTabs);
 
 	populatePriorityFunctionList(ui->priorityList);
 	populateThreadPriorityList(ui->threadPriority);
+	ui->macroConditionCheckThreadCount->setValue(
+		switcher->macroConditionCheckThreadCount);
 
 	populateStartupBehavior(ui->startupBehavior);
 	ui->startupBehavior->setCurrentIndex(
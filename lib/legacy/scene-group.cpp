@@ -1,6 +1,7 @@
 #include "advanced-scene-switcher.hpp"
 #include "layout-helpers.hpp"
 #include "name-dialog.hpp"
+#include "save-data-cache.hpp"
 #include "selection-helpers.hpp"
 #include "source-helpers.hpp"
 #include "switcher-data.hpp"
@@ -194,6 +195,8 @@ void AdvSceneSwitcher::on_sceneGroupRemove_clicked()
 		name = QString::fromStdString(sg[idx].name);
 		sg.erase(sg.begin() + idx);
 	}
+	// Scene selections save the name of the scene group they refer to
+	SaveDataCache::InvalidateAll();
 
 	delete item;
 
@@ -212,6 +215,9 @@ void AdvSceneSwitcher::on_sceneGroupUp_clicked()
 
 		iter_swap(switcher->sceneGroups.begin() + index,
 			  switcher->sceneGroups.begin() + index - 1);
+		// Scene selections point to the scene groups in the list, so
+		// they refer to a different scene group after swapping
+		SaveDataCache::InvalidateAll();
 	}
 }
 
@@ -227,6 +233,7 @@ void AdvSceneSwitcher::on_sceneGroupDown_clicked()
 
 		iter_swap(switcher->sceneGroups.begin() + index,
 			  switcher->sceneGroups.begin() + index + 1);
+		SaveDataCache::InvalidateAll();
 	}
 }
 
@@ -276,6 +283,7 @@ void AdvSceneSwitcher::on_sceneGroupName_editingFinished()
 		std::lock_guard<std::mutex> lock(switcher->m);
 		if (nameValid) {
 			currentSG->name = newName.toUtf8().constData();
+			SaveDataCache::InvalidateAll();
 			QListWidgetItem *sgItem =
 				ui->sceneGroups->currentItem();
 			sgItem->setData(Qt::UserRole, newName);
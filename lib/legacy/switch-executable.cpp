@@ -1,6 +1,7 @@
 #include "advanced-scene-switcher.hpp"
 #include "layout-helpers.hpp"
 #include "platform-funcs.hpp"
+#include "process-table.hpp"
 #include "selection-helpers.hpp"
 #include "switcher-data.hpp"
 #include "ui-helpers.hpp"
@@ -92,20 +93,21 @@ bool SwitcherData::checkExeSwitch(OBSWeakSource &scene,
 	}
 
 	std::string title = switcher->currentTitle;
-	QStringList runningProcesses;
 	bool ignored = false;
 	bool match = false;
 
 	// Check for match
-	GetProcessList(runningProcesses);
+	const auto processTable = GetProcessTable();
+	const auto &runningProcesses = processTable->processes;
 	for (ExecutableSwitch &s : executableSwitches) {
 		if (!s.initialized()) {
 			continue;
 		}
 
-		bool equals = runningProcesses.contains(s.exe);
-		bool matches = (runningProcesses.indexOf(
-					QRegularExpression(s.exe)) != -1);
+		bool equals = processTable->names.contains(s.exe);
+		bool matches = !equals &&
+			       runningProcesses.indexOf(
+				       QRegularExpression(s.exe)) != -1;
 		bool focus = (!s.inFocus || IsInFocus(s.exe));
 
 		// True if current window is ignored AND switch equals OR matches last window
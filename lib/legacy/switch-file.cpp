@@ -1,6 +1,8 @@
 #include "advanced-scene-switcher.hpp"
 #include "curl-helper.hpp"
+#include "file-content-cache.hpp"
 #include "layout-helpers.hpp"
+#include "remote-file-cache.hpp"
 #include "source-helpers.hpp"
 #include "switcher-data.hpp"
 #include "ui-helpers.hpp"
@@ -19,7 +21,6 @@ namespace advss {
 
 bool FileSwitch::pause = false;
 static QObject *addPulse = nullptr;
-static std::hash<std::string> strHash;
 
 static void writeToStatusFile(const QString &msg)
 {
@@ -175,83 +176,57 @@ bool SwitcherData::checkSwitchInfoFromFile(OBSWeakSource &scene,
 	return match;
 }
 
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
-			    void *userp)
-{
-	((std::string *)userp)->append((char *)contents, size * nmemb);
-	return size * nmemb;
-}
-
-static std::string getRemoteData(std::string &url)
-{
-	std::string readBuffer;
-
-	CurlHelper::SetOpt(CURLOPT_URL, url.c_str());
-	CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, WriteCallback);
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &readBuffer);
-
-	// Set timeout to at least one second
-	int timeout = switcher->interval / 1000;
-	if (timeout == 0) {
-		timeout = 1;
-	}
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT, 1);
-	CurlHelper::Perform();
-
-	return readBuffer;
-}
-
-bool matchFileContent(QString &filedata, FileSwitch &s)
+bool matchFileContent(const std::string &filedata, uint64_t hash,
+		      FileSwitch &s)
 {
 	if (s.onlyMatchIfChanged) {
-		size_t newHash = strHash(filedata.toUtf8().constData());
-		if (newHash == s.lastHash) {
+		if (hash == s.lastHash) {
 			return false;
 		}
-		s.lastHash = newHash;
+		s.lastHash = hash;
 	}
 
 	if (s.useRegex) {
 		try {
 			std::regex expr(s.text);
-			return std::regex_match(filedata.toStdString(), expr);
+			return std::regex_match(filedata, expr);
 		} catch (const std::regex_error &) {
 			return false;
 		}
 	}
 
 	QString text = QString::fromStdString(s.text);
-	return CompareIgnoringLineEnding(text, filedata);
+	QString data = QString::fromStdString(filedata);
+	return CompareIgnoringLineEnding(text, data);
 }
 
 bool checkRemoteFileContent(FileSwitch &s)
 {
-	std::string data = getRemoteData(s.file);
-	QString qdata = QString::fromStdString(data);
-	return matchFileContent(qdata, s);
+	const auto content = GetRemoteFileContent(
+		s.file, std::chrono::milliseconds(switcher->interval));
+	if (!content) {
+		return false;
+	}
+	return matchFileContent(*content->data, content->hash, s);
 }
 
 bool checkLocalFileContent(FileSwitch &s)
 {
-	QString t = QString::fromStdString(s.text);
-	QFile file(QString::fromStdString(s.file));
-	if (!file.open(QIODevice::ReadOnly)) {
+	const auto content = GetFileContent(s.file);
+	if (!content) {
 		return false;
 	}
 
 	if (s.useTime) {
-		QDateTime newLastMod = QFileInfo(file).lastModified();
+		const QFileInfo info(QString::fromStdString(s.file));
+		QDateTime newLastMod = info.lastModified();
 		if (s.lastMod == newLastMod) {
 			return false;
 		}
 		s.lastMod = newLastMod;
 	}
 
-	QString filedata = QTextStream(&file).readAll();
-	bool match = matchFileContent(filedata, s);
-
-	file.close();
-	return match;
+	return matchFileContent(*content->data, content->hash, s);
 }
 
 bool SwitcherData::checkFileContent(OBSWeakSource &scene,
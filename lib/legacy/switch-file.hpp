@@ -30,7 +30,7 @@ struct FileSwitch : SceneSwitcherEntry {
 	bool useTime = false;
 	bool onlyMatchIfChanged = false;
 	QDateTime lastMod;
-	size_t lastHash = 0;
+	uint64_t lastHash = 0;
 
 	const char *getType() { return "file"; }
 	void save(obs_data_t *obj);
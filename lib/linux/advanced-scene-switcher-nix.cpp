@@ -18,12 +18,16 @@
 #undef Status
 #undef Unsorted
 #include <util/platform.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
 #include <vector>
 #include <thread>
 #include <unordered_map>
 #include <QStringList>
 #include <QRegularExpression>
 #include <QLibrary>
+#include <QTimer>
 #ifdef PROCPS_AVAILABLE
 #include <proc/readproc.h>
 #endif
@@ -93,12 +97,8 @@ void cleanupDisplay()
 	xdisplay = 0;
 }
 
-static bool ewmhIsSupported()
+static bool queryEwmhSupport(Display *display)
 {
-	Display *display = disp();
-	if (!display) {
-		return false;
-	}
 	auto window = DefaultRootWindow(display);
 	if (!window) {
 		return false;
@@ -142,102 +142,435 @@ static bool ewmhIsSupported()
 	return ewmhWindow != 0;
 }
 
-static QStringList getStates(Window window)
+static std::string getWindowName(Display *display, Window window)
 {
+	if (!display || !window) {
+		return "";
+	}
+	std::string windowTitle;
+	char *name;
+	int status = XFetchName(display, window, &name);
+	if (status >= Success && name != nullptr) {
+		std::string str(name);
+		windowTitle = str;
+		XFree(name);
+	} else {
+		XTextProperty xtp_new_name;
+		if (XGetWMName(display, window, &xtp_new_name) != 0 &&
+		    xtp_new_name.value != nullptr) {
+			std::string str((const char *)xtp_new_name.value);
+			windowTitle = str;
+			XFree(xtp_new_name.value);
+		}
+	}
+
+	return windowTitle;
+}
+
+namespace {
+
+struct WindowInfo {
+	std::string title;
+	bool titleValid = false;
 	QStringList states;
-	if (!window || !ewmhIsSupported()) {
-		return states;
+	bool statesValid = false;
+	long pid = -1;
+};
+
+// Caches the state of the top level windows.
+//
+// The X server reports property changes of the root windows and of all known
+// client windows, so properties are only queried again after they changed
+// instead of on every call.
+// The events have to be drained even if no queries are performed, so the
+// event queue does not grow indefinitely. If the cache was not used for a
+// while, property changes are no longer observed at all.
+class WindowCache {
+public:
+	// Applies all pending property changes reported by the X server
+	void Sync();
+	// Drains the event queue or stops observing windows once the cache is
+	// no longer used
+	void Maintain();
+	void Reset();
+
+	bool EwmhIsSupported();
+	const std::vector<Window> &GetTopLevelWindows();
+	Window GetActiveWindow();
+	const std::string &GetTitle(Window);
+	const QStringList &GetStates(Window);
+	long GetPid(Window);
+
+private:
+	void Init(Display *);
+	void ProcessEvents();
+	void Release();
+	void HandleEvent(const XPropertyEvent &);
+	void UpdateTopLevelWindows();
+	WindowInfo &GetInfo(Window);
+	const QString &GetAtomName(Atom);
+
+	Display *_display = nullptr;
+	std::vector<Window> _rootWindows;
+	Atom _supportingWmCheckAtom = 0;
+	Atom _clientListAtom = 0;
+	Atom _activeWindowAtom = 0;
+	Atom _wmStateAtom = 0;
+	Atom _wmNameAtom = 0;
+	Atom _wmPidAtom = 0;
+
+	bool _ewmhSupported = false;
+	bool _ewmhSupportValid = false;
+	std::vector<Window> _windows;
+	bool _windowsValid = false;
+	Window _activeWindow = 0;
+	bool _activeWindowValid = false;
+	std::unordered_map<Window, WindowInfo> _windowInfo;
+	std::unordered_map<Atom, QString> _atomNames;
+	std::chrono::steady_clock::time_point _lastSync;
+};
+
+} // namespace
+
+void WindowCache::Init(Display *display)
+{
+	Reset();
+	_display = display;
+	_supportingWmCheckAtom =
+		XInternAtom(display, "_NET_SUPPORTING_WM_CHECK", false);
+	_clientListAtom = XInternAtom(display, "_NET_CLIENT_LIST", false);
+	_activeWindowAtom = XInternAtom(display, "_NET_ACTIVE_WINDOW", false);
+	_wmStateAtom = XInternAtom(display, "_NET_WM_STATE", false);
+	_wmNameAtom = XInternAtom(display, "_NET_WM_NAME", false);
+	_wmPidAtom = XInternAtom(display, "_NET_WM_PID", false);
+
+	for (int i = 0; i < ScreenCount(display); ++i) {
+		Window rootWindow = RootWindow(display, i);
+		if (!rootWindow) {
+			continue;
+		}
+		XSelectInput(display, rootWindow, PropertyChangeMask);
+		_rootWindows.emplace_back(rootWindow);
 	}
+}
 
-	Atom wmState = XInternAtom(disp(), "_NET_WM_STATE", true), type;
-	int format;
-	unsigned long num, bytes;
-	unsigned char *data;
+void WindowCache::Reset()
+{
+	_display = nullptr;
+	_rootWindows.clear();
+	_ewmhSupportValid = false;
+	_windows.clear();
+	_windowsValid = false;
+	_activeWindow = 0;
+	_activeWindowValid = false;
+	_windowInfo.clear();
+	_atomNames.clear();
+}
+
+void WindowCache::Sync()
+{
+	auto display = disp();
+	if (!display) {
+		Reset();
+		return;
+	}
+	if (display != _display) {
+		Init(display);
+	}
+	ProcessEvents();
+	_lastSync = std::chrono::steady_clock::now();
+}
 
-	int status = XGetWindowProperty(disp(), window, wmState, 0, ~0L, false,
-					AnyPropertyType, &type, &format, &num,
-					&bytes, &data);
+void WindowCache::Maintain()
+{
+	if (!_display) {
+		return;
+	}
 
-	if (status == Success) {
-		for (unsigned long i = 0; i < num; i++) {
-			states.append(QString(
-				XGetAtomName(disp(), ((Atom *)data)[i])));
+	static constexpr auto idleTimeout = std::chrono::seconds(10);
+	if (std::chrono::steady_clock::now() - _lastSync > idleTimeout) {
+		Release();
+		return;
+	}
+	ProcessEvents();
+}
+
+void WindowCache::ProcessEvents()
+{
+	while (XPending(_display) > 0) {
+		XEvent event;
+		XNextEvent(_display, &event);
+		if (event.type == PropertyNotify) {
+			HandleEvent(event.xproperty);
 		}
-		XFree(data);
+	}
+}
+
+void WindowCache::Release()
+{
+	for (const auto rootWindow : _rootWindows) {
+		XSelectInput(_display, rootWindow, NoEventMask);
+	}
+	for (const auto &[window, _] : _windowInfo) {
+		XSelectInput(_display, window, NoEventMask);
+	}
+	// Discard the events which were queued in the meantime
+	XSync(_display, true);
+	Reset();
+}
+
+void WindowCache::HandleEvent(const XPropertyEvent &event)
+{
+	const bool isRootWindow = std::find(_rootWindows.begin(),
+					    _rootWindows.end(),
+					    event.window) != _rootWindows.end();
+	if (isRootWindow) {
+		if (event.atom == _clientListAtom) {
+			_windowsValid = false;
+		} else if (event.atom == _activeWindowAtom) {
+			_activeWindowValid = false;
+		} else if (event.atom == _supportingWmCheckAtom) {
+			_ewmhSupportValid = false;
+		}
+		return;
 	}
 
-	return states;
+	auto it = _windowInfo.find(event.window);
+	if (it == _windowInfo.end()) {
+		return;
+	}
+	if (event.atom == XA_WM_NAME || event.atom == _wmNameAtom) {
+		it->second.titleValid = false;
+	} else if (event.atom == _wmStateAtom) {
+		it->second.statesValid = false;
+	}
 }
 
-static std::vector<Window> getTopLevelWindows()
+bool WindowCache::EwmhIsSupported()
 {
-	std::vector<Window> res;
-	if (!ewmhIsSupported()) {
-		return res;
+	if (!_display) {
+		return false;
+	}
+	if (!_ewmhSupportValid) {
+		_ewmhSupported = queryEwmhSupport(_display);
+		_ewmhSupportValid = true;
+	}
+	return _ewmhSupported;
+}
+
+void WindowCache::UpdateTopLevelWindows()
+{
+	_windows.clear();
+	_windowsValid = true;
+	if (!EwmhIsSupported()) {
+		_windowInfo.clear();
+		return;
 	}
 
-	Atom netClList = XInternAtom(disp(), "_NET_CLIENT_LIST", true);
 	Atom actualType;
 	int format;
 	unsigned long num, bytes;
 	Window *data = 0;
 
-	for (int i = 0; i < ScreenCount(disp()); ++i) {
-		Window rootWindow = RootWindow(disp(), i);
-		if (!rootWindow) {
-			continue;
-		}
-
-		int status = XGetWindowProperty(disp(), rootWindow, netClList,
-						0L, ~0L, false, AnyPropertyType,
-						&actualType, &format, &num,
-						&bytes, (uint8_t **)&data);
+	for (const auto rootWindow : _rootWindows) {
+		int status = XGetWindowProperty(_display, rootWindow,
+						_clientListAtom, 0L, ~0L, false,
+						AnyPropertyType, &actualType,
+						&format, &num, &bytes,
+						(uint8_t **)&data);
 
 		if (status != Success) {
 			continue;
 		}
 
 		for (unsigned long i = 0; i < num; ++i) {
-			res.emplace_back(data[i]);
+			_windows.emplace_back(data[i]);
 		}
 
 		XFree(data);
 	}
 
-	return res;
+	// Forget about windows which no longer exist and start listening for
+	// property changes of new windows
+	std::unordered_map<Window, WindowInfo> windowInfo;
+	windowInfo.reserve(_windows.size());
+	for (const auto window : _windows) {
+		auto it = _windowInfo.find(window);
+		if (it != _windowInfo.end()) {
+			windowInfo.emplace(window, std::move(it->second));
+			continue;
+		}
+		XSelectInput(_display, window, PropertyChangeMask);
+		windowInfo.emplace(window, WindowInfo());
+	}
+	_windowInfo = std::move(windowInfo);
 }
 
-std::string getWindowName(Window window)
+const std::vector<Window> &WindowCache::GetTopLevelWindows()
 {
-	auto display = disp();
-	if (!display || !window) {
-		return "";
+	if (!_windowsValid && _display) {
+		UpdateTopLevelWindows();
 	}
-	std::string windowTitle;
-	char *name;
-	int status = XFetchName(display, window, &name);
-	if (status >= Success && name != nullptr) {
-		std::string str(name);
-		windowTitle = str;
-		XFree(name);
-	} else {
-		XTextProperty xtp_new_name;
-		if (XGetWMName(display, window, &xtp_new_name) != 0 &&
-		    xtp_new_name.value != nullptr) {
-			std::string str((const char *)xtp_new_name.value);
-			windowTitle = str;
-			XFree(xtp_new_name.value);
+	return _windows;
+}
+
+Window WindowCache::GetActiveWindow()
+{
+	if (_activeWindowValid || !_display) {
+		return _activeWindow;
+	}
+
+	_activeWindow = 0;
+	_activeWindowValid = true;
+	if (!EwmhIsSupported()) {
+		return _activeWindow;
+	}
+
+	auto rootWindow = DefaultRootWindow(_display);
+	if (!rootWindow) {
+		return _activeWindow;
+	}
+
+	Atom actualType;
+	int format;
+	unsigned long num, bytes;
+	Window *data = 0;
+	int status = XGetWindowProperty(_display, rootWindow,
+					_activeWindowAtom, 0L, ~0L, false,
+					AnyPropertyType, &actualType, &format,
+					&num, &bytes, (uint8_t **)&data);
+	if (status == Success && data) {
+		if (num > 0) {
+			_activeWindow = data[0];
 		}
+		XFree(data);
 	}
+	return _activeWindow;
+}
 
-	return windowTitle;
+WindowInfo &WindowCache::GetInfo(Window window)
+{
+	auto it = _windowInfo.find(window);
+	if (it != _windowInfo.end()) {
+		return it->second;
+	}
+
+	// Windows which are not part of the client list, like the desktop,
+	// have to be observed as well to keep their cached state up to date
+	XSelectInput(_display, window, PropertyChangeMask);
+	return _windowInfo[window];
 }
 
+const std::string &WindowCache::GetTitle(Window window)
+{
+	static const std::string empty;
+	if (!window || !_display) {
+		return empty;
+	}
+
+	auto &info = GetInfo(window);
+	if (!info.titleValid) {
+		info.title = getWindowName(_display, window);
+		info.titleValid = true;
+	}
+	return info.title;
+}
+
+const QString &WindowCache::GetAtomName(Atom atom)
+{
+	auto it = _atomNames.find(atom);
+	if (it != _atomNames.end()) {
+		return it->second;
+	}
+
+	QString name;
+	char *atomName = XGetAtomName(_display, atom);
+	if (atomName) {
+		name = atomName;
+		XFree(atomName);
+	}
+	return _atomNames.emplace(atom, name).first->second;
+}
+
+const QStringList &WindowCache::GetStates(Window window)
+{
+	static const QStringList empty;
+	if (!window || !EwmhIsSupported()) {
+		return empty;
+	}
+
+	auto &info = GetInfo(window);
+	if (info.statesValid) {
+		return info.states;
+	}
+
+	info.states.clear();
+	info.statesValid = true;
+
+	Atom type;
+	int format;
+	unsigned long num, bytes;
+	unsigned char *data;
+
+	int status = XGetWindowProperty(_display, window, _wmStateAtom, 0, ~0L,
+					false, AnyPropertyType, &type, &format,
+					&num, &bytes, &data);
+
+	if (status == Success) {
+		for (unsigned long i = 0; i < num; i++) {
+			info.states.append(GetAtomName(((Atom *)data)[i]));
+		}
+		XFree(data);
+	}
+
+	return info.states;
+}
+
+long WindowCache::GetPid(Window window)
+{
+	if (!window || !_display) {
+		return -1;
+	}
+
+	// The process owning a window does not change, so only windows for
+	// which the PID could not be determined yet are queried again
+	auto &info = GetInfo(window);
+	if (info.pid >= 0) {
+		return info.pid;
+	}
+
+	Atom actualType;
+	int actualFormat;
+	unsigned long nitems;
+	unsigned long bytesAfter;
+	unsigned char *prop = nullptr;
+	auto status = XGetWindowProperty(_display, window, _wmPidAtom, 0, 1024,
+					 False, XA_CARDINAL, &actualType,
+					 &actualFormat, &nitems, &bytesAfter,
+					 &prop);
+	if (status != 0) {
+		return -2;
+	}
+	if (!prop) {
+		return -3;
+	}
+
+	info.pid = *((long *)prop);
+	XFree(prop);
+	return info.pid;
+}
+
+static std::mutex windowCacheMutex;
+static WindowCache windowCache;
+static QTimer *windowCacheTimer = nullptr;
+
 void GetWindowList(std::vector<std::string> &windows)
 {
 	windows.resize(0);
-	for (auto window : getTopLevelWindows()) {
-		auto name = getWindowName(window);
+	std::lock_guard<std::mutex> lock(windowCacheMutex);
+	windowCache.Sync();
+	for (auto window : windowCache.GetTopLevelWindows()) {
+		const auto &name = windowCache.GetTitle(window);
 		if (name.empty()) {
 			continue;
 		}
@@ -248,8 +581,10 @@ void GetWindowList(std::vector<std::string> &windows)
 void GetWindowList(QStringList &windows)
 {
 	windows.clear();
-	for (auto window : getTopLevelWindows()) {
-		auto name = getWindowName(window);
+	std::lock_guard<std::mutex> lock(windowCacheMutex);
+	windowCache.Sync();
+	for (auto window : windowCache.GetTopLevelWindows()) {
+		const auto &name = windowCache.GetTitle(window);
 		if (name.empty()) {
 			continue;
 		}
@@ -257,27 +592,6 @@ void GetWindowList(QStringList &windows)
 	}
 }
 
-int getActiveWindow(Window *&window)
-{
-	if (!ewmhIsSupported()) {
-		return -1;
-	}
-
-	Atom active = XInternAtom(disp(), "_NET_ACTIVE_WINDOW", true);
-	Atom actualType;
-	int format;
-	unsigned long num, bytes;
-
-	auto rootWindow = DefaultRootWindow(disp());
-	if (!rootWindow) {
-		return -2;
-	}
-
-	return XGetWindowProperty(disp(), rootWindow, active, 0L, ~0L, false,
-				  AnyPropertyType, &actualType, &format, &num,
-				  &bytes, (uint8_t **)&window);
-}
-
 void GetCurrentWindowTitle(std::string &title)
 {
 	if (KWin) {
@@ -285,18 +599,9 @@ void GetCurrentWindowTitle(std::string &title)
 		return;
 	}
 
-	Window *data = 0;
-	if (getActiveWindow(data) != Success || !data) {
-		return;
-	}
-	if (!data[0]) {
-		XFree(data);
-		return;
-	}
-
-	auto name = getWindowName(data[0]);
-	XFree(data);
-
+	std::lock_guard<std::mutex> lock(windowCacheMutex);
+	windowCache.Sync();
+	const auto &name = windowCache.GetTitle(windowCache.GetActiveWindow());
 	if (name.empty()) {
 		return;
 	}
@@ -306,27 +611,28 @@ void GetCurrentWindowTitle(std::string &title)
 bool windowStatesAreSet(const std::string &windowTitle,
 			std::vector<QString> &expectedStates)
 {
-	if (!ewmhIsSupported()) {
+	std::lock_guard<std::mutex> lock(windowCacheMutex);
+	windowCache.Sync();
+	if (!windowCache.EwmhIsSupported()) {
 		return false;
 	}
 
-	std::vector<Window> windows = getTopLevelWindows();
-	for (auto &window : windows) {
-		auto name = getWindowName(window);
+	const QRegularExpression expression(
+		QString::fromStdString(windowTitle));
+	for (auto window : windowCache.GetTopLevelWindows()) {
+		const auto &name = windowCache.GetTitle(window);
 		if (name.empty()) {
 			continue;
 		}
 
-		bool equals = windowTitle == name;
-		bool matches = QString::fromStdString(name).contains(
-			QRegularExpression(
-				QString::fromStdString(windowTitle)));
-
-		if (!(equals || matches)) {
+		const bool matches =
+			windowTitle == name ||
+			QString::fromStdString(name).contains(expression);
+		if (!matches) {
 			continue;
 		}
 
-		QStringList states = getStates(window);
+		const QStringList &states = windowCache.GetStates(window);
 		if (states.isEmpty()) {
 			if (expectedStates.empty()) {
 				return true;
@@ -427,33 +733,13 @@ long getForegroundProcessPid()
 		return FocusNotifier::getActiveWindowPID();
 	}
 
-	Window *window;
-	if (getActiveWindow(window) != Success || !window || !*window) {
+	std::lock_guard<std::mutex> lock(windowCacheMutex);
+	windowCache.Sync();
+	auto window = windowCache.GetActiveWindow();
+	if (!window) {
 		return -1;
 	}
-	Atom atom, actual_type;
-	int actual_format;
-	unsigned long nitems;
-	unsigned long bytes_after;
-	unsigned char *prop;
-	long long pid;
-	atom = XInternAtom(disp(), "_NET_WM_PID", True);
-	auto status = XGetWindowProperty(disp(), *window, atom, 0, 1024, False,
-					 XA_CARDINAL, &actual_type,
-					 &actual_format, &nitems, &bytes_after,
-					 &prop);
-	XFree(window);
-	if (status != 0) {
-		return -2;
-	}
-	if (!prop) {
-		return -3;
-	}
-
-	pid = *((long *)prop);
-	XFree(prop);
-
-	return pid;
+	return windowCache.GetPid(window);
 }
 
 std::string getProcNameFromPid(long pid)
@@ -593,6 +879,13 @@ void PlatformInit()
 	initProcps();
 	initProc2();
 	XSetErrorHandler(ignoreXerror);
+
+	windowCacheTimer = new QTimer();
+	QObject::connect(windowCacheTimer, &QTimer::timeout, []() {
+		std::lock_guard<std::mutex> lock(windowCacheMutex);
+		windowCache.Maintain();
+	});
+	windowCacheTimer->start(1000);
 }
 
 static void cleanupHelper(QLibrary *lib)
@@ -608,6 +901,12 @@ void PlatformCleanup()
 	cleanupHelper(libXssHandle);
 	cleanupHelper(libprocps);
 	cleanupHelper(libproc2);
+	delete windowCacheTimer;
+	windowCacheTimer = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(windowCacheMutex);
+		windowCache.Reset();
+	}
 	cleanupDisplay();
 	XSetErrorHandler(NULL);
 	if (KWin && !KWinScriptObjectPath.isEmpty())
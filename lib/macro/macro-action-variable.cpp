@@ -107,9 +107,26 @@ void MacroActionVariable::HandleFindAndReplace(Variable *var)
 	var->SetValue(result.toStdString());
 }
 
+// Variables are bound to the expression where possible instead of being
+// substituted into its text, so the compiled expression can be reused when
+// their values change
+static std::variant<double, std::string>
+evalMathExpression(const StringVariable &expression)
+{
+	std::vector<MathExpressionPart> parts;
+	expression.VisitSegments(
+		[&parts](const std::string &text) {
+			parts.push_back({text, false});
+		},
+		[&parts](const Variable &variable) {
+			parts.push_back({variable.Value(false), true});
+		});
+	return EvalMathExpression(parts);
+}
+
 void MacroActionVariable::HandleMathExpression(Variable *var)
 {
-	auto result = EvalMathExpression(_mathExpression);
+	auto result = evalMathExpression(_mathExpression);
 	if (std::holds_alternative<std::string>(result)) {
 		blog(LOG_WARNING, "%s", std::get<std::string>(result).c_str());
 		return;
@@ -1335,7 +1352,7 @@ void MacroActionVariableEdit::MathExpressionChanged()
 	_entryData->_mathExpression = _mathExpression->text().toStdString();
 
 	// In case of invalid expression display an error
-	auto result = EvalMathExpression(_entryData->_mathExpression);
+	auto result = evalMathExpression(_entryData->_mathExpression);
 	auto hasError = std::holds_alternative<std::string>(result);
 	if (hasError) {
 		_mathExpressionResult->setText(
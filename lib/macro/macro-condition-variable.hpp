@@ -45,6 +45,10 @@ public:
 	RegexConfig _regex;
 
 private:
+	WakeupSource GetConditionWakeupSources() const
+	{
+		return WakeupSource::VARIABLE_CHANGE;
+	}
 	bool Compare(const Variable &) const;
 	bool ValueChanged(const Variable &);
 	bool CompareVariables();
@@ -71,6 +71,21 @@ void MacroCondition::SetDuration(const Duration &duration)
 	_durationModifier.SetDuration(duration);
 }
 
+WakeupSource MacroCondition::GetWakeupSources() const
+{
+	// Duration modifiers require regular checks as their state depends on
+	// the time passed since the condition state last changed
+	if (_durationModifier.GetType() != DurationModifier::Type::NONE) {
+		return WakeupSource::POLL | GetConditionWakeupSources();
+	}
+	return GetConditionWakeupSources();
+}
+
+WakeupSource MacroCondition::GetConditionWakeupSources() const
+{
+	return WakeupSource::POLL;
+}
+
 std::string_view MacroCondition::GetDefaultID()
 {
 	return "scene";
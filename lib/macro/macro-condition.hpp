@@ -3,6 +3,7 @@
 #include "condition-logic.hpp"
 #include "duration-modifier.hpp"
 #include "macro-ref.hpp"
+#include "wakeup-helpers.hpp"
 
 namespace advss {
 
@@ -26,8 +27,16 @@ public:
 	void ResetDuration();
 	bool CheckDurationModifier(bool conditionValue);
 
+	// Sources which can cause this condition's state to change
+	WakeupSource GetWakeupSources() const;
+
 	static std::string_view GetDefaultID();
 
+protected:
+	// Conditions can override this function if their state only changes
+	// as a result of the returned wakeup sources
+	virtual WakeupSource GetConditionWakeupSources() const;
+
 private:
 	Logic _logic = Logic(Logic::Type::ROOT_NONE);
 	DurationModifier _durationModifier;
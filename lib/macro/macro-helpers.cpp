@@ -95,6 +95,19 @@ bool MacroIsStopped(const Macro *macro)
 	return macro ? macro->GetStop() : true;
 }
 
+std::function<bool()> GetMacroStopCheck(const Macro *macro)
+{
+	if (!macro) {
+		return []() {
+			return true;
+		};
+	}
+	auto stopCount = macro->GetStopCount();
+	return [stopCount, count = stopCount->load()]() {
+		return stopCount->load() != count;
+	};
+}
+
 bool MacroIsPaused(const Macro *macro)
 {
 	return macro ? macro->Paused() : true;
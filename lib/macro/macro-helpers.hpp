@@ -5,6 +5,8 @@
 #include <chrono>
 #include <condition_variable>
 #include <deque>
+#include <functional>
+#include <memory>
 #include <optional>
 #include <string_view>
 #include <thread>
@@ -47,6 +49,10 @@ EXPORT std::chrono::high_resolution_clock::time_point
 LastMacroConditionCheckTime(const Macro *);
 
 EXPORT bool MacroIsStopped(const Macro *);
+// Returns a function reporting whether the macro was stopped or destroyed
+// since this function was called.
+// It does not access the macro itself, so it is safe to call from any thread.
+EXPORT std::function<bool()> GetMacroStopCheck(const Macro *);
 EXPORT bool MacroIsPaused(const Macro *);
 EXPORT bool
 MacroWasPausedSince(const Macro *,
@@ -56,6 +62,9 @@ EXPORT bool MacroWasCheckedSinceLastStart(const Macro *);
 EXPORT void AddMacroHelperThread(Macro *, std::thread &&);
 
 EXPORT bool CheckMacros();
+// Returns the time the most recent CheckMacros() call started at, which is
+// shared by all conditions checked during that call
+EXPORT std::chrono::high_resolution_clock::time_point GetMacroCheckStartTime();
 
 EXPORT bool RunMacroActions(Macro *);
 EXPORT bool RunMacros();
@@ -0,0 +1,169 @@
+#include "macro-performance-tab.hpp"
+#include "macro-action-factory.hpp"
+#include "macro-condition-factory.hpp"
+#include "macro-performance.hpp"
+#include "obs-module-helper.hpp"
+#include "plugin-state-helpers.hpp"
+#include "tab-helpers.hpp"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+namespace advss {
+
+static bool registerTab();
+static bool registerTabDone = registerTab();
+
+static bool registerTab()
+{
+	AddPluginInitStep([]() {
+		AddSetupTabCallback("performanceTab", PerformanceTab::Create,
+				    [](QTabWidget *) {});
+	});
+	return true;
+}
+
+PerformanceTab *PerformanceTab::Create()
+{
+	return new PerformanceTab();
+}
+
+static QString getTypeText(LatencyStatistics::Type type)
+{
+	switch (type) {
+	case LatencyStatistics::Type::MACRO_CONDITIONS:
+		return obs_module_text(
+			"AdvSceneSwitcher.performanceTab.type.macroConditions");
+	case LatencyStatistics::Type::MACRO_ACTIONS:
+		return obs_module_text(
+			"AdvSceneSwitcher.performanceTab.type.macroActions");
+	case LatencyStatistics::Type::CONDITION_TYPE:
+		return obs_module_text(
+			"AdvSceneSwitcher.performanceTab.type.condition");
+	case LatencyStatistics::Type::ACTION_TYPE:
+		return obs_module_text(
+			"AdvSceneSwitcher.performanceTab.type.action");
+	default:
+		break;
+	}
+	return "";
+}
+
+static QString getNameText(const LatencyStatistics &entry)
+{
+	switch (entry.type) {
+	case LatencyStatistics::Type::CONDITION_TYPE:
+		return obs_module_text(
+			MacroConditionFactory::GetConditionName(entry.name)
+				.c_str());
+	case LatencyStatistics::Type::ACTION_TYPE:
+		return obs_module_text(
+			MacroActionFactory::GetActionName(entry.name).c_str());
+	default:
+		break;
+	}
+	return QString::fromStdString(entry.name);
+}
+
+static QTableWidgetItem *createDurationItem(std::chrono::microseconds value)
+{
+	// Store the value as a number so sorting the column works as expected
+	auto item = new QTableWidgetItem();
+	item->setData(Qt::DisplayRole, (double)value.count() / 1000.0);
+	return item;
+}
+
+PerformanceTab::PerformanceTab(QWidget *parent)
+	: QWidget(parent),
+	  _table(new QTableWidget()),
+	  _help(new QLabel(
+		  obs_module_text("AdvSceneSwitcher.performanceTab.help"))),
+	  _reset(new QPushButton(
+		  obs_module_text("AdvSceneSwitcher.performanceTab.reset")))
+{
+	const QStringList headers =
+		QStringList()
+		<< obs_module_text("AdvSceneSwitcher.performanceTab.type")
+		<< obs_module_text("AdvSceneSwitcher.performanceTab.name")
+		<< obs_module_text("AdvSceneSwitcher.performanceTab.count")
+		<< obs_module_text("AdvSceneSwitcher.performanceTab.p50")
+		<< obs_module_text("AdvSceneSwitcher.performanceTab.p95")
+		<< obs_module_text("AdvSceneSwitcher.performanceTab.p99")
+		<< obs_module_text("AdvSceneSwitcher.performanceTab.max");
+	_table->setColumnCount(headers.size());
+	_table->setHorizontalHeaderLabels(headers);
+	_table->horizontalHeader()->setSectionResizeMode(
+		QHeaderView::ResizeMode::Interactive);
+	_table->horizontalHeader()->setStretchLastSection(true);
+	_table->verticalHeader()->hide();
+	_table->setCornerButtonEnabled(false);
+	_table->setShowGrid(false);
+	_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+	_table->setSortingEnabled(true);
+	_table->sortByColumn(5, Qt::DescendingOrder);
+
+	_help->setWordWrap(true);
+
+	auto controlLayout = new QHBoxLayout();
+	controlLayout->setContentsMargins(0, 0, 0, 0);
+	controlLayout->addWidget(_reset);
+	controlLayout->addStretch();
+
+	auto layout = new QVBoxLayout();
+	layout->addWidget(_help);
+	layout->addWidget(_table);
+	layout->addLayout(controlLayout);
+	setLayout(layout);
+
+	QWidget::connect(_reset, &QPushButton::clicked, this,
+			 &PerformanceTab::Reset);
+
+	// Only update the statistics while the tab is visible
+	_timer.setInterval(1000);
+	QWidget::connect(&_timer, &QTimer::timeout, this, [this]() {
+		if (isVisible()) {
+			Refresh();
+		}
+	});
+	_timer.start();
+}
+
+void PerformanceTab::Refresh()
+{
+	const auto statistics = GetLatencyStatistics();
+
+	_table->setSortingEnabled(false);
+	_table->setRowCount((int)statistics.size());
+	for (int row = 0; row < (int)statistics.size(); row++) {
+		const auto &entry = statistics[row];
+		_table->setItem(row, 0,
+				new QTableWidgetItem(getTypeText(entry.type)));
+		_table->setItem(row, 1,
+				new QTableWidgetItem(getNameText(entry)));
+		auto countItem = new QTableWidgetItem();
+		countItem->setData(Qt::DisplayRole,
+				   (qulonglong)entry.summary.count);
+		_table->setItem(row, 2, countItem);
+		_table->setItem(row, 3, createDurationItem(entry.summary.p50));
+		_table->setItem(row, 4, createDurationItem(entry.summary.p95));
+		_table->setItem(row, 5, createDurationItem(entry.summary.p99));
+		_table->setItem(row, 6, createDurationItem(entry.summary.max));
+	}
+	_table->setSortingEnabled(true);
+}
+
+void PerformanceTab::showEvent(QShowEvent *event)
+{
+	QWidget::showEvent(event);
+	Refresh();
+}
+
+void PerformanceTab::Reset()
+{
+	ResetLatencyStatistics();
+	Refresh();
+}
+
+} // namespace advss
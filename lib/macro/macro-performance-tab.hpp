@@ -0,0 +1,31 @@
+#pragma once
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+
+namespace advss {
+
+class PerformanceTab final : public QWidget {
+	Q_OBJECT
+
+public:
+	static PerformanceTab *Create();
+
+private slots:
+	void Refresh();
+	void Reset();
+
+protected:
+	void showEvent(QShowEvent *event) override;
+
+private:
+	PerformanceTab(QWidget *parent = nullptr);
+
+	QTableWidget *_table;
+	QLabel *_help;
+	QPushButton *_reset;
+	QTimer _timer;
+};
+
+} // namespace advss
@@ -0,0 +1,180 @@
+#include "macro-performance.hpp"
+#include "macro.hpp"
+#include "sync-helpers.hpp"
+#include "websocket-api.hpp"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+
+namespace advss {
+
+namespace {
+
+class HistogramRegistry {
+public:
+	LatencyHistogram &Get(const std::string &id);
+	void ForEach(const std::function<void(const std::string &,
+					      LatencyHistogram &)> &) const;
+
+private:
+	std::map<std::string, std::unique_ptr<LatencyHistogram>> _histograms;
+	mutable std::shared_mutex _mutex;
+};
+
+} // namespace
+
+static HistogramRegistry conditionHistograms;
+static HistogramRegistry actionHistograms;
+
+static void getLatencyStatisticsRequest(obs_data_t *, obs_data_t *);
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
+{
+	RegisterWebsocketRequest("GetLatencyStatistics",
+				 getLatencyStatisticsRequest);
+	RegisterWebsocketRequest(
+		"ResetLatencyStatistics",
+		[](obs_data_t *, obs_data_t *) { ResetLatencyStatistics(); });
+	return true;
+}
+
+LatencyHistogram &HistogramRegistry::Get(const std::string &id)
+{
+	{
+		std::shared_lock<std::shared_mutex> lock(_mutex);
+		auto it = _histograms.find(id);
+		if (it != _histograms.end()) {
+			return *it->second;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> lock(_mutex);
+	auto &histogram = _histograms[id];
+	if (!histogram) {
+		histogram = std::make_unique<LatencyHistogram>();
+	}
+	return *histogram;
+}
+
+void HistogramRegistry::ForEach(
+	const std::function<void(const std::string &, LatencyHistogram &)>
+		&func) const
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+	for (const auto &[id, histogram] : _histograms) {
+		func(id, *histogram);
+	}
+}
+
+LatencyHistogram &GetConditionLatencyHistogram(const std::string &id)
+{
+	return conditionHistograms.Get(id);
+}
+
+LatencyHistogram &GetActionLatencyHistogram(const std::string &id)
+{
+	return actionHistograms.Get(id);
+}
+
+static void addStatistics(std::vector<LatencyStatistics> &result,
+			  LatencyStatistics::Type type,
+			  const std::string &name,
+			  const LatencyHistogram &histogram)
+{
+	if (histogram.Count() == 0) {
+		return;
+	}
+	result.push_back({type, name, histogram.GetSummary()});
+}
+
+std::vector<LatencyStatistics> GetLatencyStatistics()
+{
+	std::vector<LatencyStatistics> result;
+	{
+		auto lock = LockContext();
+		for (const auto &macro : GetMacros()) {
+			if (macro->IsGroup()) {
+				continue;
+			}
+			addStatistics(result,
+				      LatencyStatistics::Type::MACRO_CONDITIONS,
+				      macro->Name(),
+				      macro->GetConditionCheckLatency());
+			addStatistics(result,
+				      LatencyStatistics::Type::MACRO_ACTIONS,
+				      macro->Name(),
+				      macro->GetActionRunLatency());
+		}
+	}
+
+	conditionHistograms.ForEach(
+		[&result](const std::string &id, LatencyHistogram &histogram) {
+			addStatistics(result,
+				      LatencyStatistics::Type::CONDITION_TYPE,
+				      id, histogram);
+		});
+	actionHistograms.ForEach(
+		[&result](const std::string &id, LatencyHistogram &histogram) {
+			addStatistics(result,
+				      LatencyStatistics::Type::ACTION_TYPE, id,
+				      histogram);
+		});
+	return result;
+}
+
+void ResetLatencyStatistics()
+{
+	{
+		auto lock = LockContext();
+		for (const auto &macro : GetMacros()) {
+			macro->ResetLatencyStatistics();
+		}
+	}
+
+	const auto reset = [](const std::string &,
+			      LatencyHistogram &histogram) {
+		histogram.Reset();
+	};
+	conditionHistograms.ForEach(reset);
+	actionHistograms.ForEach(reset);
+}
+
+static const char *getTypeName(LatencyStatistics::Type type)
+{
+	switch (type) {
+	case LatencyStatistics::Type::MACRO_CONDITIONS:
+		return "macroConditions";
+	case LatencyStatistics::Type::MACRO_ACTIONS:
+		return "macroActions";
+	case LatencyStatistics::Type::CONDITION_TYPE:
+		return "condition";
+	case LatencyStatistics::Type::ACTION_TYPE:
+		return "action";
+	default:
+		break;
+	}
+	return "";
+}
+
+static void getLatencyStatisticsRequest(obs_data_t *, obs_data_t *response)
+{
+	OBSDataArrayAutoRelease array = obs_data_array_create();
+	for (const auto &entry : GetLatencyStatistics()) {
+		OBSDataAutoRelease data = obs_data_create();
+		obs_data_set_string(data, "type", getTypeName(entry.type));
+		obs_data_set_string(data, "name", entry.name.c_str());
+		obs_data_set_int(data, "count", entry.summary.count);
+		obs_data_set_int(data, "p50", entry.summary.p50.count());
+		obs_data_set_int(data, "p95", entry.summary.p95.count());
+		obs_data_set_int(data, "p99", entry.summary.p99.count());
+		obs_data_set_int(data, "max", entry.summary.max.count());
+		obs_data_array_push_back(array, data);
+	}
+	obs_data_set_array(response, "statistics", array);
+}
+
+} // namespace advss
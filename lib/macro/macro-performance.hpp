@@ -0,0 +1,32 @@
+#pragma once
+#include "latency-histogram.hpp"
+
+#include <string>
+#include <vector>
+
+namespace advss {
+
+// Histograms are created on first use and are never removed, so the
+// returned references stay valid
+LatencyHistogram &GetConditionLatencyHistogram(const std::string &id);
+LatencyHistogram &GetActionLatencyHistogram(const std::string &id);
+
+struct LatencyStatistics {
+	enum class Type {
+		MACRO_CONDITIONS,
+		MACRO_ACTIONS,
+		CONDITION_TYPE,
+		ACTION_TYPE,
+	};
+
+	Type type;
+	// Macro name or segment type id
+	std::string name;
+	LatencyHistogram::Summary summary;
+};
+
+// Only includes entries which were recorded at least once
+std::vector<LatencyStatistics> GetLatencyStatistics();
+void ResetLatencyStatistics();
+
+} // namespace advss
@@ -14,6 +14,12 @@
 namespace advss {
 
 bool MacroSegmentList::_useCache = true;
+size_t MacroSegmentList::_maxCachedMacros = 20;
+size_t MacroSegmentList::_maxCacheSize = 50 * 1024 * 1024;
+
+// Rough estimate of the memory used by a widget including its private data,
+// layout and style information
+static constexpr size_t estimatedWidgetSize = 2048;
 
 MacroSegmentList::MacroSegmentList(QWidget *parent)
 	: QScrollArea(parent),
@@ -141,6 +147,13 @@ void MacroSegmentList::SetCachingEnabled(bool enable)
 	_useCache = enable;
 }
 
+void MacroSegmentList::SetCacheLimits(size_t maxMacros,
+				      size_t maxEstimatedBytes)
+{
+	_maxCachedMacros = maxMacros;
+	_maxCacheSize = maxEstimatedBytes;
+}
+
 void MacroSegmentList::CacheCurrentWidgetsFor(const Macro *macro)
 {
 	if (!_useCache) {
@@ -151,15 +164,46 @@ void MacroSegmentList::CacheCurrentWidgetsFor(const Macro *macro)
 	int idx = 0;
 	QLayoutItem *item;
 	while ((item = _contentLayout->takeAt(idx))) {
-		if (!item || !item->widget()) {
+		auto widget = item->widget();
+		delete item;
+		if (!widget) {
 			continue;
 		}
-		auto widget = item->widget();
-		widget->hide();
 		result.emplace_back(widget);
 	}
 
-	_widgetCache[macro] = result;
+	AddToCache(macro, result);
+}
+
+static size_t estimateSize(const std::vector<QWidget *> &widgets)
+{
+	size_t count = 0;
+	for (auto widget : widgets) {
+		count += 1 + widget->findChildren<QWidget *>().size();
+	}
+	return count * estimatedWidgetSize;
+}
+
+void MacroSegmentList::AddToCache(const Macro *macro,
+				  const std::vector<QWidget *> &widgets)
+{
+	for (auto widget : widgets) {
+		widget->installEventFilter(this);
+		widget->hide();
+	}
+
+	ClearWidgetsFromCacheFor(macro);
+	_cacheLru.push_front(macro);
+	CacheEntry entry{widgets, estimateSize(widgets), _cacheLru.begin()};
+	_cacheSize += entry.estimatedSize;
+	_widgetCache.emplace(macro, std::move(entry));
+
+	EvictFromCache();
+}
+
+bool MacroSegmentList::IsCached(const Macro *macro) const
+{
+	return _widgetCache.find(macro) != _widgetCache.end();
 }
 
 bool MacroSegmentList::PopulateWidgetsFromCache(const Macro *macro)
@@ -173,11 +217,21 @@ bool MacroSegmentList::PopulateWidgetsFromCache(const Macro *macro)
 		return false;
 	}
 
-	for (auto widget : it->second) {
+	for (auto widget : it->second.widgets) {
 		_contentLayout->addWidget(widget);
 		widget->show();
 	}
 
+	// The widgets are owned by the layout again until the macro is cached
+	// the next time
+	_cacheSize -= it->second.estimatedSize;
+	_cacheLru.erase(it->second.lruPos);
+	_widgetCache.erase(it);
+
+	// Prefetched widgets might not be fully set up yet
+	QTimer::singleShot(0, this, [this]() {
+		SetupVisibleMacroSegmentWidgets();
+	});
 	return true;
 }
 
@@ -187,10 +241,20 @@ void MacroSegmentList::ClearWidgetsFromCacheFor(const Macro *macro)
 	if (it == _widgetCache.end()) {
 		return;
 	}
-	clearWidgetVector(it->second);
+	clearWidgetVector(it->second.widgets);
+	_cacheSize -= it->second.estimatedSize;
+	_cacheLru.erase(it->second.lruPos);
 	_widgetCache.erase(it);
 }
 
+void MacroSegmentList::EvictFromCache()
+{
+	while (!_cacheLru.empty() && (_widgetCache.size() > _maxCachedMacros ||
+				      _cacheSize > _maxCacheSize)) {
+		ClearWidgetsFromCacheFor(_cacheLru.back());
+	}
+}
+
 void MacroSegmentList::Highlight(int idx, QColor color)
 {
 	auto item = _contentLayout->itemAt(idx);
@@ -338,9 +402,12 @@ void MacroSegmentList::HideLastDropLine()
 
 void MacroSegmentList::ClearWidgetCache()
 {
-	for (const auto &[_, widgets] : _widgetCache) {
-		clearWidgetVector(widgets);
+	for (const auto &[_, entry] : _widgetCache) {
+		clearWidgetVector(entry.widgets);
 	}
+	_widgetCache.clear();
+	_cacheLru.clear();
+	_cacheSize = 0;
 }
 
 static bool isInUpperHalfOf(const QPoint &pos, const QRect &rect)
@@ -418,15 +485,24 @@ void MacroSegmentList::SetupVisibleMacroSegmentWidgets()
 	}
 
 	const auto viewportRect = viewport()->rect();
+	// Widgets of segments close to the visible area are kept around to
+	// avoid recreating them repeatedly while scrolling
+	const int margin = viewportRect.height() * 2;
+	const auto keepRect = viewportRect.adjusted(0, -margin, 0, margin);
+
+	for (int idx = 0; idx < _contentLayout->count(); idx++) {
+		auto segment = WidgetAt(idx);
+		if (!segment) {
+			continue;
+		}
 
-	for (auto segment : widget()->findChildren<MacroSegmentEdit *>()) {
 		const auto pos = segment->mapTo(viewport(), QPoint(0, 0));
 		const QRect rect(pos, segment->size());
-		if (!viewportRect.intersects(rect)) {
-			continue;
+		if (viewportRect.intersects(rect)) {
+			segment->SetupWidgets();
+		} else if (!keepRect.intersects(rect)) {
+			segment->ReleaseWidgets();
 		}
-
-		segment->SetupWidgets();
 	}
 }
 
@@ -5,7 +5,9 @@
 #include <QScrollArea>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <list>
 #include <thread>
+#include <unordered_map>
 
 namespace advss {
 
@@ -27,7 +29,13 @@ public:
 	void Remove(int idx) const;
 	void Clear(int idx = 0) const; // Clear all elements >= idx
 	static void SetCachingEnabled(bool enable);
+	// Limits apply to each list separately.
+	// The least recently viewed macros are evicted first.
+	static void SetCacheLimits(size_t maxMacros, size_t maxEstimatedBytes);
 	void CacheCurrentWidgetsFor(const Macro *);
+	// Takes ownership of widgets which were not yet added to the list
+	void AddToCache(const Macro *, const std::vector<QWidget *> &);
+	bool IsCached(const Macro *) const;
 	bool PopulateWidgetsFromCache(const Macro *);
 	void ClearWidgetsFromCacheFor(const Macro *);
 	void Highlight(int idx, QColor color = QColor(Qt::green));
@@ -62,6 +70,7 @@ private:
 	QRect GetContentItemRectWithPadding(int idx) const;
 	void HideLastDropLine();
 	void ClearWidgetCache();
+	void EvictFromCache();
 
 	int _dragPosition = -1;
 	int _dropLineIdx = -1;
@@ -75,8 +84,19 @@ private:
 
 	bool _checkVisibility = true;
 
+	struct CacheEntry {
+		std::vector<QWidget *> widgets;
+		size_t estimatedSize = 0;
+		std::list<const Macro *>::iterator lruPos;
+	};
+
 	static bool _useCache;
-	std::unordered_map<const Macro *, std::vector<QWidget *>> _widgetCache;
+	static size_t _maxCachedMacros;
+	static size_t _maxCacheSize;
+	// Most recently viewed macros first
+	std::list<const Macro *> _cacheLru;
+	std::unordered_map<const Macro *, CacheEntry> _widgetCache;
+	size_t _cacheSize = 0;
 };
 
 } // namespace advss
@@ -10,6 +10,7 @@
 #include <QLabel>
 #include <QMouseEvent>
 #include <QScrollBar>
+#include <algorithm>
 
 namespace advss {
 
@@ -77,6 +78,10 @@ bool MacroSegment::GetHighlightAndReset()
 void MacroSegment::SetEnabled(bool value)
 {
 	_enabled = value;
+	// Segments can be enabled and disabled by actions of other macros
+	if (_macro) {
+		_macro->SegmentSettingsModified();
+	}
 }
 
 bool MacroSegment::Enabled() const
@@ -164,6 +169,17 @@ void MacroSegment::SetTempVarValue(const std::string &id,
 	}
 }
 
+void MacroSegment::RevalidateTempVarValue(const std::string &id)
+{
+	for (auto &var : _tempVariables) {
+		if (var.ID() != id) {
+			continue;
+		}
+		var.RevalidateValue();
+		break;
+	}
+}
+
 void MacroSegment::InvalidateTempVarValues()
 {
 	for (auto &var : _tempVariables) {
@@ -355,6 +371,35 @@ void MacroSegmentEdit::SetFocusPolicyOfWidgets()
 	}
 }
 
+bool MacroSegmentEdit::HasOpenWindow() const
+{
+	const auto widgets = findChildren<QWidget *>();
+	return std::any_of(widgets.begin(), widgets.end(), [](QWidget *w) {
+		return w->isWindow() && w->isVisible();
+	});
+}
+
+void MacroSegmentEdit::ReleaseWidgets()
+{
+	// Dialogs opened by the edit, like the preview of the video condition,
+	// would be destroyed along with the widgets while still in use
+	if (!_allWidgetsAreSetup || HasOpenWindow()) {
+		return;
+	}
+
+	// Keep the size of the content, so the positions of the other segments
+	// in the list do not change
+	auto placeholder = new QWidget();
+	auto layout = new QVBoxLayout();
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->addItem(new QSpacerItem(0, _section->ContentHeight(),
+					QSizePolicy::Minimum,
+					QSizePolicy::Fixed));
+	placeholder->setLayout(layout);
+	_section->SetContent(placeholder);
+	_allWidgetsAreSetup = false;
+}
+
 void MacroSegmentEdit::SetCollapsed(bool collapsed)
 {
 	_section->SetCollapsed(collapsed);
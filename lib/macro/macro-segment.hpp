@@ -35,6 +35,9 @@ public:
 	virtual bool Save(obs_data_t *obj) const = 0;
 	virtual bool Load(obs_data_t *obj) = 0;
 	virtual bool PostLoad();
+	// Has to return true if the saved settings can change without the
+	// segment being edited, so they will not be cached when saving
+	virtual bool SettingsChangeAtRuntime() const { return false; }
 	virtual std::string GetShortDesc() const;
 	virtual std::string GetId() const = 0;
 	void EnableHighlight();
@@ -55,6 +58,9 @@ protected:
 			const std::string &description = "");
 
 	void SetTempVarValue(const std::string &id, const std::string &value);
+	// Keeps the value set during a previous check instead of setting it
+	// again, if it is known to be unchanged
+	void RevalidateTempVarValue(const std::string &id);
 
 	template<typename T, typename = std::enable_if_t<
 				     std::is_same<std::decay_t<T>, bool>::value>>
@@ -107,6 +113,10 @@ public:
 	void SetSelected(bool);
 	virtual std::shared_ptr<MacroSegment> Data() const = 0;
 	virtual void SetupWidgets(bool basicSetup = false) = 0;
+	// Replaces the segment specific widgets with a placeholder of the same
+	// size until SetupWidgets() is called again.
+	// Does nothing while a window opened by the edit is still shown.
+	void ReleaseWidgets();
 
 public slots:
 	void HeaderInfoChanged(const QString &);
@@ -141,6 +151,7 @@ private:
 	};
 
 	void ShowDropLine(DropLineState);
+	bool HasOpenWindow() const;
 
 	// The reason for using two separate frame widgets, each with their own
 	// stylesheet, and changing their visibility vs. using a single frame
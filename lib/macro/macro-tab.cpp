@@ -643,6 +643,88 @@ void AdvSceneSwitcher::PopulateMacroConditions(Macro &m, uint32_t afterIdx)
 	});
 }
 
+void AdvSceneSwitcher::PrefetchMacroSegmentWidgets(Macro &m)
+{
+	// Only the basic setup of the segment widgets is performed until they
+	// become visible, so building them ahead of time is cheap
+	if (!ui->conditionsList->IsCached(&m)) {
+		std::vector<QWidget *> widgets;
+		bool root = true;
+		for (auto &condition : m.Conditions()) {
+			widgets.emplace_back(new MacroConditionEdit(
+				this, &condition, condition->GetId(), root));
+			root = false;
+		}
+		ui->conditionsList->AddToCache(&m, widgets);
+	}
+
+	const auto prefetchActions =
+		[this, &m](MacroSegmentList *list,
+			   std::deque<std::shared_ptr<MacroAction>> &actions) {
+			if (list->IsCached(&m)) {
+				return;
+			}
+			std::vector<QWidget *> widgets;
+			for (auto &action : actions) {
+				widgets.emplace_back(new MacroActionEdit(
+					this, &action, action->GetId()));
+			}
+			list->AddToCache(&m, widgets);
+		};
+	prefetchActions(ui->actionsList, m.Actions());
+	prefetchActions(ui->elseActionsList, m.ElseActions());
+}
+
+static std::vector<std::shared_ptr<Macro>>
+getNeighbourMacros(const std::shared_ptr<Macro> &macro)
+{
+	std::vector<std::shared_ptr<Macro>> result;
+	const auto &macros = GetMacros();
+	auto it = std::find(macros.begin(), macros.end(), macro);
+	if (it == macros.end()) {
+		return result;
+	}
+
+	// Groups do not have any segments to prefetch
+	for (auto prev = it; prev != macros.begin();) {
+		--prev;
+		if (!(*prev)->IsGroup()) {
+			result.emplace_back(*prev);
+			break;
+		}
+	}
+	for (auto next = std::next(it); next != macros.end(); ++next) {
+		if (!(*next)->IsGroup()) {
+			result.emplace_back(*next);
+			break;
+		}
+	}
+	return result;
+}
+
+void AdvSceneSwitcher::PrefetchNeighbourMacroWidgets(
+	const std::shared_ptr<Macro> &macro)
+{
+	if (switcher->disableMacroWidgetCache) {
+		return;
+	}
+
+	// Wait until the user stopped browsing through the macro list to not
+	// slow down switching between macros
+	static constexpr int prefetchDelay = 500;
+	std::weak_ptr<Macro> weakMacro = macro;
+	QTimer::singleShot(prefetchDelay, this, [this, weakMacro]() {
+		auto macro = weakMacro.lock();
+		if (!macro || macro != GetSelectedMacro() ||
+		    switcher->disableMacroWidgetCache) {
+			return;
+		}
+		for (const auto &neighbour : getNeighbourMacros(macro)) {
+			PrefetchMacroSegmentWidgets(*neighbour);
+		}
+	});
+}
+
 void AdvSceneSwitcher::SetActionData(Macro &m) const
 {
 	auto &actions = m.Actions();
@@ -825,13 +907,33 @@ void AdvSceneSwitcher::MacroSelectionAboutToChange() const
 	ui->elseActionsList->CacheCurrentWidgetsFor(macro);
 }
 
+// Only the macro shown in the edit area can be modified by the user
+static std::weak_ptr<Macro> editedMacro;
+
+static void setEditedMacro(const std::shared_ptr<Macro> &macro)
+{
+	auto previous = editedMacro.lock();
+	if (previous == macro) {
+		return;
+	}
+	if (previous) {
+		previous->SetBeingEdited(false);
+	}
+	if (macro) {
+		macro->SetBeingEdited(true);
+	}
+	editedMacro = macro;
+}
+
 void AdvSceneSwitcher::MacroSelectionChanged()
 {
+	auto macro = GetSelectedMacro();
+	setEditedMacro(macro);
+
 	if (loading) {
 		return;
 	}
 
-	auto macro = GetSelectedMacro();
 	if (!macro) {
 		SetMacroEditAreaDisabled(true);
 		ui->conditionsList->Clear();
@@ -845,6 +947,7 @@ void AdvSceneSwitcher::MacroSelectionChanged()
 		return;
 	}
 	SetEditMacro(*macro);
+	PrefetchNeighbourMacroWidgets(macro);
 
 	if (GetGlobalMacroSettings()._saveSettingsOnMacroChange) {
 		obs_frontend_save();
@@ -1008,6 +1111,7 @@ void AdvSceneSwitcher::SetupMacroTab()
 		SLOT(MacroSelectionAboutToChange()));
 	connect(ui->macros, SIGNAL(MacroSelectionChanged()), this,
 		SLOT(MacroSelectionChanged()));
+	connect(this, &QObject::destroyed, []() { setEditedMacro({}); });
 	ui->runMacro->SetMacroTree(ui->macros);
 
 	ui->conditionsList->SetHelpMsg(
@@ -5,10 +5,12 @@
 #include "ui-helpers.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <obs.h>
 #include <string>
 #include <QLabel>
 #include <QLineEdit>
+#include <QScrollBar>
 #include <QSpacerItem>
 #include <QPushButton>
 #include <QVBoxLayout>
@@ -777,6 +779,16 @@ void MacroTree::Reset(std::deque<std::shared_ptr<Macro>> &macros,
 		this,
 		SLOT(SelectionChangedHelper(const QItemSelection &,
 					    const QItemSelection &)));
+
+	const auto updateVisibleWidgets = [this]() {
+		ScheduleVisibleWidgetsUpdate();
+	};
+	connect(mtm, &QAbstractItemModel::rowsInserted, this,
+		updateVisibleWidgets);
+	connect(mtm, &QAbstractItemModel::rowsRemoved, this,
+		updateVisibleWidgets);
+	connect(mtm, &QAbstractItemModel::rowsMoved, this,
+		updateVisibleWidgets);
 }
 
 void MacroTree::Add(std::shared_ptr<Macro> item,
@@ -813,52 +825,105 @@ MacroTree::MacroTree(QWidget *parent_) : QListView(parent_)
 		"*[bgColor=\"8\"]{background-color:rgba(255,255,255,33%);}"));
 
 	setItemDelegate(new MacroTreeDelegate(this));
+
+	connect(verticalScrollBar(), &QScrollBar::valueChanged, this,
+		&MacroTree::UpdateVisibleWidgets);
 }
 
 void MacroTree::ResetWidgets()
 {
 	MacroTreeModel *mtm = GetModel();
 	mtm->UpdateGroupState(false);
-	int modelIdx = 0;
-	for (int i = 0; i < (int)mtm->_macros.size(); i++) {
-		QModelIndex index = mtm->createIndex(modelIdx, 0, nullptr);
-		const auto &macro = mtm->_macros[i];
-		setIndexWidget(index,
-			       new MacroTreeItem(this, macro, _highlight));
-
-		// Skip items of collapsed groups
-		if (macro->IsGroup() && macro->IsCollapsed()) {
-			i += macro->GroupSize();
+	UpdateVisibleWidgets();
+	assert(GetModel()->IsInValidState());
+}
+
+// Only the rows in and around the visible area get an item widget.
+// Creating a widget for each macro makes opening the settings window very slow
+// for large numbers of macros.
+void MacroTree::UpdateVisibleWidgets()
+{
+	_visibleWidgetsUpdatePending = false;
+
+	MacroTreeModel *mtm = GetModel();
+	if (!mtm) {
+		return;
+	}
+
+	executeDelayedItemsLayout();
+	const int rowCount = mtm->rowCount(QModelIndex());
+	if (rowCount == 0) {
+		return;
+	}
+
+	const int viewportHeight = viewport()->height();
+	int firstVisible = indexAt(QPoint(1, 1)).row();
+	int lastVisible = indexAt(QPoint(1, viewportHeight - 1)).row();
+	if (firstVisible == -1) {
+		firstVisible = 0;
+	}
+	if (lastVisible == -1) {
+		lastVisible = rowCount - 1;
+	}
+
+	// Keep the widgets of one page above and below the visible area around
+	// to make scrolling smooth
+	const int pageSize = lastVisible - firstVisible + 1;
+	const int firstRow = std::max(0, firstVisible - pageSize);
+	const int lastRow = std::min(rowCount - 1, lastVisible + pageSize);
+
+	const int previousRowHeight = _rowHeight;
+	for (int row = 0; row < rowCount; row++) {
+		const auto index = mtm->createIndex(row, 0, nullptr);
+		const bool hasWidget = !!indexWidget(index);
+		if (row < firstRow || row > lastRow) {
+			if (hasWidget) {
+				setIndexWidget(index, nullptr);
+			}
+			continue;
 		}
-		modelIdx++;
+		if (hasWidget) {
+			continue;
+		}
+		const auto &macro =
+			mtm->_macros[ModelIndexToMacroIndex(row, mtm->_macros)];
+		UpdateWidget(index, macro);
 	}
-	assert(GetModel()->IsInValidState());
+
+	// The number of visible rows was based on the wrong row height
+	if (previousRowHeight != _rowHeight) {
+		ScheduleVisibleWidgetsUpdate();
+	}
+}
+
+void MacroTree::ScheduleVisibleWidgetsUpdate()
+{
+	if (_visibleWidgetsUpdatePending) {
+		return;
+	}
+	_visibleWidgetsUpdatePending = true;
+	QTimer::singleShot(0, this, &MacroTree::UpdateVisibleWidgets);
 }
 
 void MacroTree::UpdateWidget(const QModelIndex &idx,
 			     std::shared_ptr<Macro> item)
 {
-	setIndexWidget(idx, new MacroTreeItem(this, item, _highlight));
+	auto widget = new MacroTreeItem(this, item, _highlight);
+	_rowHeight = widget->sizeHint().height();
+	setIndexWidget(idx, widget);
 }
 
 void MacroTree::UpdateWidgets(bool force)
 {
 	MacroTreeModel *mtm = GetModel();
 
-	for (int i = 0; i < (int)mtm->_macros.size(); i++) {
-		std::shared_ptr<Macro> item = mtm->_macros[i];
-		MacroTreeItem *widget = GetItemWidget(i);
-
-		if (!widget) {
-			UpdateWidget(mtm->createIndex(i, 0, nullptr), item);
-		} else {
+	for (int row = 0; row < mtm->rowCount(QModelIndex()); row++) {
+		MacroTreeItem *widget = GetItemWidget(row);
+		if (widget) {
 			widget->Update(force);
 		}
-		// Skip items of collapsed groups
-		if (item->IsGroup() && item->IsCollapsed()) {
-			i += item->GroupSize();
-		}
 	}
+	UpdateVisibleWidgets();
 }
 
 static inline void MoveItem(std::deque<std::shared_ptr<Macro>> &items,
@@ -1273,6 +1338,12 @@ inline MacroTreeItem *MacroTree::GetItemWidget(int idx) const
 	return reinterpret_cast<MacroTreeItem *>(widget);
 }
 
+void MacroTree::resizeEvent(QResizeEvent *event)
+{
+	QListView::resizeEvent(event);
+	ScheduleVisibleWidgetsUpdate();
+}
+
 void MacroTree::paintEvent(QPaintEvent *event)
 {
 	MacroTreeModel *mtm = GetModel();
@@ -1301,7 +1372,13 @@ QSize MacroTreeDelegate::sizeHint(const QStyleOptionViewItem &option,
 	QWidget *item = tree->indexWidget(index);
 
 	if (!item) {
-		return QStyledItemDelegate::sizeHint(option, index);
+		// Rows without an item widget are not visible, but should still
+		// take up the same space to keep the scroll range stable
+		auto size = QStyledItemDelegate::sizeHint(option, index);
+		if (tree->_rowHeight > 0) {
+			size.setHeight(tree->_rowHeight);
+		}
+		return size;
 	}
 
 	return QSize(item->sizeHint());
@@ -149,12 +149,17 @@ signals:
 protected:
 	virtual void dropEvent(QDropEvent *event) override;
 	virtual void paintEvent(QPaintEvent *event) override;
+	virtual void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+	void UpdateVisibleWidgets();
 
 private:
 	MacroTreeItem *GetItemWidget(int idx) const;
 	void ResetWidgets();
 	void UpdateWidget(const QModelIndex &idx, std::shared_ptr<Macro> item);
 	void UpdateWidgets(bool force = false);
+	void ScheduleVisibleWidgetsUpdate();
 	void MoveItemBefore(const std::shared_ptr<Macro> &item,
 			    const std::shared_ptr<Macro> &after) const;
 	void MoveItemAfter(const std::shared_ptr<Macro> &item,
@@ -162,9 +167,13 @@ private:
 	MacroTreeModel *GetModel() const;
 
 	bool _highlight = false;
+	// Height of the rows, which currently have no item widget
+	int _rowHeight = 0;
+	bool _visibleWidgetsUpdatePending = false;
 
 	friend class MacroTreeModel;
 	friend class MacroTreeItem;
+	friend class MacroTreeDelegate;
 };
 
 class MacroTreeDelegate : public QStyledItemDelegate {
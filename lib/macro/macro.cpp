@@ -3,17 +3,23 @@
 #include "macro-condition-factory.hpp"
 #include "macro-dock.hpp"
 #include "macro-helpers.hpp"
+#include "macro-performance.hpp"
 #include "macro-settings.hpp"
+#include "name-index.hpp"
 #include "plugin-state-helpers.hpp"
 #include "splitter-helpers.hpp"
 #include "sync-helpers.hpp"
+#include "thread-pool.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <limits>
 #undef max
 #include <obs-frontend-api.h>
 #include <QAction>
+#include <QCoreApplication>
 #include <QMainWindow>
+#include <QThread>
 #include <unordered_map>
 #include <util/platform.h>
 
@@ -77,6 +83,16 @@ namespace advss {
 
 static std::deque<std::shared_ptr<Macro>> macros;
 
+// Incremented whenever a macro is renamed or destroyed
+static std::atomic_uint64_t macroNameGeneration = 0;
+
+static uint64_t getMacroNameGeneration()
+{
+	return macroNameGeneration;
+}
+
+static NameIndex<Macro> macroIndex(macros, getMacroNameGeneration);
+
 Macro::Macro(const std::string &name)
 {
 	SetName(name);
@@ -96,6 +112,8 @@ Macro::Macro(const std::string &name, const GlobalMacroSettings &settings)
 
 Macro::~Macro()
 {
+	++macroNameGeneration;
+	SaveDataCache::InvalidateAll();
 	_die = true;
 	Stop();
 	ClearHotkeys();
@@ -167,6 +185,16 @@ void Macro::PrepareMoveToGroup(std::shared_ptr<Macro> group,
 	}
 }
 
+static ThreadPool conditionCheckPool;
+static bool setupConditionCheckPool();
+static bool conditionCheckPoolSetupDone = setupConditionCheckPool();
+
+static bool setupConditionCheckPool()
+{
+	AddPluginCleanupStep([]() { conditionCheckPool.Stop(); });
+	return true;
+}
+
 static bool checkCondition(const std::shared_ptr<MacroCondition> &condition)
 {
 	using namespace std::chrono_literals;
@@ -179,6 +207,7 @@ static bool checkCondition(const std::shared_ptr<MacroCondition> &condition)
 	});
 	const auto endTime = std::chrono::high_resolution_clock::now();
 	const auto timeSpent = endTime - startTime;
+	GetConditionLatencyHistogram(condition->GetId()).Record(timeSpent);
 
 	if (timeSpent >= perfLogThreshold) {
 		const long int ms =
@@ -255,6 +284,12 @@ bool Macro::CheckConditions(bool ignorePause)
 		return false;
 	}
 
+	if (!LoadPendingSegments()) {
+		mblog(LOG_INFO, "segments of %s are not loaded yet",
+		      _name.c_str());
+		return false;
+	}
+
 	const auto checkConditionsTask =
 		[this,
 		 ignorePause](const std::deque<std::shared_ptr<MacroCondition>>
@@ -275,16 +310,21 @@ bool Macro::CheckConditions(bool ignorePause)
 			return _matched;
 		};
 
+	_skipActionsThisInterval = false;
+
 	if (CheckInParallel()) {
 		if (!_conditionCheckFuture.valid()) {
 			_stop = false;
 			_matched = false;
+			_lastCheckWakeupSnapshot = GetWakeupSnapshot();
 			_conditionCheckFuture = std::async(
 				std::launch::async,
 				[this, checkConditionsTask]() {
 					// Copy to avoid settings modifications
 					// causing issues
 					const auto conditionsCopy = _conditions;
+					ScopedLatencyRecorder recorder(
+						_conditionCheckLatency);
 					checkConditionsTask(conditionsCopy);
 				});
 			return false;
@@ -300,6 +340,8 @@ bool Macro::CheckConditions(bool ignorePause)
 	} else {
 		_stop = false;
 		_matched = false;
+		_lastCheckWakeupSnapshot = GetWakeupSnapshot();
+		ScopedLatencyRecorder recorder(_conditionCheckLatency);
 		_matched = checkConditionsTask(_conditions);
 	}
 
@@ -381,8 +423,51 @@ bool Macro::ConditionsShouldBeChecked() const
 	       _customConditionCheckInterval.Milliseconds();
 }
 
+bool Macro::ConditionsAffectedByWakeup(bool isPollInterval) const
+{
+	if (_isGroup) {
+		return false;
+	}
+
+	WakeupSource sources = WakeupSource::NONE;
+	for (const auto &condition : _conditions) {
+		if (condition) {
+			sources = sources | condition->GetWakeupSources();
+		}
+	}
+
+	if (isPollInterval) {
+		// Conditions which were true or changed their state recently
+		// might become false again without any wakeup source firing
+		// (e.g. after all pending messages were consumed).
+		// So they have to be checked until they settle down.
+		const bool neverChecked = _lastCheckTime == TimePoint{};
+		if (_conditions.empty() || (sources & WakeupSource::POLL) ||
+		    _matched || _conditionSateChanged || neverChecked) {
+			return true;
+		}
+	}
+
+	return GetWakeupSnapshot().FiredSince(_lastCheckWakeupSnapshot,
+					      sources);
+}
+
+void Macro::SkipConditionCheck(bool isPollInterval)
+{
+	// The result of the previous check is still valid, so make sure
+	// "on change" actions are not performed again.
+	// If this interval was triggered by a wakeup source, only macros
+	// affected by it are allowed to perform actions.
+	_conditionSateChanged = false;
+	_skipActionsThisInterval = !isPollInterval;
+}
+
 bool Macro::ShouldRunActions() const
 {
+	if (_skipActionsThisInterval) {
+		return false;
+	}
+
 	if (CheckInParallel() && _conditionCheckFuture.valid()) {
 		vblog(LOG_INFO,
 		      "%s not ready to perform actions as condition check is still running",
@@ -414,6 +499,9 @@ void Macro::SetName(const std::string &name)
 {
 	const bool nameChanged = _name == name;
 	_name = name;
+	++macroNameGeneration;
+	// Segments referring to this macro save its name
+	SaveDataCache::InvalidateAll();
 
 	SetHotkeysDesc();
 
@@ -440,6 +528,7 @@ bool Macro::RunActionsHelper(
 	// reordered while actions are currently being executed.
 	auto actions = actionsToRun;
 
+	ScopedLatencyRecorder recorder(_actionRunLatency);
 	bool actionsExecutedSuccessfully = true;
 	for (auto &action : actions) {
 		if (!action) {
@@ -449,6 +538,9 @@ bool Macro::RunActionsHelper(
 			action->LogAction();
 			bool actionResult = false;
 			action->WithLock([&action, &actionResult]() {
+				ScopedLatencyRecorder recorder(
+					GetActionLatencyHistogram(
+						action->GetId()));
 				actionResult = action->PerformAction();
 			});
 			actionsExecutedSuccessfully =
@@ -471,15 +563,41 @@ bool Macro::RunActionsHelper(
 bool Macro::RunActions(bool ignorePause)
 {
 	mblog(LOG_INFO, "running actions of %s", _name.c_str());
+	if (!LoadPendingSegments()) {
+		mblog(LOG_INFO, "segments of %s are not loaded yet",
+		      _name.c_str());
+		return true;
+	}
 	return RunActionsHelper(_actions, ignorePause);
 }
 
 bool Macro::RunElseActions(bool ignorePause)
 {
 	mblog(LOG_INFO, "running else actions of %s", _name.c_str());
+	if (!LoadPendingSegments()) {
+		mblog(LOG_INFO, "segments of %s are not loaded yet",
+		      _name.c_str());
+		return true;
+	}
 	return RunActionsHelper(_elseActions, ignorePause);
 }
 
+const LatencyHistogram &Macro::GetConditionCheckLatency() const
+{
+	return _conditionCheckLatency;
+}
+
+const LatencyHistogram &Macro::GetActionRunLatency() const
+{
+	return _actionRunLatency;
+}
+
+void Macro::ResetLatencyStatistics()
+{
+	_conditionCheckLatency.Reset();
+	_actionRunLatency.Reset();
+}
+
 bool Macro::WasPausedSince(const TimePoint &time) const
 {
 	return _lastUnpauseTime > time;
@@ -532,6 +650,9 @@ void Macro::SetPaused(bool pause)
 		ResetTimers();
 	}
 	_paused = pause;
+	if (!pause && !_segmentsLoaded) {
+		QueueLoadPendingSegments();
+	}
 }
 
 void Macro::AddHelperThread(std::thread &&newThread)
@@ -558,6 +679,7 @@ Macro::PauseStateSaveBehavior Macro::GetPauseStateSaveBehavior() const
 void Macro::Stop()
 {
 	_stop = true;
+	++*_stopCount;
 	GetMacroWaitCV().notify_all();
 	for (auto &t : _helperThreads) {
 		if (t.joinable()) {
@@ -575,6 +697,9 @@ void Macro::Stop()
 void Macro::SetCheckInParallel(bool parallel)
 {
 	_checkInParallel = parallel;
+	if (_conditionCheckFuture.valid()) {
+		_conditionCheckFuture.wait();
+	}
 	_conditionCheckFuture = {};
 }
 
@@ -607,6 +732,7 @@ void Macro::SetInputVariables(const MacroInputVariables &inputVariables)
 
 std::vector<TempVariable> Macro::GetTempVars(MacroSegment *filter) const
 {
+	LoadPendingSegments();
 	std::vector<TempVariable> res;
 
 	auto addTempVars = [&res](const std::deque<std::shared_ptr<MacroSegment>>
@@ -727,31 +853,37 @@ void Macro::InvalidateTempVarValues() const
 
 std::deque<std::shared_ptr<MacroCondition>> &Macro::Conditions()
 {
+	LoadPendingSegments();
 	return _conditions;
 }
 
 const std::deque<std::shared_ptr<MacroCondition>> &Macro::Conditions() const
 {
+	LoadPendingSegments();
 	return _conditions;
 }
 
 std::deque<std::shared_ptr<MacroAction>> &Macro::Actions()
 {
+	LoadPendingSegments();
 	return _actions;
 }
 
 const std::deque<std::shared_ptr<MacroAction>> &Macro::Actions() const
 {
+	LoadPendingSegments();
 	return _actions;
 }
 
 std::deque<std::shared_ptr<MacroAction>> &Macro::ElseActions()
 {
+	LoadPendingSegments();
 	return _elseActions;
 }
 
 const std::deque<std::shared_ptr<MacroAction>> &Macro::ElseActions() const
 {
+	LoadPendingSegments();
 	return _elseActions;
 }
 
@@ -790,6 +922,58 @@ std::shared_ptr<Macro> Macro::Parent() const
 	return _parent.lock();
 }
 
+template<class T>
+static void saveSegments(obs_data_t *obj, const char *name,
+			 const std::deque<std::shared_ptr<T>> &segments)
+{
+	OBSDataArrayAutoRelease array = obs_data_array_create();
+	for (const auto &segment : segments) {
+		OBSDataAutoRelease arrayObj = obs_data_create();
+		segment->Save(arrayObj);
+		obs_data_array_push_back(array, arrayObj);
+	}
+	obs_data_set_array(obj, name, array);
+}
+
+template<class T>
+static bool
+settingsChangeAtRuntime(const std::deque<std::shared_ptr<T>> &segments)
+{
+	return std::any_of(segments.begin(), segments.end(),
+			   [](const std::shared_ptr<T> &segment) {
+				   return segment->SettingsChangeAtRuntime();
+			   });
+}
+
+void Macro::SaveSegments(obs_data_t *obj) const
+{
+	const auto save = [this](obs_data_t *data) {
+		saveSegments(data, "conditions", _conditions);
+		saveSegments(data, "actions", _actions);
+		saveSegments(data, "elseActions", _elseActions);
+	};
+
+	if (_isBeingEdited || settingsChangeAtRuntime(_conditions) ||
+	    settingsChangeAtRuntime(_actions) ||
+	    settingsChangeAtRuntime(_elseActions)) {
+		save(obj);
+		return;
+	}
+
+	OBSDataAutoRelease data = _segmentSaveData.Get(save);
+	for (const auto name : {"conditions", "actions", "elseActions"}) {
+		OBSDataArrayAutoRelease segments =
+			obs_data_get_array(data, name);
+		obs_data_set_array(obj, name, segments);
+	}
+}
+
+void Macro::SetBeingEdited(bool value)
+{
+	_isBeingEdited = value;
+	SegmentSettingsModified();
+}
+
 bool Macro::Save(obs_data_t *obj, bool saveForCopy) const
 {
 	if (!saveForCopy) {
@@ -835,29 +1019,9 @@ bool Macro::Save(obs_data_t *obj, bool saveForCopy) const
 		obs_hotkey_save(_togglePauseHotkey);
 	obs_data_set_array(obj, "togglePauseHotkey", togglePauseHotkey);
 
-	OBSDataArrayAutoRelease conditions = obs_data_array_create();
-	for (auto &c : _conditions) {
-		OBSDataAutoRelease arrayObj = obs_data_create();
-		c->Save(arrayObj);
-		obs_data_array_push_back(conditions, arrayObj);
+	if (!SavePendingSegments(obj)) {
+		SaveSegments(obj);
 	}
-	obs_data_set_array(obj, "conditions", conditions);
-
-	OBSDataArrayAutoRelease actions = obs_data_array_create();
-	for (auto &a : _actions) {
-		OBSDataAutoRelease arrayObj = obs_data_create();
-		a->Save(arrayObj);
-		obs_data_array_push_back(actions, arrayObj);
-	}
-	obs_data_set_array(obj, "actions", actions);
-
-	OBSDataArrayAutoRelease elseActions = obs_data_array_create();
-	for (auto &a : _elseActions) {
-		OBSDataAutoRelease arrayObj = obs_data_create();
-		a->Save(arrayObj);
-		obs_data_array_push_back(elseActions, arrayObj);
-	}
-	obs_data_set_array(obj, "elseActions", elseActions);
 
 	_inputVariables.Save(obj);
 
@@ -867,6 +1031,7 @@ bool Macro::Save(obs_data_t *obj, bool saveForCopy) const
 bool Macro::Load(obs_data_t *obj)
 {
 	_name = obs_data_get_string(obj, "name");
+	++macroNameGeneration;
 
 	_isGroup = obs_data_get_bool(obj, "group");
 	if (_isGroup) {
@@ -928,6 +1093,26 @@ bool Macro::Load(obs_data_t *obj)
 	obs_hotkey_load(_togglePauseHotkey, togglePauseHotkey);
 	SetHotkeysDesc();
 
+	// Creating the segments of paused macros is deferred, as they might
+	// not be needed at all
+	if (_paused) {
+		std::lock_guard<std::recursive_mutex> lock(
+			_pendingSegmentsMutex);
+		_pendingSegmentData = obj;
+		_pendingSegmentDataGeneration =
+			SaveDataCache::GetGlobalGeneration();
+		_segmentsLoaded = false;
+	} else {
+		LoadSegments(obj);
+	}
+
+	_inputVariables.Load(obj);
+
+	return true;
+}
+
+void Macro::LoadSegments(obs_data_t *obj)
+{
 	bool root = true;
 	OBSDataArrayAutoRelease conditions =
 		obs_data_get_array(obj, "conditions");
@@ -984,7 +1169,7 @@ bool Macro::Load(obs_data_t *obj)
 		auto newEntry = MacroActionFactory::Create(id, this);
 		if (newEntry) {
 			_elseActions.emplace_back(newEntry);
-			auto action = _actions.back().get();
+			auto action = _elseActions.back().get();
 			action->WithLock([action, &arrayObj]() {
 				action->Load(arrayObj);
 			});
@@ -995,9 +1180,98 @@ bool Macro::Load(obs_data_t *obj)
 		}
 	}
 	UpdateElseActionIndices();
+}
 
-	_inputVariables.Load(obj);
+bool Macro::LoadPendingSegments() const
+{
+	if (_segmentsLoaded) {
+		return true;
+	}
+
+	// Segments might be QObjects or set up QObjects, like file system
+	// watchers, which rely on the event loop of the main thread.
+	// Other threads must not wait for the main thread, as they might hold
+	// locks the main thread is waiting for, so the segments are only
+	// created once the main thread gets to it.
+	auto app = QCoreApplication::instance();
+	if (QThread::currentThread() != app->thread()) {
+		QueueLoadPendingSegments();
+		return false;
+	}
 
+	std::lock_guard<std::recursive_mutex> lock(_pendingSegmentsMutex);
+	if (_segmentsLoaded || _loadingSegments) {
+		return _segmentsLoaded;
+	}
+
+	// The segments are a lazily initialized part of the macro, so this is
+	// not considered a modification
+	_loadingSegments = true;
+	auto macro = const_cast<Macro *>(this);
+	macro->LoadSegments(_pendingSegmentData);
+	macro->PostLoad();
+	RunPostLoadSteps();
+	_pendingSegmentData = nullptr;
+	_loadingSegments = false;
+	_segmentsLoaded = true;
+	return true;
+}
+
+void Macro::QueueLoadPendingSegments() const
+{
+	if (_segmentsLoaded || _segmentLoadQueued.exchange(true)) {
+		return;
+	}
+
+	// Macros which are still being loaded are not part of the macro list
+	// yet, in which case the segments are loaded by the next check
+	auto weakMacro = GetWeakMacroByName(_name.c_str());
+	if (weakMacro.expired()) {
+		_segmentLoadQueued = false;
+		return;
+	}
+	QMetaObject::invokeMethod(
+		QCoreApplication::instance(),
+		[weakMacro]() {
+			auto macro = weakMacro.lock();
+			if (!macro) {
+				return;
+			}
+			// Macro threads access the segment lists while holding
+			// the lock
+			auto lock = LockContext();
+			macro->LoadPendingSegments();
+			macro->_segmentLoadQueued = false;
+		},
+		Qt::QueuedConnection);
+}
+
+bool Macro::SavePendingSegments(obs_data_t *obj) const
+{
+	std::lock_guard<std::recursive_mutex> lock(_pendingSegmentsMutex);
+	if (_segmentsLoaded) {
+		return false;
+	}
+
+	// Items referred to by the segments, like sources, macros, or
+	// variables, might have been renamed, in which case the pending
+	// settings are outdated and the segments have to be created to save
+	// the new names.
+	// If this is not possible on the current thread, the outdated settings
+	// are saved until the segments were created on the main thread.
+	if (_pendingSegmentDataGeneration !=
+		    SaveDataCache::GetGlobalGeneration() &&
+	    LoadPendingSegments()) {
+		return false;
+	}
+
+	// The segment settings cannot have changed otherwise since they were
+	// loaded
+	for (const auto name : {"conditions", "actions", "elseActions"}) {
+		OBSDataArrayAutoRelease segments =
+			obs_data_get_array(_pendingSegmentData, name);
+		obs_data_set_array(obj, name, segments);
+	}
 	return true;
 }
 
@@ -1471,25 +1745,137 @@ std::deque<std::shared_ptr<Macro>> &GetMacros()
 	return macros;
 }
 
+static bool conditionsReferenceOtherMacros(const Macro &macro)
+{
+	for (const auto &condition : macro.Conditions()) {
+		if (dynamic_cast<MacroRefCondition *>(condition.get()) ||
+		    dynamic_cast<MultiMacroRefCondition *>(condition.get())) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool checkMacroConditions(Macro &macro)
+{
+	return macro.CheckConditions() || macro.ElseActions().size() > 0;
+}
+
+static std::atomic<std::chrono::high_resolution_clock::time_point>
+	macroCheckStartTime{};
+
+std::chrono::high_resolution_clock::time_point GetMacroCheckStartTime()
+{
+	return macroCheckStartTime;
+}
+
 bool CheckMacros()
 {
+	macroCheckStartTime = std::chrono::high_resolution_clock::now();
+
+	const bool eventDriven = EventDrivenMacroChecksEnabled();
+	const bool isPollInterval = !IsWakeupTriggeredInterval();
+	const int threadCount = GetMacroConditionCheckThreadCount();
+	const bool checkConcurrently = threadCount > 1;
+
+	// The calling thread also helps with processing the condition checks,
+	// so one thread less is required in the pool
+	const size_t poolSize = checkConcurrently ? threadCount - 1 : 0;
+	conditionCheckPool.SetThreadCount(poolSize);
+
 	bool matchFound = false;
+	std::vector<std::shared_ptr<Macro>> macrosToCheck;
 	for (const auto &m : macros) {
+		// Segments are only created on the main thread, so the macro
+		// is checked once that is done instead of blocking the check
+		if (!m->SegmentsLoaded()) {
+			if (!m->Paused()) {
+				m->QueueLoadPendingSegments();
+			}
+			continue;
+		}
+
 		if (!m->ConditionsShouldBeChecked()) {
 			vblog(LOG_INFO,
 			      "skipping condition check for macro \"%s\" "
 			      "(custom check interval)",
 			      m->Name().c_str());
+			m->SkipConditionCheck(isPollInterval);
 			continue;
 		}
 
-		if (m->CheckConditions() || m->ElseActions().size() > 0) {
-			matchFound = true;
-			// This has to be performed here for now as actions are
-			// not performed immediately after checking conditions.
-			if (m->SwitchesScene()) {
-				SetMacroSwitchedScene(true);
+		if (eventDriven &&
+		    !m->ConditionsAffectedByWakeup(isPollInterval)) {
+			vblog(LOG_INFO,
+			      "skipping condition check for macro \"%s\" "
+			      "(no relevant wakeup source fired)",
+			      m->Name().c_str());
+			m->SkipConditionCheck(isPollInterval);
+			if (isPollInterval && (m->ConditionsMatched() ||
+					       m->ElseActions().size() > 0)) {
+				matchFound = true;
 			}
+			continue;
+		}
+
+		macrosToCheck.emplace_back(m);
+	}
+
+	// Macros depending on the state of other macros and macros which are
+	// already checked in parallel to the main loop are handled afterwards
+	// on the calling thread.
+	std::vector<size_t> deferredIdxs;
+	std::vector<size_t> concurrentIdxs;
+	// Using std::deque instead of std::vector to allow concurrent writes
+	std::deque<bool> results(macrosToCheck.size(), false);
+	for (size_t i = 0; i < macrosToCheck.size(); i++) {
+		auto &macro = *macrosToCheck[i];
+		if (!checkConcurrently || macro.CheckInParallel() ||
+		    conditionsReferenceOtherMacros(macro)) {
+			deferredIdxs.emplace_back(i);
+			continue;
+		}
+		concurrentIdxs.emplace_back(i);
+	}
+
+	// The workers and the calling thread take the macros of this batch one
+	// after another, so the calling thread never ends up running anything
+	// unrelated to the current batch
+	std::atomic_size_t nextIdx = {0};
+	const auto checkRemainingMacros = [&]() {
+		for (size_t i = nextIdx++; i < concurrentIdxs.size();
+		     i = nextIdx++) {
+			const auto idx = concurrentIdxs[i];
+			results[idx] = checkMacroConditions(*macrosToCheck[idx]);
+		}
+	};
+	std::vector<std::future<void>> helpers;
+	const size_t helperCount =
+		concurrentIdxs.empty()
+			? 0
+			: std::min(poolSize, concurrentIdxs.size() - 1);
+	for (size_t i = 0; i < helperCount; i++) {
+		helpers.emplace_back(
+			conditionCheckPool.Submit(checkRemainingMacros));
+	}
+	checkRemainingMacros();
+	for (auto &helper : helpers) {
+		helper.get();
+	}
+
+	for (const auto idx : deferredIdxs) {
+		results[idx] = checkMacroConditions(*macrosToCheck[idx]);
+	}
+
+	for (size_t i = 0; i < macrosToCheck.size(); i++) {
+		if (!results[i]) {
+			continue;
+		}
+		matchFound = true;
+		// This has to be performed here for now as actions are
+		// not performed immediately after checking conditions.
+		if (macrosToCheck[i]->SwitchesScene()) {
+			SetMacroSwitchedScene(true);
 		}
 	}
 	return matchFound;
@@ -1548,13 +1934,7 @@ void StopAllMacros()
 
 Macro *GetMacroByName(const char *name)
 {
-	for (const auto &m : macros) {
-		if (m->Name() == name) {
-			return m.get();
-		}
-	}
-
-	return nullptr;
+	return macroIndex.Find(name).get();
 }
 
 Macro *GetMacroByQString(const QString &name)
@@ -1564,13 +1944,7 @@ Macro *GetMacroByQString(const QString &name)
 
 std::weak_ptr<Macro> GetWeakMacroByName(const char *name)
 {
-	for (const auto &m : macros) {
-		if (m->Name() == name) {
-			return m;
-		}
-	}
-
-	return {};
+	return macroIndex.Find(name);
 }
 
 void InvalidateMacroTempVarValues()
@@ -1,12 +1,15 @@
 #pragma once
+#include "latency-histogram.hpp"
 #include "macro-action.hpp"
 #include "macro-condition.hpp"
 #include "macro-helpers.hpp"
 #include "macro-input.hpp"
 #include "macro-ref.hpp"
+#include "save-data-cache.hpp"
 #include "variable-string.hpp"
 #include "temp-variable.hpp"
 
+#include <atomic>
 #include <future>
 #include <QString>
 #include <QByteArray>
@@ -14,6 +17,7 @@
 #include <deque>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <thread>
 #include <obs.hpp>
 #include <obs-module-helper.hpp>
@@ -40,6 +44,8 @@ public:
 	bool ConditionsMatched() const { return _matched; }
 	TimePoint LastConditionCheckTime() const { return _lastCheckTime; }
 	bool ConditionsShouldBeChecked() const;
+	bool ConditionsAffectedByWakeup(bool isPollInterval) const;
+	void SkipConditionCheck(bool isPollInterval);
 
 	bool ShouldRunActions() const;
 	bool PerformActions(bool match, bool forceParallel = false,
@@ -54,6 +60,11 @@ public:
 
 	void Stop();
 	bool GetStop() const { return _stop; }
+	// Incremented each time the macro is stopped and when it is destroyed
+	std::shared_ptr<const std::atomic<uint64_t>> GetStopCount() const
+	{
+		return _stopCount;
+	}
 	void ResetTimers();
 
 	void SetMatchOnChange(bool onChange);
@@ -76,6 +87,11 @@ public:
 	int RunCount() const { return _runCount; };
 	void ResetRunCount() { _runCount = 0; };
 
+	// Performance statistics
+	const LatencyHistogram &GetConditionCheckLatency() const;
+	const LatencyHistogram &GetActionRunLatency() const;
+	void ResetLatencyStatistics();
+
 	void AddHelperThread(std::thread &&);
 	void SetRunInParallel(bool parallel) { _runInParallel = parallel; }
 	bool RunInParallel() const { return _runInParallel; }
@@ -128,6 +144,20 @@ public:
 	// Some macros can refer to other macros, which are not yet loaded.
 	// Use this function to set these references after loading is complete.
 	bool PostLoad();
+	// The segments of macros, which are paused when loading, are only
+	// created once they are accessed or the macro is unpaused.
+	// They are always created on the main thread. Other threads never
+	// wait for that, so false is returned if the segments are not
+	// available yet.
+	bool SegmentsLoaded() const { return _segmentsLoaded; }
+	bool LoadPendingSegments() const;
+	// Creates the segments on the main thread without waiting for it
+	void QueueLoadPendingSegments() const;
+	// The saved settings of the segments are reused until the segments
+	// might have been modified, which is assumed to be the case while the
+	// macro is being edited
+	void SetBeingEdited(bool);
+	void SegmentSettingsModified() { _segmentSaveData.Invalidate(); }
 
 	// Helper function for plugin state condition regarding scene change
 	bool SwitchesScene() const;
@@ -184,21 +214,38 @@ private:
 
 	void SaveDockSettings(obs_data_t *obj, bool saveForCopy) const;
 	void LoadDockSettings(obs_data_t *obj);
+	void LoadSegments(obs_data_t *obj);
+	bool SavePendingSegments(obs_data_t *obj) const;
+	void SaveSegments(obs_data_t *obj) const;
 	void RemoveDock();
 	static std::string GenerateDockId();
 
 	std::string _name = "";
 	bool _die = false;
 	bool _stop = false;
+	std::shared_ptr<std::atomic<uint64_t>> _stopCount =
+		std::make_shared<std::atomic<uint64_t>>(0);
 	std::future<void> _actionRunFuture;
 	TimePoint _lastCheckTime{};
 	TimePoint _lastUnpauseTime{};
 	TimePoint _lastExecutionTime{};
 	std::vector<std::thread> _helperThreads;
+	LatencyHistogram _conditionCheckLatency;
+	LatencyHistogram _actionRunLatency;
 
 	std::deque<std::shared_ptr<MacroCondition>> _conditions;
 	std::deque<std::shared_ptr<MacroAction>> _actions;
 	std::deque<std::shared_ptr<MacroAction>> _elseActions;
+	mutable std::atomic_bool _segmentsLoaded = {true};
+	// Segments might access the macro they belong to while being loaded
+	mutable std::recursive_mutex _pendingSegmentsMutex;
+	mutable bool _loadingSegments = false;
+	mutable std::atomic_bool _segmentLoadQueued = {false};
+	mutable OBSData _pendingSegmentData;
+	// The pending settings might refer to items which were renamed since
+	uint64_t _pendingSegmentDataGeneration = 0;
+	mutable SaveDataCache _segmentSaveData;
+	std::atomic_bool _isBeingEdited = {false};
 
 	std::weak_ptr<Macro> _parent;
 	uint32_t _groupSize = 0;
@@ -214,6 +261,8 @@ private:
 	bool _checkInParallel = false;
 	bool _matched = false;
 	std::future<void> _conditionCheckFuture;
+	WakeupSnapshot _lastCheckWakeupSnapshot;
+	bool _skipActionsThisInterval = false;
 	bool _lastMatched = false;
 	bool _performActionsOnChange = true;
 	bool _skipExecOnStart = false;
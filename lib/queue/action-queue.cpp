@@ -1,4 +1,5 @@
 #include "action-queue.hpp"
+#include "name-index.hpp"
 #include "obs-module-helper.hpp"
 #include "plugin-state-helpers.hpp"
 #include "ui-helpers.hpp"
@@ -6,6 +7,7 @@
 namespace advss {
 
 static std::deque<std::shared_ptr<Item>> queues;
+static NameIndex<Item> queueIndex(queues, GetItemNameGeneration);
 
 std::deque<std::shared_ptr<Item>> &GetActionQueues()
 {
@@ -51,7 +53,7 @@ void ActionQueue::Save(obs_data_t *obj) const
 void ActionQueue::Load(obs_data_t *obj)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
-	_name = obs_data_get_string(obj, "name");
+	SetName(obs_data_get_string(obj, "name"));
 	_runOnStartup = obs_data_get_bool(obj, "runOnStartup");
 	_resolveVariablesOnAdd =
 		obs_data_get_bool(obj, "resolveVariablesOnAdd");
@@ -250,7 +252,7 @@ bool ActionQueueSettingsDialog::AskForSettings(QWidget *parent,
 		return false;
 	}
 
-	settings._name = dialog._name->text().toStdString();
+	settings.SetName(dialog._name->text().toStdString());
 	settings._runOnStartup = dialog._runOnStartup->isChecked();
 	settings._resolveVariablesOnAdd =
 		dialog._resolveVariablesOnAdd->isChecked();
@@ -428,14 +430,7 @@ void ImportQueues(obs_data_t *data)
 
 std::weak_ptr<ActionQueue> GetWeakActionQueueByName(const std::string &name)
 {
-	for (const auto &queue : queues) {
-		if (queue->Name() == name) {
-			std::weak_ptr<ActionQueue> wp =
-				std::dynamic_pointer_cast<ActionQueue>(queue);
-			return wp;
-		}
-	}
-	return std::weak_ptr<ActionQueue>();
+	return std::dynamic_pointer_cast<ActionQueue>(queueIndex.Find(name));
 }
 
 std::weak_ptr<ActionQueue> GetWeakActionQueueByQString(const QString &name)
@@ -170,10 +170,14 @@ void SwitcherData::SaveVersion(obs_data_t *obj,
 
 void SwitcherData::RunPostLoadSteps()
 {
-	for (const auto &func : postLoadSteps) {
+	std::vector<std::function<void()>> steps;
+	{
+		std::lock_guard<std::mutex> lock(postLoadStepsMutex);
+		steps.swap(postLoadSteps);
+	}
+	for (const auto &func : steps) {
 		func();
 	}
-	postLoadSteps.clear();
 }
 
 void SwitcherData::AddSaveStep(std::function<void(obs_data_t *)> function)
@@ -190,6 +194,7 @@ void SwitcherData::AddLoadStep(std::function<void(obs_data_t *)> function)
 
 void SwitcherData::AddPostLoadStep(std::function<void()> function)
 {
+	std::lock_guard<std::mutex> lock(postLoadStepsMutex);
 	postLoadSteps.emplace_back(function);
 }
 
@@ -19,6 +19,7 @@
 #include "priority-helper.hpp"
 #include "plugin-state-helpers.hpp"
 
+#include <atomic>
 #include <condition_variable>
 #include <vector>
 #include <deque>
@@ -56,6 +57,10 @@ public:
 	bool SceneChangedDuringWait();
 	bool AnySceneTransitionStarted();
 
+	bool WaitForIntervalOrWakeup(std::unique_lock<std::mutex> &lock,
+				     std::chrono::milliseconds duration);
+	void RunWakeupTriggeredInterval();
+
 	void SetPreconditions();
 	void AddSaveStep(std::function<void(obs_data_t *)>);
 	void AddLoadStep(std::function<void(obs_data_t *)>);
@@ -98,6 +103,9 @@ public:
 	std::vector<std::function<void(obs_data_t *)>> saveSteps;
 	std::vector<std::function<void(obs_data_t *)>> loadSteps;
 	std::vector<std::function<void()>> postLoadSteps;
+	// Segments of paused macros might be loaded outside of LoadSettings()
+	// on any thread
+	std::mutex postLoadStepsMutex;
 
 	bool firstBoot = true;
 	bool transitionActive = false;
@@ -107,6 +115,10 @@ public:
 	bool firstIntervalAfterStop = true;
 	bool startupLoadDone = false;
 
+	std::atomic_bool waitingForWakeup = {false};
+	uint64_t lastHandledWakeup = 0;
+	bool wakeupTriggeredInterval = false;
+
 	obs_source_t *waitScene = nullptr;
 	OBSWeakSource currentScene = nullptr;
 	OBSWeakSource previousScene = nullptr;
@@ -131,6 +143,7 @@ public:
 	bool showSystemTrayNotifications = false;
 	bool transitionOverrideOverride = false;
 	bool adjustActiveTransitionType = true;
+	bool eventDrivenMacroChecks = false;
 
 	/* --- End of General tab section --- */
 
@@ -142,6 +155,7 @@ public:
 		GetDefaultFunctionPriorityList();
 	const std::vector<ThreadPrio> threadPriorities = GetThreadPrioMapping();
 	uint32_t threadPriority = QThread::NormalPriority;
+	int macroConditionCheckThreadCount = 1;
 
 	/* --- Start of hotkey section --- */
 
@@ -165,6 +179,8 @@ public:
 	bool disableHints = false;
 	bool disableFilterComboboxFilter = false;
 	bool disableMacroWidgetCache = false;
+	int macroWidgetCacheSize = 20;
+	int macroWidgetCacheMemoryLimit = 150; // MB
 	bool hideLegacyTabs = true;
 	bool saveWindowGeo = false;
 	QPoint windowPos = {};
@@ -3,6 +3,7 @@
 
 #include <QDir>
 #include <QFileInfo>
+#include <array>
 #include <curl/curl.h>
 
 namespace advss {
@@ -15,10 +16,22 @@ constexpr auto curl_library_name = "libcurl.4.dylib";
 constexpr auto curl_library_name = "libcurl.so.4";
 #endif
 
+static std::array<std::mutex, CURL_LOCK_DATA_LAST> shareLocks;
+
+static void lockShare(CURL *, curl_lock_data data, curl_lock_access, void *)
+{
+	shareLocks[data].lock();
+}
+
+static void unlockShare(CURL *, curl_lock_data data, void *)
+{
+	shareLocks[data].unlock();
+}
+
 CurlHelper::CurlHelper()
 {
 	if (LoadLib()) {
-		_curl = _init();
+		SetupShare();
 		_initialized = true;
 	}
 }
@@ -27,13 +40,77 @@ CurlHelper::~CurlHelper()
 {
 	if (_lib) {
 		if (_cleanup) {
-			_cleanup(_curl);
+			for (auto handle : _handles) {
+				_cleanup(handle);
+			}
+		}
+		if (_share && _shareCleanup) {
+			_shareCleanup(_share);
 		}
 		delete _lib;
 		_lib = nullptr;
 	}
 }
 
+void CurlHelper::SetupShare()
+{
+	if (!_shareInit || !_shareSetopt || !_shareCleanup) {
+		return;
+	}
+	_share = _shareInit();
+	if (!_share) {
+		return;
+	}
+	_shareSetopt(_share, CURLSHOPT_LOCKFUNC, lockShare);
+	_shareSetopt(_share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+	_shareSetopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	_shareSetopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	// Sharing the connection cache is not supported for handles used
+	// concurrently by different threads, so each handle keeps its own
+}
+
+// Returns the handle to the pool of unused handles once the thread exits
+struct CurlHelper::ThreadHandle {
+	~ThreadHandle()
+	{
+		if (handle) {
+			GetInstance().ReleaseHandle(handle);
+		}
+	}
+	CURL *handle = nullptr;
+};
+
+CURL *CurlHelper::GetHandle()
+{
+	thread_local ThreadHandle threadHandle;
+	if (threadHandle.handle) {
+		return threadHandle.handle;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_idleHandles.empty()) {
+		threadHandle.handle = _idleHandles.back();
+		_idleHandles.pop_back();
+		return threadHandle.handle;
+	}
+
+	threadHandle.handle = _init();
+	if (!threadHandle.handle) {
+		return nullptr;
+	}
+	if (_share) {
+		_setopt(threadHandle.handle, CURLOPT_SHARE, _share);
+	}
+	_handles.emplace_back(threadHandle.handle);
+	return threadHandle.handle;
+}
+
+void CurlHelper::ReleaseHandle(CURL *handle)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_idleHandles.emplace_back(handle);
+}
+
 CurlHelper &CurlHelper::GetInstance()
 {
 	static CurlHelper curl;
@@ -54,13 +131,37 @@ curl_slist *CurlHelper::SlistAppend(curl_slist *list, const char *string)
 	return curl._slistAppend(list, string);
 }
 
-CURLcode CurlHelper::Perform()
+void CurlHelper::SlistFreeAll(curl_slist *list)
 {
 	auto &curl = GetInstance();
 	if (!curl._initialized) {
+		return;
+	}
+	curl._slistFreeAll(list);
+}
+
+CURLcode CurlHelper::Perform(long *responseCode)
+{
+	auto &curl = GetInstance();
+	if (!curl._initialized) {
+		return CURLE_FAILED_INIT;
+	}
+	auto handle = curl.GetHandle();
+	if (!handle) {
 		return CURLE_FAILED_INIT;
 	}
-	return curl._perform(curl._curl);
+	const auto result = curl._perform(handle);
+	if (responseCode) {
+		*responseCode = 0;
+		curl._getinfo(handle, CURLINFO_RESPONSE_CODE, responseCode);
+	}
+
+	// Resetting the options will keep the connection cache intact
+	curl._reset(handle);
+	if (curl._share) {
+		curl._setopt(handle, CURLOPT_SHARE, curl._share);
+	}
+	return result;
 }
 
 char *CurlHelper::GetError(CURLcode code)
@@ -120,12 +221,23 @@ bool CurlHelper::Resolve()
 	_init = (initFunction)_lib->resolve("curl_easy_init");
 	_setopt = (setOptFunction)_lib->resolve("curl_easy_setopt");
 	_slistAppend = (slistAppendFunction)_lib->resolve("curl_slist_append");
+	_slistFreeAll =
+		(slistFreeAllFunction)_lib->resolve("curl_slist_free_all");
 	_perform = (performFunction)_lib->resolve("curl_easy_perform");
+	_getinfo = (getInfoFunction)_lib->resolve("curl_easy_getinfo");
 	_cleanup = (cleanupFunction)_lib->resolve("curl_easy_cleanup");
+	_reset = (resetFunction)_lib->resolve("curl_easy_reset");
 	_error = (errorFunction)_lib->resolve("curl_easy_strerror");
 
-	if (_init && _setopt && _slistAppend && _perform && _cleanup &&
-	    _error) {
+	// Optional - handles will not share their caches if not available
+	_shareInit = (shareInitFunction)_lib->resolve("curl_share_init");
+	_shareSetopt =
+		(shareSetOptFunction)_lib->resolve("curl_share_setopt");
+	_shareCleanup =
+		(shareCleanupFunction)_lib->resolve("curl_share_cleanup");
+
+	if (_init && _setopt && _slistAppend && _slistFreeAll && _perform &&
+	    _getinfo && _cleanup && _reset && _error) {
 		blog(LOG_INFO, "curl loaded successfully");
 		return true;
 	}
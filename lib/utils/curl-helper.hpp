@@ -4,16 +4,27 @@
 #include <curl/curl.h>
 #include <QLibrary>
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace advss {
 
+// Wrapper around the dynamically loaded curl library.
+//
+// Each thread uses its own curl handle, so requests of different threads do
+// not have to wait for each other.
+// The handles are kept alive, so each thread reuses its connections across
+// requests, while the DNS and TLS session caches are shared by all handles.
+// The options of a handle are reset after each call to Perform().
 class CurlHelper {
 public:
 	EXPORT static bool Initialized();
 	template<typename... Args> static CURLcode SetOpt(CURLoption, Args...);
 	EXPORT static struct curl_slist *SlistAppend(struct curl_slist *list,
 						     const char *string);
-	EXPORT static CURLcode Perform();
+	EXPORT static void SlistFreeAll(struct curl_slist *list);
+	// The HTTP response code is written to responseCode, if provided
+	EXPORT static CURLcode Perform(long *responseCode = nullptr);
 	EXPORT static char *GetError(CURLcode code);
 
 private:
@@ -26,22 +37,44 @@ private:
 	typedef CURLcode (*setOptFunction)(CURL *, CURLoption, ...);
 	typedef struct curl_slist *(*slistAppendFunction)(
 		struct curl_slist *list, const char *string);
+	typedef void (*slistFreeAllFunction)(struct curl_slist *list);
 	typedef CURLcode (*performFunction)(CURL *);
+	typedef CURLcode (*getInfoFunction)(CURL *, CURLINFO, ...);
 	typedef void (*cleanupFunction)(CURL *);
+	typedef void (*resetFunction)(CURL *);
 	typedef char *(*errorFunction)(CURLcode);
+	typedef CURLSH *(*shareInitFunction)(void);
+	typedef CURLSHcode (*shareSetOptFunction)(CURLSH *, CURLSHoption, ...);
+	typedef CURLSHcode (*shareCleanupFunction)(CURLSH *);
+
+	struct ThreadHandle;
 
 	EXPORT static CurlHelper &GetInstance();
+	// Returns the handle of the calling thread
+	EXPORT CURL *GetHandle();
+	void ReleaseHandle(CURL *);
 
 	bool LoadLib();
 	bool Resolve();
+	void SetupShare();
 
 	initFunction _init = nullptr;
 	setOptFunction _setopt = nullptr;
 	slistAppendFunction _slistAppend = nullptr;
+	slistFreeAllFunction _slistFreeAll = nullptr;
 	performFunction _perform = nullptr;
+	getInfoFunction _getinfo = nullptr;
 	cleanupFunction _cleanup = nullptr;
+	resetFunction _reset = nullptr;
 	errorFunction _error = nullptr;
-	CURL *_curl = nullptr;
+	shareInitFunction _shareInit = nullptr;
+	shareSetOptFunction _shareSetopt = nullptr;
+	shareCleanupFunction _shareCleanup = nullptr;
+
+	std::mutex _mutex;
+	std::vector<CURL *> _handles;
+	std::vector<CURL *> _idleHandles;
+	CURLSH *_share = nullptr;
 	QLibrary *_lib;
 	std::atomic_bool _initialized = {false};
 };
@@ -53,7 +86,11 @@ inline CURLcode CurlHelper::SetOpt(CURLoption option, Args... args)
 	if (!curl._initialized) {
 		return CURLE_FAILED_INIT;
 	}
-	return curl._setopt(curl._curl, option, args...);
+	auto handle = curl.GetHandle();
+	if (!handle) {
+		return CURLE_FAILED_INIT;
+	}
+	return curl._setopt(handle, option, args...);
 }
 
 } // namespace advss
@@ -0,0 +1,313 @@
+#include "file-content-cache.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <unordered_map>
+
+namespace advss {
+
+namespace {
+
+struct CacheEntry {
+	// Serializes reading the file
+	std::mutex mutex;
+	std::shared_ptr<std::string> data;
+	uint64_t hash = 0;
+	// Size and modification date of the file when it was last read
+	int64_t size = -1;
+	QDateTime lastModified;
+	// The last few bytes of the file are used to check if the previously
+	// read data is still unchanged when data was appended to the file
+	std::string rawTail;
+	std::atomic_bool modified = {true};
+	std::chrono::steady_clock::time_point lastAccess;
+};
+
+} // namespace
+
+using Clock = std::chrono::steady_clock;
+
+// Entries of files, which were not requested for a while, are discarded to
+// free the memory used for their content
+static constexpr auto maxUnusedTime = std::chrono::minutes(1);
+static constexpr size_t rawTailSize = 64;
+static constexpr uint64_t hashSeed = 14695981039346656037ULL;
+
+static std::mutex mutex;
+static std::unordered_map<std::string, std::shared_ptr<CacheEntry>> entries;
+static Clock::time_point lastCleanup;
+static QFileSystemWatcher *watcher = nullptr;
+
+static void markModified(const QString &path)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = entries.find(path.toStdString());
+	if (it == entries.end()) {
+		return;
+	}
+	it->second->modified = true;
+
+	// Files replaced by a new file, as many applications do when saving,
+	// are no longer watched
+	if (watcher && !watcher->files().contains(path) &&
+	    QFile::exists(path)) {
+		watcher->addPath(path);
+	}
+}
+
+static bool setup()
+{
+	AddPluginInitStep([]() {
+		watcher = new QFileSystemWatcher();
+		QObject::connect(watcher, &QFileSystemWatcher::fileChanged,
+				 markModified);
+	});
+	AddPluginCleanupStep([]() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			entries.clear();
+		}
+		delete watcher;
+		watcher = nullptr;
+	});
+	return true;
+}
+
+static bool setupDone = setup();
+
+// The watcher lives on the main thread, so it is only accessed from there
+static void watch(const std::string &path, bool add)
+{
+	if (!watcher) {
+		return;
+	}
+	QMetaObject::invokeMethod(
+		watcher,
+		[path, add]() {
+			if (!watcher) {
+				return;
+			}
+			const auto qpath = QString::fromStdString(path);
+			if (add) {
+				watcher->addPath(qpath);
+			} else {
+				watcher->removePath(qpath);
+			}
+		},
+		Qt::QueuedConnection);
+}
+
+static void removeUnusedEntries(Clock::time_point now)
+{
+	if (now - lastCleanup < maxUnusedTime) {
+		return;
+	}
+	lastCleanup = now;
+
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (now - it->second->lastAccess > maxUnusedTime) {
+			watch(it->first, false);
+			it = entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+static std::shared_ptr<CacheEntry> getEntry(const std::string &path)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto now = Clock::now();
+	removeUnusedEntries(now);
+
+	auto &entry = entries[path];
+	if (!entry) {
+		entry = std::make_shared<CacheEntry>();
+		watch(path, true);
+	}
+	entry->lastAccess = now;
+	return entry;
+}
+
+static uint64_t updateHash(uint64_t hash, const std::string &data)
+{
+	for (const char c : data) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static void appendNormalized(std::string &target, const std::string &data)
+{
+	target.reserve(target.size() + data.size());
+	for (const char c : data) {
+		if (c == '\n' && !target.empty() && target.back() == '\r') {
+			target.back() = '\n';
+			continue;
+		}
+		target.push_back(c);
+	}
+}
+
+static bool read(QFile &file, int64_t size, std::string &data)
+{
+	data.resize(static_cast<size_t>(size));
+	if (size == 0) {
+		return true;
+	}
+	const auto bytesRead = file.read(data.data(), size);
+	if (bytesRead < 0) {
+		return false;
+	}
+	data.resize(static_cast<size_t>(bytesRead));
+	return true;
+}
+
+static void updateRawTail(CacheEntry &entry, const std::string &data)
+{
+	if (data.size() >= rawTailSize) {
+		entry.rawTail = data.substr(data.size() - rawTailSize);
+		return;
+	}
+	entry.rawTail += data;
+	if (entry.rawTail.size() > rawTailSize) {
+		entry.rawTail.erase(0, entry.rawTail.size() - rawTailSize);
+	}
+}
+
+static bool readAppendedData(CacheEntry &entry, QFile &file, int64_t size)
+{
+	if (!entry.data || size <= entry.size ||
+	    entry.size < static_cast<int64_t>(entry.rawTail.size())) {
+		return false;
+	}
+
+	const int64_t tailStart = entry.size - entry.rawTail.size();
+	std::string data;
+	if (!file.seek(tailStart) || !read(file, size - tailStart, data) ||
+	    data.compare(0, entry.rawTail.size(), entry.rawTail) != 0) {
+		return false;
+	}
+	data.erase(0, entry.rawTail.size());
+
+	// The previous content might still be used by other threads
+	if (entry.data.use_count() > 1) {
+		entry.data = std::make_shared<std::string>(*entry.data);
+	}
+	appendNormalized(*entry.data, data);
+	entry.hash = updateHash(entry.hash, data);
+	entry.size += data.size();
+	updateRawTail(entry, data);
+	return true;
+}
+
+static bool readAllData(CacheEntry &entry, QFile &file, int64_t size)
+{
+	std::string data;
+	if (!file.seek(0) || !read(file, size, data)) {
+		return false;
+	}
+
+	auto content = std::make_shared<std::string>();
+	appendNormalized(*content, data);
+	entry.data = content;
+	entry.hash = updateHash(hashSeed, data);
+	entry.size = data.size();
+	entry.rawTail.clear();
+	updateRawTail(entry, data);
+	return true;
+}
+
+std::optional<FileContent> GetFileContent(const std::string &path)
+{
+	auto entry = getEntry(path);
+	std::lock_guard<std::mutex> lock(entry->mutex);
+
+	const auto qpath = QString::fromStdString(path);
+	const QFileInfo info(qpath);
+	if (!info.isFile()) {
+		entry->data.reset();
+		return {};
+	}
+
+	const auto size = info.size();
+	const auto lastModified = info.lastModified();
+	const bool modified = entry->modified.exchange(false);
+	if (entry->data && !modified && size == entry->size &&
+	    lastModified == entry->lastModified) {
+		return FileContent{entry->data, entry->hash};
+	}
+
+	QFile file(qpath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		entry->data.reset();
+		return {};
+	}
+
+	if (!readAppendedData(*entry, file, size) &&
+	    !readAllData(*entry, file, size)) {
+		entry->data.reset();
+		return {};
+	}
+	entry->lastModified = lastModified;
+	return FileContent{entry->data, entry->hash};
+}
+
+bool ReadNewFileLines(const std::string &path, FileTailPosition &position,
+		      std::vector<std::string> &lines)
+{
+	const auto qpath = QString::fromStdString(path);
+	const QFileInfo info(qpath);
+	if (!info.isFile()) {
+		return false;
+	}
+
+	const int64_t size = info.size();
+	if (position.path != path || position.offset < 0) {
+		position.path = path;
+		position.offset = size;
+		return true;
+	}
+
+	if (size < position.offset) {
+		position.offset = 0;
+	}
+	if (size == position.offset) {
+		return true;
+	}
+
+	QFile file(qpath);
+	std::string data;
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(position.offset) ||
+	    !read(file, size - position.offset, data)) {
+		return false;
+	}
+
+	// Incomplete lines will be read on one of the next calls
+	const auto end = data.rfind('\n');
+	if (end == std::string::npos) {
+		return true;
+	}
+	position.offset += end + 1;
+
+	size_t start = 0;
+	while (start <= end) {
+		auto lineEnd = data.find('\n', start);
+		auto line = data.substr(start, lineEnd - start);
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		lines.emplace_back(std::move(line));
+		start = lineEnd + 1;
+	}
+	return true;
+}
+
+} // namespace advss
@@ -0,0 +1,43 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace advss {
+
+struct FileContent {
+	// Windows line endings are converted to "\n"
+	std::shared_ptr<const std::string> data;
+	// Hash of the raw file content, which changes whenever the file
+	// content changes
+	uint64_t hash = 0;
+};
+
+// Returns the content of the given local file, or an empty optional if the
+// file cannot be read.
+//
+// The content is shared by all callers and only read again once the file was
+// modified, which is detected using a file system watcher and by comparing
+// the size and modification date of the file.
+// If data was only appended to the file, only the appended data is read.
+EXPORT std::optional<FileContent> GetFileContent(const std::string &path);
+
+// Position up to which the lines of a file were already read
+struct FileTailPosition {
+	std::string path;
+	int64_t offset = -1;
+};
+
+// Appends the complete lines, which were added to the end of the file since
+// the last call using the given position, to the given vector.
+// The first call for a path only determines the end of the file.
+// If the file was truncated it is read from the start again.
+// Returns false if the file cannot be read.
+EXPORT bool ReadNewFileLines(const std::string &path, FileTailPosition &,
+			     std::vector<std::string> &lines);
+
+} // namespace advss
@@ -0,0 +1,328 @@
+#include "frame-capture.hpp"
+#include "log-helper.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <graphics/vec4.h>
+#include <map>
+#include <mutex>
+
+namespace advss {
+
+using Clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+// Graphics resources used to capture frames of a single source.
+//
+// Two stage surfaces are used alternately, so a new frame can be rendered and
+// staged while the previous one is being read back.
+struct CaptureTarget {
+	OBSWeakSource source;
+	bool isMainOutput = false;
+
+	gs_texrender_t *texrender = nullptr;
+	std::array<gs_stagesurf_t *, 2> stagesurfs = {nullptr, nullptr};
+	std::array<uint32_t, 2> stagedWidth = {0, 0};
+	std::array<uint32_t, 2> stagedHeight = {0, 0};
+	int stagedIdx = -1;
+	int nextIdx = 0;
+
+	bool captureRequested = false;
+	std::shared_ptr<const CapturedFrame> frame;
+	Clock::time_point lastRequest;
+};
+
+} // namespace
+
+static std::mutex mutex;
+static std::condition_variable cv;
+static std::map<obs_weak_source_t *, CaptureTarget> targets;
+static std::atomic_bool tickCallbackRegistered = {false};
+
+// Targets which were not used for this long will release their resources
+static constexpr auto targetExpiration = std::chrono::seconds(10);
+
+static void destroyResources(CaptureTarget &target)
+{
+	for (auto &stagesurf : target.stagesurfs) {
+		gs_stagesurface_destroy(stagesurf);
+		stagesurf = nullptr;
+	}
+	gs_texrender_destroy(target.texrender);
+	target.texrender = nullptr;
+}
+
+static bool getSourceSize(CaptureTarget &target, OBSSource &source,
+			  uint32_t &cx, uint32_t &cy)
+{
+	if (target.isMainOutput) {
+		obs_video_info ovi;
+		obs_get_video_info(&ovi);
+		cx = ovi.base_width;
+		cy = ovi.base_height;
+		return true;
+	}
+
+	source = OBSGetStrongRef(target.source);
+	if (!source) {
+		return false;
+	}
+	cx = obs_source_get_base_width(source);
+	cy = obs_source_get_base_height(source);
+	return true;
+}
+
+static bool render(CaptureTarget &target)
+{
+	OBSSource source;
+	uint32_t cx = 0, cy = 0;
+	if (!getSourceSize(target, source, cx, cy) || cx == 0 || cy == 0) {
+		return false;
+	}
+
+	auto &stagesurf = target.stagesurfs[target.nextIdx];
+	if (stagesurf && (gs_stagesurface_get_width(stagesurf) != cx ||
+			  gs_stagesurface_get_height(stagesurf) != cy)) {
+		gs_stagesurface_destroy(stagesurf);
+		stagesurf = nullptr;
+	}
+	if (!stagesurf) {
+		stagesurf = gs_stagesurface_create(cx, cy, GS_RGBA);
+	}
+	if (!target.texrender) {
+		target.texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	}
+
+	gs_texrender_reset(target.texrender);
+	if (!gs_texrender_begin(target.texrender, cx, cy)) {
+		return false;
+	}
+
+	vec4 zero;
+	vec4_zero(&zero);
+	gs_clear(GS_CLEAR_COLOR, &zero, 0.0f, 0);
+	gs_ortho(0.0f, (float)cx, 0.0f, (float)cy, -100.0f, 100.0f);
+
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+
+	if (source) {
+		obs_source_inc_showing(source);
+		obs_source_video_render(source);
+		obs_source_dec_showing(source);
+	} else {
+		obs_render_main_texture();
+	}
+
+	gs_blend_state_pop();
+	gs_texrender_end(target.texrender);
+
+	gs_stage_texture(stagesurf,
+			 gs_texrender_get_texture(target.texrender));
+	target.stagedWidth[target.nextIdx] = cx;
+	target.stagedHeight[target.nextIdx] = cy;
+	target.stagedIdx = target.nextIdx;
+	target.nextIdx = (target.nextIdx + 1) % 2;
+	return true;
+}
+
+static QImage readBack(CaptureTarget &target)
+{
+	const int idx = target.stagedIdx;
+	target.stagedIdx = -1;
+
+	auto stagesurf = target.stagesurfs[idx];
+	const int cx = target.stagedWidth[idx];
+	const int cy = target.stagedHeight[idx];
+	uint8_t *data = nullptr;
+	uint32_t linesize = 0;
+	if (!stagesurf || !gs_stagesurface_map(stagesurf, &data, &linesize)) {
+		return QImage();
+	}
+
+	QImage image(cx, cy, QImage::Format::Format_RGBA8888);
+	if ((uint32_t)image.bytesPerLine() == linesize) {
+		memcpy(image.bits(), data, (size_t)linesize * cy);
+	} else {
+		const auto rowSize = std::min<size_t>(image.bytesPerLine(),
+						      linesize);
+		for (int y = 0; y < cy; y++) {
+			memcpy(image.scanLine(y), data + (y * linesize),
+			       rowSize);
+		}
+	}
+	gs_stagesurface_unmap(stagesurf);
+	return image;
+}
+
+static void publishFrame(CaptureTarget &target, QImage &&image)
+{
+	auto frame = std::make_shared<CapturedFrame>();
+	frame->image = std::move(image);
+	frame->time = Clock::now();
+	target.frame = frame;
+}
+
+static void captureTick(void *, float)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto now = Clock::now();
+	bool publishedFrames = false;
+
+	obs_enter_graphics();
+	for (auto it = targets.begin(); it != targets.end();) {
+		auto &target = it->second;
+
+		// Frames staged during the last tick should be ready by now
+		if (target.stagedIdx != -1) {
+			publishFrame(target, readBack(target));
+			publishedFrames = true;
+		}
+
+		if (target.captureRequested) {
+			target.captureRequested = false;
+			if (!render(target)) {
+				publishFrame(target, QImage());
+				publishedFrames = true;
+			}
+		}
+
+		const bool isExpired = target.stagedIdx == -1 &&
+				       now - target.lastRequest >
+					       targetExpiration;
+		if (isExpired) {
+			destroyResources(target);
+			it = targets.erase(it);
+		} else {
+			++it;
+		}
+	}
+	obs_leave_graphics();
+
+	if (publishedFrames) {
+		cv.notify_all();
+	}
+}
+
+static void cleanup()
+{
+	// The tick callbacks are removed while holding a libobs internal lock,
+	// which is also held while captureTick() acquires the mutex
+	if (tickCallbackRegistered.exchange(false)) {
+		obs_remove_tick_callback(captureTick, nullptr);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	obs_enter_graphics();
+	for (auto &entry : targets) {
+		destroyResources(entry.second);
+	}
+	obs_leave_graphics();
+	targets.clear();
+	cv.notify_all();
+}
+
+static bool setup()
+{
+	AddPluginCleanupStep(cleanup);
+	return true;
+}
+
+static bool setupDone = setup();
+
+static bool isSuitable(const std::shared_ptr<const CapturedFrame> &frame,
+		       Clock::time_point notBefore)
+{
+	return frame && frame->time >= notBefore;
+}
+
+std::shared_ptr<const CapturedFrame>
+GetCapturedFrame(obs_source_t *source, Clock::time_point notBefore,
+		 bool blocking, std::chrono::milliseconds timeout)
+{
+	const OBSWeakSource weakSource = OBSGetWeakRef(source);
+	obs_weak_source_t *key = weakSource;
+
+	// Must not be done while holding the mutex, as the tick callbacks are
+	// added while holding a libobs internal lock, which is also held while
+	// captureTick() acquires the mutex
+	if (!tickCallbackRegistered.exchange(true)) {
+		obs_add_tick_callback(captureTick, nullptr);
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	auto it = targets.find(key);
+	if (it == targets.end()) {
+		CaptureTarget target;
+		target.source = weakSource;
+		target.isMainOutput = !source;
+		it = targets.emplace(key, std::move(target)).first;
+	}
+
+	auto &target = it->second;
+	target.lastRequest = Clock::now();
+	if (isSuitable(target.frame, notBefore)) {
+		return target.frame;
+	}
+
+	target.captureRequested = true;
+	if (!blocking) {
+		return nullptr;
+	}
+
+	const bool captured = cv.wait_for(lock, timeout, [&]() {
+		auto entry = targets.find(key);
+		return entry == targets.end() ||
+		       isSuitable(entry->second.frame, notBefore);
+	});
+
+	it = targets.find(key);
+	if (!captured || it == targets.end()) {
+		if (source) {
+			blog(LOG_WARNING,
+			     "Failed to capture frame in time for source %s",
+			     obs_source_get_name(source));
+		} else {
+			blog(LOG_WARNING, "Failed to capture frame in time");
+		}
+		return nullptr;
+	}
+	return it->second.frame;
+}
+
+static void releaseFrame(void *frame)
+{
+	delete static_cast<std::shared_ptr<const CapturedFrame> *>(frame);
+}
+
+QImage GetCapturedFrameArea(const std::shared_ptr<const CapturedFrame> &frame,
+			    const QRect &area)
+{
+	if (!frame || frame->image.isNull()) {
+		return QImage();
+	}
+
+	const auto &image = frame->image;
+	QRect viewArea = image.rect();
+	if (!area.isEmpty()) {
+		viewArea &= area;
+	}
+	if (viewArea.isEmpty()) {
+		return QImage();
+	}
+
+	// The view holds a reference to the frame, which is released once
+	// the view and all of its copies are destroyed
+	const uchar *data = image.constScanLine(viewArea.top()) +
+			    viewArea.left() * 4;
+	return QImage(data, viewArea.width(), viewArea.height(),
+		      image.bytesPerLine(), image.format(), releaseFrame,
+		      new std::shared_ptr<const CapturedFrame>(frame));
+}
+
+} // namespace advss
@@ -0,0 +1,42 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <chrono>
+#include <memory>
+#include <obs.hpp>
+#include <QImage>
+#include <QRect>
+
+namespace advss {
+
+// Immutable frame of a source captured by the frame capture service.
+//
+// The image uses Format_RGBA8888 and is null if the source could not be
+// rendered.
+struct CapturedFrame {
+	QImage image;
+	std::chrono::high_resolution_clock::time_point time;
+};
+
+// Returns a frame of the given source, which was captured at or after
+// notBefore, or nullptr if no such frame is available.
+// Pass nullptr as the source to capture the main output.
+//
+// If no suitable frame is available, a new frame will be captured.
+// Each source is rendered and read back at most once per OBS frame,
+// no matter how many consumers are requesting frames of it.
+// If blocking is set, the call will wait up to timeout for the new frame.
+// Otherwise the new frame will be returned by one of the next calls.
+EXPORT std::shared_ptr<const CapturedFrame>
+GetCapturedFrame(obs_source_t *source,
+		 std::chrono::high_resolution_clock::time_point notBefore,
+		 bool blocking = false,
+		 std::chrono::milliseconds timeout = std::chrono::seconds(1));
+
+// Returns a read-only view of the given area of the frame without copying the
+// image data. The view keeps the frame alive.
+// An empty area will return a view of the whole frame.
+EXPORT QImage GetCapturedFrameArea(const std::shared_ptr<const CapturedFrame> &,
+				   const QRect &area = QRect());
+
+} // namespace advss
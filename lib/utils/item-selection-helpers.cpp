@@ -4,6 +4,7 @@
 #include "ui-helpers.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <QAction>
 #include <QMenu>
 #include <QLayout>
@@ -12,8 +13,41 @@ Q_DECLARE_METATYPE(advss::Item *);
 
 namespace advss {
 
+static std::atomic_uint64_t itemNameGeneration = 0;
+
 Item::Item(std::string name) : _name(name) {}
 
+Item &Item::operator=(const Item &other)
+{
+	SetName(other._name);
+	return *this;
+}
+
+Item::~Item()
+{
+	++itemNameGeneration;
+	SaveDataCache::InvalidateAll();
+}
+
+void Item::SetName(const std::string &name)
+{
+	_name = name;
+	++itemNameGeneration;
+	SettingsModified();
+	// Other objects referring to this item save its name
+	SaveDataCache::InvalidateAll();
+}
+
+obs_data_t *Item::GetSaveData() const
+{
+	return _saveDataCache.Get([this](obs_data_t *data) { Save(data); });
+}
+
+uint64_t GetItemNameGeneration()
+{
+	return itemNameGeneration;
+}
+
 static Item *GetItemByName(const std::string &name,
 			   std::deque<std::shared_ptr<Item>> &items)
 {
@@ -199,7 +233,7 @@ void ItemSelection::RenameItem()
 	}
 
 	const auto oldName = item->_name;
-	item->_name = name;
+	item->SetName(name);
 	SetItem(name);
 	emit ItemRenamed(QString::fromStdString(oldName),
 			 QString::fromStdString(name));
@@ -344,7 +378,7 @@ void ItemSettingsDialog::SetNameWarning(const QString warn)
 
 void Item::Load(obs_data_t *obj)
 {
-	_name = obs_data_get_string(obj, "name");
+	SetName(obs_data_get_string(obj, "name"));
 }
 
 void Item::Save(obs_data_t *obj) const
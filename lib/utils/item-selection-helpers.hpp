@@ -1,6 +1,7 @@
 #pragma once
 #include "filter-combo-box.hpp"
 #include "export-symbol-helper.hpp"
+#include "save-data-cache.hpp"
 
 #include <QPushButton>
 #include <QDialog>
@@ -19,19 +20,35 @@ class EXPORT Item {
 public:
 	Item(std::string name);
 	Item() = default;
-	virtual ~Item() = default;
+	Item(const Item &) = default;
+	Item &operator=(const Item &);
+	virtual ~Item();
 
 	virtual void Load(obs_data_t *obj);
 	virtual void Save(obs_data_t *obj) const;
 	std::string Name() const { return _name; }
+	// Returns the settings as written by Save(), which are only recreated
+	// if the item was modified since they were last requested.
+	// The returned reference has to be released by the caller.
+	obs_data_t *GetSaveData() const;
 
 protected:
+	void SetName(const std::string &name);
+	// Has to be called whenever settings written by Save() were modified
+	void SettingsModified() { _saveDataCache.Invalidate(); }
+
 	std::string _name = "";
 
+private:
+	mutable SaveDataCache _saveDataCache;
+
 	friend ItemSelection;
 	friend ItemSettingsDialog;
 };
 
+// Incremented whenever an item is renamed or destroyed
+uint64_t EXPORT GetItemNameGeneration();
+
 void EXPORT RemoveItemsByName(std::deque<std::shared_ptr<Item>> &items,
 			      const QStringList &names);
 
@@ -99,4 +99,192 @@ std::optional<std::string> AccessJsonArrayIndex(const std::string &jsonStr,
 	return {};
 }
 
+static std::string formatJson(const std::string &json)
+{
+	auto formatted = FormatJsonString(json).toStdString();
+	return formatted.empty() ? json : formatted;
+}
+
+void JsonMatcher::Update(const std::string &expected)
+{
+	if (_parsed && expected == _expectedText) {
+		return;
+	}
+
+	auto json = nlohmann::json::parse(expected, nullptr, false);
+	if (json.is_discarded()) {
+		_expected.reset();
+	} else {
+		_expected = std::make_shared<const nlohmann::json>(
+			std::move(json));
+	}
+	_formattedExpected = formatJson(expected);
+	_expectedText = expected;
+	_parsed = true;
+}
+
+bool JsonMatcher::MatchText(const std::string &actual,
+			    const RegexConfig &regex) const
+{
+	const auto formatted = formatJson(actual);
+	if (regex.Enabled()) {
+		return regex.Matches(formatted, _formattedExpected);
+	}
+	return formatted == _formattedExpected;
+}
+
+static bool matchInt(long long actual, const nlohmann::json &expected)
+{
+	if (expected.is_number_integer()) {
+		return expected.get<long long>() == actual;
+	}
+	return expected.is_number() &&
+	       expected.get<double>() == static_cast<double>(actual);
+}
+
+static bool matchDouble(double actual, const nlohmann::json &expected)
+{
+	return expected.is_number() && expected.get<double>() == actual;
+}
+
+bool JsonMatcher::MatchValue(const nlohmann::json &actual,
+			     const nlohmann::json &expected) const
+{
+	switch (actual.type()) {
+	case nlohmann::json::value_t::string:
+		return expected.is_string() &&
+		       actual.get_ref<const std::string &>() ==
+			       expected.get_ref<const std::string &>();
+	case nlohmann::json::value_t::number_integer:
+	case nlohmann::json::value_t::number_unsigned:
+		return matchInt(actual.get<long long>(), expected);
+	case nlohmann::json::value_t::number_float:
+		return matchDouble(actual.get<double>(), expected);
+	case nlohmann::json::value_t::object: {
+		if (!expected.is_object() || actual.size() != expected.size()) {
+			return false;
+		}
+		for (auto it = actual.begin(); it != actual.end(); ++it) {
+			auto expectedValue = expected.find(it.key());
+			if (expectedValue == expected.end() ||
+			    !MatchValue(it.value(), *expectedValue)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	case nlohmann::json::value_t::array: {
+		if (!expected.is_array() || actual.size() != expected.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < actual.size(); i++) {
+			if (!MatchValue(actual[i], expected[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+	default:
+		return actual == expected;
+	}
+}
+
+bool JsonMatcher::MatchItem(obs_data_item_t *actual,
+			    const nlohmann::json &expected) const
+{
+	switch (obs_data_item_gettype(actual)) {
+	case OBS_DATA_STRING: {
+		const char *value = obs_data_item_get_string(actual);
+		return expected.is_string() &&
+		       expected.get_ref<const std::string &>() ==
+			       (value ? value : "");
+	}
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(actual) == OBS_DATA_NUM_INT) {
+			return matchInt(obs_data_item_get_int(actual),
+					expected);
+		}
+		return matchDouble(obs_data_item_get_double(actual), expected);
+	case OBS_DATA_BOOLEAN:
+		return expected.is_boolean() &&
+		       expected.get<bool>() == obs_data_item_get_bool(actual);
+	case OBS_DATA_OBJECT: {
+		obs_data_t *obj = obs_data_item_get_obj(actual);
+		const bool ret = MatchObject(obj, expected);
+		obs_data_release(obj);
+		return ret;
+	}
+	case OBS_DATA_ARRAY: {
+		obs_data_array_t *array = obs_data_item_get_array(actual);
+		const size_t count = obs_data_array_count(array);
+		bool ret = expected.is_array() && count == expected.size();
+		for (size_t i = 0; ret && i < count; i++) {
+			obs_data_t *item = obs_data_array_item(array, i);
+			ret = MatchObject(item, expected[i]);
+			obs_data_release(item);
+		}
+		obs_data_array_release(array);
+		return ret;
+	}
+	default:
+		return expected.is_null();
+	}
+}
+
+bool JsonMatcher::MatchObject(obs_data_t *actual,
+			      const nlohmann::json &expected) const
+{
+	if (!expected.is_object()) {
+		return false;
+	}
+
+	// Only values differing from the defaults are part of the JSON
+	// representation of obs_data objects, so all others are skipped
+	size_t count = 0;
+	for (obs_data_item_t *item = obs_data_first(actual); item;
+	     obs_data_item_next(&item)) {
+		if (!obs_data_item_has_user_value(item)) {
+			continue;
+		}
+		const char *name = obs_data_item_get_name(item);
+		auto expectedValue = expected.find(name);
+		if (expectedValue == expected.end() ||
+		    !MatchItem(item, *expectedValue)) {
+			obs_data_item_release(&item);
+			return false;
+		}
+		++count;
+	}
+	return count == expected.size();
+}
+
+bool JsonMatcher::Matches(const std::string &json, const std::string &expected,
+			  const RegexConfig &regex)
+{
+	Update(expected);
+	if (regex.Enabled() || !_expected) {
+		return MatchText(json, regex);
+	}
+	auto actual = nlohmann::json::parse(json, nullptr, false);
+	if (actual.is_discarded()) {
+		return MatchText(json, regex);
+	}
+	return MatchValue(actual, *_expected);
+}
+
+bool JsonMatcher::Matches(obs_data_t *data, const std::string &expected,
+			  const RegexConfig &regex)
+{
+	if (!data) {
+		return false;
+	}
+	Update(expected);
+	if (regex.Enabled() || !_expected) {
+		const char *json = obs_data_get_json(data);
+		return MatchText(json ? json : "", regex);
+	}
+	return MatchObject(data, *_expected);
+}
+
 } // namespace advss
+
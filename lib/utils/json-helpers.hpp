@@ -2,6 +2,9 @@
 #include "export-symbol-helper.hpp"
 #include "regex-config.hpp"
 
+#include <memory>
+#include <nlohmann/json_fwd.hpp>
+#include <obs-data.h>
 #include <QString>
 #include <string>
 
@@ -18,4 +21,47 @@ EXPORT std::optional<std::string> QueryJson(const std::string &json,
 EXPORT std::optional<std::string> AccessJsonArrayIndex(const std::string &json,
 						       const int index);
 
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+// Matches JSON documents or obs_data objects against an expected JSON
+// document without serializing and formatting them first.
+// The expected document is only parsed again once it changes.
+//
+// If regular expressions are enabled or the expected document is not valid
+// JSON, the formatted documents are compared like MatchJson() does, as the
+// expression might cover keys, numbers or multiple values.
+//
+// Not thread safe.
+class EXPORT JsonMatcher {
+public:
+	bool Matches(const std::string &json, const std::string &expected,
+		     const RegexConfig &);
+	bool Matches(obs_data_t *, const std::string &expected,
+		     const RegexConfig &);
+
+private:
+	void Update(const std::string &expected);
+	bool MatchText(const std::string &actual, const RegexConfig &) const;
+
+	bool MatchValue(const nlohmann::json &actual,
+			const nlohmann::json &expected) const;
+	bool MatchObject(obs_data_t *actual,
+			 const nlohmann::json &expected) const;
+	bool MatchItem(obs_data_item_t *actual,
+		       const nlohmann::json &expected) const;
+
+	std::string _expectedText;
+	bool _parsed = false;
+	// Null if the expected document is not valid JSON
+	std::shared_ptr<const nlohmann::json> _expected;
+	std::string _formattedExpected;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
 } // namespace advss
@@ -0,0 +1,123 @@
+#include "latency-histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace advss {
+
+static int getMostSignificantBit(uint64_t value)
+{
+	int msb = 0;
+	while (value >>= 1) {
+		++msb;
+	}
+	return msb;
+}
+
+size_t LatencyHistogram::GetBucketIdx(uint64_t value)
+{
+	value = std::min(value, (uint64_t(1) << _maxExponent) - 1);
+	if (value < _subBucketCount) {
+		return static_cast<size_t>(value);
+	}
+
+	const int exponent = getMostSignificantBit(value);
+	const int shift = exponent - _subBucketBits;
+	const uint64_t subBucket = (value >> shift) & (_subBucketCount - 1);
+	return static_cast<size_t>(_subBucketCount + shift * _subBucketCount +
+				   subBucket);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t idx)
+{
+	if (idx < _subBucketCount) {
+		return idx;
+	}
+
+	const uint64_t shift = (idx - _subBucketCount) / _subBucketCount;
+	const uint64_t subBucket = (idx - _subBucketCount) % _subBucketCount;
+	const uint64_t lowerBound = (uint64_t(1) << (shift + _subBucketBits)) +
+				    (subBucket << shift);
+	return lowerBound + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds duration)
+{
+	const auto us =
+		std::chrono::duration_cast<std::chrono::microseconds>(duration)
+			.count();
+	const uint64_t value = us > 0 ? static_cast<uint64_t>(us) : 0;
+
+	_buckets[GetBucketIdx(value)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+
+	uint64_t currentMax = _max.load(std::memory_order_relaxed);
+	while (value > currentMax &&
+	       !_max.compare_exchange_weak(currentMax, value,
+					   std::memory_order_relaxed)) {
+	}
+}
+
+void LatencyHistogram::Reset()
+{
+	for (auto &bucket : _buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	_count.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Count() const
+{
+	return _count.load(std::memory_order_relaxed);
+}
+
+std::chrono::microseconds LatencyHistogram::Max() const
+{
+	return std::chrono::microseconds(_max.load(std::memory_order_relaxed));
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(double percentile) const
+{
+	// Buckets might be modified while iterating over them, so the total
+	// is calculated from the buckets themselves instead of using _count
+	std::array<uint64_t, _bucketCount> counts;
+	uint64_t total = 0;
+	for (size_t i = 0; i < _bucketCount; i++) {
+		counts[i] = _buckets[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+	if (total == 0) {
+		return std::chrono::microseconds(0);
+	}
+
+	percentile = std::clamp(percentile, 0.0, 100.0);
+	const auto target = std::max<uint64_t>(
+		1, static_cast<uint64_t>(
+			   std::ceil(percentile / 100.0 * (double)total)));
+	uint64_t seen = 0;
+	for (size_t i = 0; i < _bucketCount; i++) {
+		seen += counts[i];
+		if (seen >= target) {
+			// The upper bound of the bucket might exceed the largest
+			// value which was actually recorded
+			return std::min(std::chrono::microseconds(
+						GetBucketUpperBound(i)),
+					Max());
+		}
+	}
+	return Max();
+}
+
+LatencyHistogram::Summary LatencyHistogram::GetSummary() const
+{
+	Summary summary;
+	summary.count = Count();
+	summary.p50 = Percentile(50.0);
+	summary.p95 = Percentile(95.0);
+	summary.p99 = Percentile(99.0);
+	summary.max = Max();
+	return summary;
+}
+
+} // namespace advss
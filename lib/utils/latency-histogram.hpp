@@ -0,0 +1,89 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace advss {
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+// Lock free histogram of durations using log-linear buckets.
+//
+// Each power of two range is split into a fixed number of linear sub-buckets,
+// so the relative error of the reported percentiles is bounded (12.5%)
+// independent of the magnitude of the recorded values.
+//
+// Recording can be performed concurrently from any thread.
+class EXPORT LatencyHistogram {
+public:
+	struct Summary {
+		uint64_t count = 0;
+		std::chrono::microseconds p50{0};
+		std::chrono::microseconds p95{0};
+		std::chrono::microseconds p99{0};
+		std::chrono::microseconds max{0};
+	};
+
+	LatencyHistogram() = default;
+	LatencyHistogram(const LatencyHistogram &) = delete;
+	LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+	void Record(std::chrono::nanoseconds);
+	void Reset();
+
+	uint64_t Count() const;
+	std::chrono::microseconds Max() const;
+	// Percentile has to be in the range [0, 100]
+	std::chrono::microseconds Percentile(double) const;
+	Summary GetSummary() const;
+
+private:
+	static constexpr int _subBucketBits = 3;
+	static constexpr uint64_t _subBucketCount = 1 << _subBucketBits;
+	// Durations longer than 2^40 us (~12 days) are clamped
+	static constexpr int _maxExponent = 40;
+	static constexpr size_t _bucketCount =
+		_subBucketCount +
+		(_maxExponent - _subBucketBits) * _subBucketCount;
+
+	static size_t GetBucketIdx(uint64_t value);
+	static uint64_t GetBucketUpperBound(size_t idx);
+
+	std::array<std::atomic<uint64_t>, _bucketCount> _buckets{};
+	std::atomic<uint64_t> _count = {0};
+	std::atomic<uint64_t> _max = {0};
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+// Records the lifetime of the object in the given histogram
+class ScopedLatencyRecorder {
+public:
+	explicit ScopedLatencyRecorder(LatencyHistogram &histogram)
+		: _histogram(histogram),
+		  _start(std::chrono::high_resolution_clock::now())
+	{
+	}
+	~ScopedLatencyRecorder()
+	{
+		_histogram.Record(std::chrono::high_resolution_clock::now() -
+				  _start);
+	}
+	ScopedLatencyRecorder(const ScopedLatencyRecorder &) = delete;
+	ScopedLatencyRecorder &
+	operator=(const ScopedLatencyRecorder &) = delete;
+
+private:
+	LatencyHistogram &_histogram;
+	const std::chrono::high_resolution_clock::time_point _start;
+};
+
+} // namespace advss
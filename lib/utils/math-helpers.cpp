@@ -3,36 +3,201 @@
 
 #include <climits>
 #include <exprtk.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <unordered_map>
 
 namespace advss {
 
-std::variant<double, std::string> EvalMathExpression(const std::string &expr)
+static double getRandomValue()
 {
-	static bool setupDone = false;
-	static exprtk::symbol_table<double> symbolTable;
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
-	static std::uniform_real_distribution<double> dis(0.0, 1.0);
-	static auto randomFunc = []() {
-		return dis(gen);
-	};
-
-	if (!setupDone) {
-		symbolTable.add_function("random", randomFunc);
-		setupDone = true;
-	}
+	thread_local std::mt19937 gen(std::random_device{}());
+	std::uniform_real_distribution<double> dis(0.0, 1.0);
+	return dis(gen);
+}
+
+namespace {
 
+struct CompiledExpression {
+	std::mutex mutex;
+	exprtk::symbol_table<double> symbolTable;
 	exprtk::expression<double> expression;
-	expression.register_symbol_table(symbolTable);
+	std::vector<double> values;
+	bool valid = false;
+};
+
+// Least recently used compiled expressions keyed by the expression text and
+// the names of the variables bound to it
+class ExpressionCache {
+public:
+	std::shared_ptr<CompiledExpression>
+	Get(const std::string &expression, const MathExpressionVariables &);
+
+private:
+	using Entry =
+		std::pair<std::string, std::shared_ptr<CompiledExpression>>;
+
+	static constexpr size_t _maxSize = 128;
+
+	std::mutex _mutex;
+	std::list<Entry> _entries;
+	std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+};
+
+} // namespace
+
+static std::shared_ptr<CompiledExpression>
+compile(const std::string &expression,
+	const MathExpressionVariables &variables)
+{
+	auto result = std::make_shared<CompiledExpression>();
+	result->symbolTable.add_function("random", getRandomValue);
+
+	// The values are bound by reference, so the vector must not be resized
+	// after this point
+	result->values.resize(variables.size());
+	for (size_t i = 0; i < variables.size(); i++) {
+		result->symbolTable.add_variable(variables[i].first,
+						 result->values[i]);
+	}
+
+	result->expression.register_symbol_table(result->symbolTable);
 	exprtk::parser<double> parser;
+	result->valid = parser.compile(expression, result->expression);
+	return result;
+}
+
+std::shared_ptr<CompiledExpression>
+ExpressionCache::Get(const std::string &expression,
+		     const MathExpressionVariables &variables)
+{
+	std::string key = expression;
+	for (const auto &[name, _] : variables) {
+		key += '\0' + name;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _index.find(key);
+		if (it != _index.end()) {
+			_entries.splice(_entries.begin(), _entries, it->second);
+			return it->second->second;
+		}
+	}
+
+	// Compiling is expensive, so other expressions can still be looked up
+	// in the meantime
+	auto compiled = compile(expression, variables);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _index.find(key);
+	if (it != _index.end()) {
+		return it->second->second;
+	}
+	_entries.emplace_front(key, compiled);
+	_index.emplace(std::move(key), _entries.begin());
+	if (_entries.size() > _maxSize) {
+		_index.erase(_entries.back().first);
+		_entries.pop_back();
+	}
+	return compiled;
+}
+
+std::variant<double, std::string> EvalMathExpression(const std::string &expr)
+{
+	return EvalMathExpression(expr, {});
+}
+
+std::variant<double, std::string>
+EvalMathExpression(const std::string &expr,
+		   const MathExpressionVariables &variables)
+{
+	static ExpressionCache cache;
+	auto compiled = cache.Get(expr, variables);
+	if (!compiled->valid) {
+		return std::string(obs_module_text(
+			       "AdvSceneSwitcher.math.expressionFail")) +
+		       " \"" + expr + "\"";
+	}
+
+	// Evaluating modifies the state of the expression and the values bound
+	// to it, so it cannot be done concurrently
+	std::lock_guard<std::mutex> lock(compiled->mutex);
+	for (size_t i = 0; i < variables.size(); i++) {
+		compiled->values[i] = variables[i].second;
+	}
+	return compiled->expression.value();
+}
+
+static bool isPlainNumber(const std::string &text)
+{
+	// Signs, exponents, and special values like "nan" are not bound, as
+	// e.g. "-3^2" evaluates to -9 while binding -3 would result in 9
+	return !text.empty() &&
+	       text.find_first_not_of("0123456789.") == std::string::npos &&
+	       GetDouble(text).has_value();
+}
+
+static bool isDelimitedBefore(const std::string &expression)
+{
+	const auto pos = expression.find_last_not_of(" \t\n");
+	if (pos == std::string::npos) {
+		return true;
+	}
+	static const std::string delimiters = "+-*/%^(,<>=!&|?:;";
+	return delimiters.find(expression[pos]) != std::string::npos;
+}
+
+static bool isDelimitedAfter(const std::vector<MathExpressionPart> &parts,
+			     size_t idx)
+{
+	static const std::string delimiters = "+-*/%^),<>=!&|?:;";
+	for (size_t i = idx + 1; i < parts.size(); i++) {
+		const auto &text = parts[i].text;
+		const auto pos = text.find_first_not_of(" \t\n");
+		if (pos == std::string::npos) {
+			continue;
+		}
+		return !parts[i].isValue &&
+		       delimiters.find(text[pos]) != std::string::npos;
+	}
+	return true;
+}
+
+std::variant<double, std::string>
+EvalMathExpression(const std::vector<MathExpressionPart> &parts)
+{
+	std::string expression;
+	MathExpressionVariables variables;
+	for (size_t i = 0; i < parts.size(); i++) {
+		const auto &part = parts[i];
+		// Values which are not separated from the surrounding text,
+		// like in "10${a}", have to be substituted as text
+		if (!part.isValue || !isPlainNumber(part.text) ||
+		    !isDelimitedBefore(expression) ||
+		    !isDelimitedAfter(parts, i)) {
+			expression += part.text;
+			continue;
+		}
+		auto name = "advssValue" + std::to_string(variables.size());
+		expression += name;
+		variables.emplace_back(std::move(name),
+				       *GetDouble(part.text));
+	}
 
-	if (parser.compile(expr, expression)) {
-		return expression.value();
+	auto result = EvalMathExpression(expression, variables);
+	if (!variables.empty() &&
+	    std::holds_alternative<std::string>(result)) {
+		// Report the error using the resolved expression text
+		std::string text;
+		for (const auto &part : parts) {
+			text += part.text;
+		}
+		return EvalMathExpression(text);
 	}
-	return std::string(obs_module_text(
-		       "AdvSceneSwitcher.math.expressionFail")) +
-	       " \"" + expr + "\"";
+	return result;
 }
 
 bool IsValidNumber(const std::string &str)
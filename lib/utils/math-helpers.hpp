@@ -2,13 +2,39 @@
 #include "export-symbol-helper.hpp"
 
 #include <string>
+#include <utility>
 #include <variant>
+#include <vector>
 #include <optional>
 
 namespace advss {
 
+// Names and values of the variables used in a math expression
+using MathExpressionVariables = std::vector<std::pair<std::string, double>>;
+
+// Returns the result of the expression or an error message.
+// Compiled expressions are cached, so evaluating the same expression again
+// does not require parsing it again.
 std::variant<double, std::string>
 EvalMathExpression(const std::string &expression);
+// The given values are bound to the variables with the given names, so the
+// expression can be reused for different values without being compiled again.
+std::variant<double, std::string>
+EvalMathExpression(const std::string &expression,
+		   const MathExpressionVariables &variables);
+
+// Part of a math expression which is either literal text or a value, like the
+// value of a variable, which is substituted into the expression
+struct MathExpressionPart {
+	std::string text;
+	bool isValue = false;
+};
+
+// Evaluates the expression resulting from concatenating the given parts.
+// Values are bound as variables wherever that does not change the meaning of
+// the expression, so it can be reused when only the values change.
+std::variant<double, std::string>
+EvalMathExpression(const std::vector<MathExpressionPart> &parts);
 bool IsValidNumber(const std::string &str);
 EXPORT std::optional<double> GetDouble(const std::string &str);
 EXPORT std::optional<int> GetInt(const std::string &str);
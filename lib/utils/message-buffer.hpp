@@ -1,49 +1,211 @@
 #pragma once
-#include <deque>
-#include <mutex>
-#include <optional>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
 
 namespace advss {
 
+// Bounded lock-free message queue, which can be used by any number of
+// producer and consumer threads.
+//
+// Messages are stored as shared pointers, so the same message can be passed to
+// multiple buffers without copying it.
+// The capacity is rounded up to the next power of two.
 template<class T> class MessageBuffer {
 public:
-	bool Empty();
+	using Message = std::shared_ptr<const T>;
+
+	enum class OverflowPolicy {
+		// Discard the oldest message to make room for the new one
+		DROP_OLDEST,
+		// Discard the new message
+		DROP_NEWEST,
+		// Wait until a consumer made room for the new message
+		BLOCK,
+	};
+
+	static constexpr size_t defaultCapacity = 1024;
+
+	explicit MessageBuffer(
+		size_t capacity = defaultCapacity,
+		OverflowPolicy policy = OverflowPolicy::DROP_OLDEST);
+	MessageBuffer(const MessageBuffer &) = delete;
+	MessageBuffer &operator=(const MessageBuffer &) = delete;
+
+	bool Empty() const;
 	void Clear();
 	void AppendMessage(const T &);
-	std::optional<T> ConsumeMessage();
+	void AppendMessage(const Message &);
+	// Returns nullptr if the buffer is empty
+	Message ConsumeMessage();
+	// Moves up to maxCount messages to the end of the given vector and
+	// returns the number of consumed messages
+	size_t
+	ConsumeMessages(std::vector<Message> &,
+			size_t maxCount = std::numeric_limits<size_t>::max());
+
+	size_t Capacity() const { return _mask + 1; }
+	// Number of messages discarded due to the overflow policy
+	uint64_t GetDroppedMessageCount() const { return _dropped; }
 
 private:
-	std::deque<T> _buffer;
-	std::mutex _mutex;
+	struct Slot {
+		std::atomic_size_t sequence;
+		Message message;
+	};
+
+	bool TryPush(const Message &);
+	bool TryPop(Message &);
+
+	static size_t RoundUpCapacity(size_t);
+
+	const OverflowPolicy _policy;
+	const size_t _mask;
+	std::unique_ptr<Slot[]> _slots;
+
+	// Producers and consumers are kept on separate cache lines
+	alignas(64) std::atomic_size_t _head = {0};
+	alignas(64) std::atomic_size_t _tail = {0};
+	std::atomic<uint64_t> _dropped = {0};
 };
 
-template<class T> inline bool MessageBuffer<T>::Empty()
+template<class T>
+inline size_t MessageBuffer<T>::RoundUpCapacity(size_t capacity)
+{
+	size_t result = 2;
+	while (result < capacity) {
+		result <<= 1;
+	}
+	return result;
+}
+
+template<class T>
+inline MessageBuffer<T>::MessageBuffer(size_t capacity, OverflowPolicy policy)
+	: _policy(policy),
+	  _mask(RoundUpCapacity(capacity) - 1),
+	  _slots(new Slot[_mask + 1])
+{
+	for (size_t i = 0; i <= _mask; i++) {
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template<class T> inline bool MessageBuffer<T>::Empty() const
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	return _buffer.empty();
+	return _head.load(std::memory_order_acquire) ==
+	       _tail.load(std::memory_order_acquire);
 }
 
 template<class T> inline void MessageBuffer<T>::Clear()
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	_buffer.clear();
+	Message message;
+	while (TryPop(message)) {
+	}
 }
 
 template<class T> inline void MessageBuffer<T>::AppendMessage(const T &message)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	_buffer.emplace_back(message);
+	AppendMessage(std::make_shared<const T>(message));
 }
 
-template<class T> inline std::optional<T> MessageBuffer<T>::ConsumeMessage()
+template<class T>
+inline void MessageBuffer<T>::AppendMessage(const Message &message)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	if (_buffer.empty()) {
-		return {};
+	while (!TryPush(message)) {
+		switch (_policy) {
+		case OverflowPolicy::DROP_OLDEST: {
+			Message discarded;
+			if (TryPop(discarded)) {
+				++_dropped;
+			}
+			break;
+		}
+		case OverflowPolicy::DROP_NEWEST:
+			++_dropped;
+			return;
+		case OverflowPolicy::BLOCK:
+			std::this_thread::yield();
+			break;
+		}
 	}
-	T message = _buffer.at(0);
-	_buffer.pop_front();
+}
+
+template<class T>
+inline typename MessageBuffer<T>::Message MessageBuffer<T>::ConsumeMessage()
+{
+	Message message;
+	TryPop(message);
 	return message;
 }
 
+template<class T>
+inline size_t MessageBuffer<T>::ConsumeMessages(std::vector<Message> &messages,
+						size_t maxCount)
+{
+	size_t count = 0;
+	Message message;
+	while (count < maxCount && TryPop(message)) {
+		messages.emplace_back(std::move(message));
+		++count;
+	}
+	return count;
+}
+
+// Each slot's sequence number tells whether it is ready to be written to or
+// read from at the given position, so producers and consumers only have to
+// agree on the position using compare and swap operations.
+template<class T> inline bool MessageBuffer<T>::TryPush(const Message &message)
+{
+	size_t pos = _tail.load(std::memory_order_relaxed);
+	while (true) {
+		auto &slot = _slots[pos & _mask];
+		const size_t sequence =
+			slot.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<intptr_t>(sequence) -
+				  static_cast<intptr_t>(pos);
+		if (diff == 0) {
+			if (_tail.compare_exchange_weak(
+				    pos, pos + 1, std::memory_order_relaxed)) {
+				slot.message = message;
+				slot.sequence.store(pos + 1,
+						    std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = _tail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<class T> inline bool MessageBuffer<T>::TryPop(Message &message)
+{
+	size_t pos = _head.load(std::memory_order_relaxed);
+	while (true) {
+		auto &slot = _slots[pos & _mask];
+		const size_t sequence =
+			slot.sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<intptr_t>(sequence) -
+				  static_cast<intptr_t>(pos + 1);
+		if (diff == 0) {
+			if (_head.compare_exchange_weak(
+				    pos, pos + 1, std::memory_order_relaxed)) {
+				message = std::move(slot.message);
+				slot.message.reset();
+				slot.sequence.store(pos + _mask + 1,
+						    std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+}
+
 } // namespace advss
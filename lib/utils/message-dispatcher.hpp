@@ -1,8 +1,12 @@
 #pragma once
 #include "message-buffer.hpp"
+#include "wakeup-helpers.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 
 namespace advss {
@@ -30,41 +34,86 @@ public:
 		return *this;
 	}
 
-	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient();
+	using OverflowPolicy = typename MessageBuffer<T>::OverflowPolicy;
+	// Decides which messages are passed to a client.
+	// It is called on the thread dispatching the message, so it must not
+	// access any state which might be modified concurrently.
+	using Filter = std::function<bool(const T &)>;
+
+	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient(
+		size_t capacity = MessageBuffer<T>::defaultCapacity,
+		OverflowPolicy policy = OverflowPolicy::DROP_OLDEST);
+	// Only messages accepted by the given filter are added to the buffer
+	[[nodiscard]] std::shared_ptr<MessageBuffer<T>> RegisterClient(
+		const Filter &filter,
+		size_t capacity = MessageBuffer<T>::defaultCapacity,
+		OverflowPolicy policy = OverflowPolicy::DROP_OLDEST);
+	// The message is shared by all clients instead of being copied into
+	// each of the client buffers
 	void DispatchMessage(const T &message);
+	void DispatchMessage(const std::shared_ptr<const T> &message);
 
 private:
-	std::vector<std::weak_ptr<MessageBuffer<T>>> _clients;
-	std::mutex _mutex;
+	struct Client {
+		std::weak_ptr<MessageBuffer<T>> buffer;
+		Filter filter;
+	};
+
+	std::vector<Client> _clients;
+	std::shared_mutex _mutex;
 };
 
 template<class T>
-inline std::shared_ptr<MessageBuffer<T>> MessageDispatcher<T>::RegisterClient()
+inline std::shared_ptr<MessageBuffer<T>>
+MessageDispatcher<T>::RegisterClient(size_t capacity, OverflowPolicy policy)
+{
+	return RegisterClient(Filter(), capacity, policy);
+}
+
+template<class T>
+inline std::shared_ptr<MessageBuffer<T>>
+MessageDispatcher<T>::RegisterClient(const Filter &filter, size_t capacity,
+				     OverflowPolicy policy)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
+	std::unique_lock<std::shared_mutex> lock(_mutex);
 	// Clear expired client buffers
-	auto isExpired = [](const std::weak_ptr<MessageBuffer<T>> &ptr) {
-		return ptr.expired();
+	auto isExpired = [](const Client &client) {
+		return client.buffer.expired();
 	};
 	_clients.erase(std::remove_if(_clients.begin(), _clients.end(),
 				      isExpired),
 		       _clients.end());
 	// Prepare new buffer for client
-	auto buffer = std::make_shared<MessageBuffer<T>>();
-	_clients.emplace_back(buffer);
+	auto buffer = std::make_shared<MessageBuffer<T>>(capacity, policy);
+	_clients.push_back({buffer, filter});
 	return buffer;
 }
 
 template<class T>
 inline void MessageDispatcher<T>::DispatchMessage(const T &message)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
-	for (auto &client_ : _clients) {
-		auto client = client_.lock();
-		if (!client) {
+	DispatchMessage(std::make_shared<const T>(message));
+}
+
+template<class T>
+inline void
+MessageDispatcher<T>::DispatchMessage(const std::shared_ptr<const T> &message)
+{
+	std::shared_lock<std::shared_mutex> lock(_mutex);
+	bool dispatched = false;
+	for (auto &client : _clients) {
+		if (client.filter && !client.filter(*message)) {
 			continue;
 		}
-		client->AppendMessage(message);
+		auto buffer = client.buffer.lock();
+		if (!buffer) {
+			continue;
+		}
+		buffer->AppendMessage(message);
+		dispatched = true;
+	}
+	if (dispatched) {
+		SignalWakeup(WakeupSource::MESSAGE);
 	}
 }
 
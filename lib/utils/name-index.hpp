@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace advss {
+
+// Hash based index to look up the elements of a container by name.
+//
+// The index is rebuilt lazily on the next lookup whenever the given generation
+// counter was incremented or the number of elements in the container changed.
+// The generation counter has to be incremented whenever an element is renamed
+// or destroyed.
+//
+// Lookups can be performed concurrently from any thread.
+template<class T> class NameIndex {
+public:
+	using Container = std::deque<std::shared_ptr<T>>;
+	using GenerationFunc = uint64_t (*)();
+
+	NameIndex(const Container &items, GenerationFunc getGeneration)
+		: _items(items),
+		  _getGeneration(getGeneration)
+	{
+	}
+
+	std::shared_ptr<T> Find(const std::string &name) const
+	{
+		const auto generation = _getGeneration();
+		{
+			std::shared_lock<std::shared_mutex> lock(_mutex);
+			if (IsUpToDate(generation)) {
+				return Lookup(name);
+			}
+		}
+
+		std::unique_lock<std::shared_mutex> lock(_mutex);
+		if (!IsUpToDate(generation)) {
+			Rebuild(generation);
+		}
+		return Lookup(name);
+	}
+
+private:
+	bool IsUpToDate(uint64_t generation) const
+	{
+		return _valid && _generation == generation &&
+		       _size == _items.size();
+	}
+
+	std::shared_ptr<T> Lookup(const std::string &name) const
+	{
+		auto it = _index.find(name);
+		if (it == _index.end()) {
+			return {};
+		}
+		return it->second.lock();
+	}
+
+	void Rebuild(uint64_t generation) const
+	{
+		_index.clear();
+		_index.reserve(_items.size());
+		for (const auto &item : _items) {
+			if (!item) {
+				continue;
+			}
+			// Keep the first element in case of duplicate names to
+			// match the behavior of a linear search
+			_index.emplace(item->Name(), item);
+		}
+		_generation = generation;
+		_size = _items.size();
+		_valid = true;
+	}
+
+	const Container &_items;
+	const GenerationFunc _getGeneration;
+
+	mutable std::shared_mutex _mutex;
+	mutable std::unordered_map<std::string, std::weak_ptr<T>> _index;
+	mutable uint64_t _generation = 0;
+	mutable size_t _size = 0;
+	mutable bool _valid = false;
+};
+
+} // namespace advss
@@ -231,4 +231,20 @@ bool IsFirstIntervalAfterStop()
 	return GetSwitcher()->firstIntervalAfterStop;
 }
 
+bool EventDrivenMacroChecksEnabled()
+{
+	return GetSwitcher() && GetSwitcher()->eventDrivenMacroChecks;
+}
+
+bool IsWakeupTriggeredInterval()
+{
+	return GetSwitcher() && GetSwitcher()->wakeupTriggeredInterval;
+}
+
+int GetMacroConditionCheckThreadCount()
+{
+	return GetSwitcher() ? GetSwitcher()->macroConditionCheckThreadCount
+			     : 1;
+}
+
 } // namespace advss
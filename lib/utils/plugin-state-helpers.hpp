@@ -46,5 +46,8 @@ EXPORT bool OBSIsShuttingDown();
 EXPORT bool InitialLoadIsComplete();
 EXPORT bool IsFirstInterval();
 EXPORT bool IsFirstIntervalAfterStop();
+EXPORT bool EventDrivenMacroChecksEnabled();
+EXPORT bool IsWakeupTriggeredInterval();
+EXPORT int GetMacroConditionCheckThreadCount();
 
 } // namespace advss
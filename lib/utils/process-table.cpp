@@ -0,0 +1,69 @@
+#include "process-table.hpp"
+#include "platform-funcs.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <chrono>
+#include <mutex>
+
+namespace advss {
+
+using Clock = std::chrono::high_resolution_clock;
+
+static std::mutex mutex;
+static std::shared_ptr<const ProcessTable> currentTable;
+static Clock::time_point lastRefresh;
+
+static std::shared_ptr<const ProcessTable>
+createTable(const std::shared_ptr<const ProcessTable> &previous)
+{
+	auto table = std::make_shared<ProcessTable>();
+	QStringList processes;
+	GetProcessList(processes);
+
+	table->names.reserve(processes.size());
+	for (const auto &process : processes) {
+		// Only keep the first occurrence of each name
+		if (table->names.contains(process)) {
+			continue;
+		}
+		table->names.insert(process);
+		table->processes.append(process);
+	}
+
+	if (!previous) {
+		table->started = table->names;
+		return table;
+	}
+
+	table->generation = previous->generation + 1;
+	for (const auto &name : table->processes) {
+		if (!previous->names.contains(name)) {
+			table->started.insert(name);
+		}
+	}
+	for (const auto &name : previous->processes) {
+		if (!table->names.contains(name)) {
+			table->exited.insert(name);
+		}
+	}
+	return table;
+}
+
+std::shared_ptr<const ProcessTable> GetProcessTable()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Conditions of the same interval are not checked at exactly the same
+	// time, so allow some slack to not skip a refresh in the next interval
+	const auto maxAge = std::chrono::milliseconds(GetIntervalValue()) / 2;
+	const auto now = Clock::now();
+	if (currentTable && now - lastRefresh < maxAge) {
+		return currentTable;
+	}
+
+	currentTable = createTable(currentTable);
+	lastRefresh = now;
+	return currentTable;
+}
+
+} // namespace advss
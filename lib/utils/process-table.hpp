@@ -0,0 +1,29 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+namespace advss {
+
+// Snapshot of the names of all running processes
+struct ProcessTable {
+	// Incremented with each new snapshot
+	uint64_t generation = 0;
+	QStringList processes;
+	QSet<QString> names;
+	// Names which were added or removed since the previous snapshot
+	QSet<QString> started;
+	QSet<QString> exited;
+};
+
+// Returns the most recent snapshot of the running processes.
+//
+// All callers share the same snapshot, which is refreshed at most once per
+// interval of the plugin, no matter how many conditions request it.
+EXPORT std::shared_ptr<const ProcessTable> GetProcessTable();
+
+} // namespace advss
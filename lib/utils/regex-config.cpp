@@ -4,11 +4,47 @@
 #include "ui-helpers.hpp"
 
 #include <QLayout>
+#include <algorithm>
+#include <string_view>
 
 namespace advss {
 
 RegexConfig::RegexConfig(bool enabled) : _enable(enabled) {}
 
+RegexConfig::RegexConfig(const RegexConfig &other)
+	: _enable(other._enable),
+	  _partialMatch(other._partialMatch),
+	  _options(other._options)
+{
+	CopyCache(other);
+}
+
+RegexConfig &RegexConfig::operator=(const RegexConfig &other)
+{
+	if (this == &other) {
+		return *this;
+	}
+	_enable = other._enable;
+	_partialMatch = other._partialMatch;
+	_options = other._options;
+	CopyCache(other);
+	return *this;
+}
+
+void RegexConfig::CopyCache(const RegexConfig &other)
+{
+	// The compiled expression is implicitly shared by QRegularExpression,
+	// so copying it is cheap
+	std::scoped_lock lock(_cache->mutex, other._cache->mutex);
+	_cache->expression = other._cache->expression;
+	_cache->qExpression = other._cache->qExpression;
+	_cache->options = other._cache->options;
+	_cache->partialMatch = other._cache->partialMatch;
+	_cache->valid = other._cache->valid;
+	_cache->isLiteral = other._cache->isLiteral;
+	_cache->regex = other._cache->regex;
+}
+
 void RegexConfig::Save(obs_data_t *obj, const char *name) const
 {
 	auto data = obs_data_create();
@@ -47,7 +83,8 @@ void RegexConfig::SetPatternOptions(QRegularExpression::PatternOptions options)
 	_options = options;
 }
 
-QRegularExpression RegexConfig::GetRegularExpression(const QString &expr) const
+QRegularExpression
+RegexConfig::CreateRegularExpression(const QString &expr) const
 {
 	if (_partialMatch) {
 		return QRegularExpression(expr, _options);
@@ -56,15 +93,86 @@ QRegularExpression RegexConfig::GetRegularExpression(const QString &expr) const
 				  _options);
 }
 
+bool RegexConfig::CanMatchLiterally(const QString &expr) const
+{
+	if (_options & (QRegularExpression::CaseInsensitiveOption |
+			QRegularExpression::ExtendedPatternSyntaxOption)) {
+		return false;
+	}
+
+	static const QString specialChars = "\\^$.|?*+()[]{}";
+	for (const auto &c : expr) {
+		if (specialChars.contains(c)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool RegexConfig::IsCached(const Cache &cache, const std::string &expr) const
+{
+	return cache.valid && cache.options == _options &&
+	       cache.partialMatch == _partialMatch && cache.expression == expr;
+}
+
+bool RegexConfig::IsCached(const Cache &cache, const QString &expr) const
+{
+	return cache.valid && cache.options == _options &&
+	       cache.partialMatch == _partialMatch && cache.qExpression == expr;
+}
+
+void RegexConfig::UpdateCache(Cache &cache, const std::string &expr,
+			      const QString &qExpr) const
+{
+	cache.expression = expr;
+	cache.qExpression = qExpr;
+	cache.options = _options;
+	cache.partialMatch = _partialMatch;
+	cache.isLiteral = CanMatchLiterally(qExpr);
+	cache.regex = CreateRegularExpression(qExpr);
+	if (!cache.isLiteral) {
+		cache.regex.optimize();
+	}
+	cache.valid = true;
+}
+
+QRegularExpression RegexConfig::GetRegularExpression(const QString &expr) const
+{
+	std::lock_guard<std::mutex> lock(_cache->mutex);
+	if (!IsCached(*_cache, expr)) {
+		UpdateCache(*_cache, expr.toStdString(), expr);
+	}
+	return _cache->regex;
+}
+
 QRegularExpression
 RegexConfig::GetRegularExpression(const std::string &expr) const
 {
-	return GetRegularExpression(QString::fromStdString(expr));
+	std::lock_guard<std::mutex> lock(_cache->mutex);
+	if (!IsCached(*_cache, expr)) {
+		UpdateCache(*_cache, expr, QString::fromStdString(expr));
+	}
+	return _cache->regex;
 }
 
 bool RegexConfig::Matches(const QString &text, const QString &expression) const
 {
-	auto regex = GetRegularExpression(expression);
+	QRegularExpression regex;
+	{
+		std::lock_guard<std::mutex> lock(_cache->mutex);
+		if (!IsCached(*_cache, expression)) {
+			UpdateCache(*_cache, expression.toStdString(),
+				    expression);
+		}
+		if (_cache->isLiteral && _partialMatch) {
+			return text.contains(expression);
+		}
+		if (_cache->isLiteral) {
+			return text == expression;
+		}
+		regex = _cache->regex;
+	}
+
 	if (!regex.isValid()) {
 		return false;
 	}
@@ -75,8 +183,28 @@ bool RegexConfig::Matches(const QString &text, const QString &expression) const
 bool RegexConfig::Matches(const std::string &text,
 			  const std::string &expression) const
 {
-	return Matches(QString::fromStdString(text),
-		       QString::fromStdString(expression));
+	QRegularExpression regex;
+	{
+		std::lock_guard<std::mutex> lock(_cache->mutex);
+		if (!IsCached(*_cache, expression)) {
+			UpdateCache(*_cache, expression,
+				    QString::fromStdString(expression));
+		}
+		// Skip the conversion to QString entirely if possible
+		if (_cache->isLiteral && _partialMatch) {
+			return text.find(expression) != std::string::npos;
+		}
+		if (_cache->isLiteral) {
+			return text == expression;
+		}
+		regex = _cache->regex;
+	}
+
+	if (!regex.isValid()) {
+		return false;
+	}
+	auto match = regex.match(QString::fromStdString(text));
+	return match.hasMatch();
 }
 
 RegexConfig RegexConfig::PartialMatchRegexConfig(bool enabled)
@@ -87,6 +215,84 @@ RegexConfig RegexConfig::PartialMatchRegexConfig(bool enabled)
 	return regex;
 }
 
+static bool isRegexSpecialCharacter(char c)
+{
+	static constexpr std::string_view specialCharacters = "\\^$.|?*+()[]{}";
+	return specialCharacters.find(c) != std::string_view::npos;
+}
+
+static bool isQuantifier(char c)
+{
+	return c == '?' || c == '*' || c == '+' || c == '{';
+}
+
+static bool isUtf8ContinuationByte(char c)
+{
+	return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+RegexLiteral GetRegexLiteral(const std::string &expression,
+			     const RegexConfig &regex)
+{
+	if (!regex.Enabled()) {
+		return {RegexLiteral::Type::EXACT, expression};
+	}
+
+	const auto unsupportedOptions =
+		QRegularExpression::CaseInsensitiveOption |
+		QRegularExpression::MultilineOption |
+		QRegularExpression::ExtendedPatternSyntaxOption;
+	if (regex.GetPatternOptions() & unsupportedOptions ||
+	    expression.find('|') != std::string::npos) {
+		return {};
+	}
+
+	// Expressions starting with literal text can only match strings
+	// starting with the same text
+	const bool partialMatch = regex.PartialMatchEnabled();
+	size_t start = 0;
+	if (!expression.empty() && expression[0] == '^') {
+		start = 1;
+	} else if (partialMatch) {
+		start = std::string::npos;
+	}
+
+	if (start != std::string::npos) {
+		auto end = start;
+		while (end < expression.size() &&
+		       !isRegexSpecialCharacter(expression[end])) {
+			end++;
+		}
+		if (end == expression.size()) {
+			return {partialMatch ? RegexLiteral::Type::PREFIX
+					     : RegexLiteral::Type::EXACT,
+				expression.substr(start)};
+		}
+		// The last character might be optional, which also applies
+		// to all bytes of a multi byte UTF-8 character
+		if (isQuantifier(expression[end]) && end > start) {
+			end--;
+			while (end > start &&
+			       isUtf8ContinuationByte(expression[end])) {
+				end--;
+			}
+		}
+		if (end > start) {
+			return {RegexLiteral::Type::PREFIX,
+				expression.substr(start, end - start)};
+		}
+		return {};
+	}
+
+	// Expressions without any special characters match all strings
+	// containing the expression
+	if (std::none_of(expression.begin(), expression.end(),
+			 isRegexSpecialCharacter)) {
+		return {RegexLiteral::Type::CONTAINS, expression};
+	}
+	return {};
+}
+
 RegexConfigWidget::RegexConfigWidget(QWidget *parent, bool showEnable)
 	: QWidget(parent),
 	  _openSettings(new QToolButton()),
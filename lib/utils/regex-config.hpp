@@ -10,6 +10,10 @@
 #include <QToolButton>
 #include <QWidget>
 
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace advss {
 
 class RegexConfigWidget;
@@ -18,6 +22,10 @@ class RegexConfigDialog;
 class RegexConfig {
 public:
 	EXPORT RegexConfig(bool enabled = false);
+	// Each copy uses its own cache, as copies are often used to match
+	// different expressions
+	EXPORT RegexConfig(const RegexConfig &);
+	EXPORT RegexConfig &operator=(const RegexConfig &);
 
 	EXPORT void Save(obs_data_t *obj,
 			 const char *name = "regexConfig") const;
@@ -25,6 +33,7 @@ public:
 
 	EXPORT bool Enabled() const { return _enable; }
 	EXPORT void SetEnabled(bool enable) { _enable = enable; }
+	EXPORT bool PartialMatchEnabled() const { return _partialMatch; }
 	EXPORT void CreateBackwardsCompatibleRegex(bool enable,
 						   bool setOptions = true);
 	EXPORT QRegularExpression::PatternOptions GetPatternOptions() const;
@@ -40,14 +49,57 @@ public:
 	EXPORT static RegexConfig PartialMatchRegexConfig(bool enabled = false);
 
 private:
+	// The most recently used expression is kept in its compiled form, as
+	// most users match many texts against the same expression.
+	// Expressions without any special characters are matched using plain
+	// string comparisons instead.
+	struct Cache {
+		std::mutex mutex;
+		std::string expression;
+		QString qExpression;
+		QRegularExpression::PatternOptions options;
+		bool partialMatch = false;
+		bool valid = false;
+		bool isLiteral = false;
+		QRegularExpression regex;
+	};
+
+	void CopyCache(const RegexConfig &);
+	bool IsCached(const Cache &, const std::string &) const;
+	bool IsCached(const Cache &, const QString &) const;
+	void UpdateCache(Cache &, const std::string &, const QString &) const;
+	bool CanMatchLiterally(const QString &) const;
+	QRegularExpression CreateRegularExpression(const QString &) const;
+
 	bool _enable = false;
 	bool _partialMatch = false;
 	QRegularExpression::PatternOptions _options =
 		QRegularExpression::NoPatternOption;
+	std::unique_ptr<Cache> _cache = std::make_unique<Cache>();
 	friend RegexConfigWidget;
 	friend RegexConfigDialog;
 };
 
+// Literal text which all strings matched by an expression have in common, so
+// strings can be rejected without evaluating the expression
+struct RegexLiteral {
+	enum class Type {
+		// Any string might be matched
+		ANY,
+		EXACT,
+		PREFIX,
+		CONTAINS,
+	};
+
+	Type type = Type::ANY;
+	std::string text;
+};
+
+// Expressions which cannot be reduced to literal text result in Type::ANY.
+// If regular expressions are disabled, the expression is compared as is.
+EXPORT RegexLiteral GetRegexLiteral(const std::string &expression,
+				    const RegexConfig &);
+
 class ADVSS_EXPORT RegexConfigWidget : public QWidget {
 	Q_OBJECT
 public:
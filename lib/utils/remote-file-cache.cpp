@@ -0,0 +1,298 @@
+#include "remote-file-cache.hpp"
+#include "curl-helper.hpp"
+#include "log-helper.hpp"
+#include "plugin-state-helpers.hpp"
+#include "thread-pool.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace advss {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct RemoteFile {
+	std::shared_ptr<const std::string> data;
+	uint64_t hash = 0;
+	// Validators of the last response used to revalidate the content
+	std::string etag;
+	std::string lastModified;
+	// Time of the last request for each of the requested refresh intervals
+	std::map<std::chrono::milliseconds, Clock::time_point> requests;
+	Clock::time_point nextFetch;
+	bool fetching = false;
+};
+
+struct Response {
+	bool ok = false;
+	long code = 0;
+	std::string body;
+	std::string etag;
+	std::string lastModified;
+};
+
+} // namespace
+
+// URLs which were not requested for a while are no longer fetched
+static constexpr auto maxUnusedTime = std::chrono::minutes(1);
+static constexpr auto minTimeout = std::chrono::seconds(1);
+static constexpr auto maxTimeout = std::chrono::seconds(10);
+static constexpr size_t fetchThreadCount = 2;
+
+static std::mutex mutex;
+static std::condition_variable cv;
+static std::unordered_map<std::string, std::shared_ptr<RemoteFile>> files;
+static std::thread pollThread;
+static bool stopPolling = false;
+static ThreadPool fetchPool;
+
+static void stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopPolling = true;
+	}
+	cv.notify_all();
+	if (pollThread.joinable()) {
+		pollThread.join();
+	}
+	fetchPool.Stop();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	files.clear();
+}
+
+static bool setup()
+{
+	AddPluginCleanupStep(stop);
+	return true;
+}
+
+static bool setupDone = setup();
+
+static size_t writeCallback(void *contents, size_t size, size_t nmemb,
+			    void *userp)
+{
+	((std::string *)userp)->append((char *)contents, size * nmemb);
+	return size * nmemb;
+}
+
+static std::string trim(const std::string &value)
+{
+	const auto start = value.find_first_not_of(" \t\r\n");
+	if (start == std::string::npos) {
+		return "";
+	}
+	const auto end = value.find_last_not_of(" \t\r\n");
+	return value.substr(start, end - start + 1);
+}
+
+static size_t headerCallback(char *buffer, size_t size, size_t nitems,
+			     void *userp)
+{
+	const std::string header(buffer, size * nitems);
+	const auto separator = header.find(':');
+	if (separator == std::string::npos) {
+		return size * nitems;
+	}
+
+	auto name = header.substr(0, separator);
+	std::transform(name.begin(), name.end(), name.begin(),
+		       [](unsigned char c) { return std::tolower(c); });
+	auto response = static_cast<Response *>(userp);
+	if (name == "etag") {
+		response->etag = trim(header.substr(separator + 1));
+	} else if (name == "last-modified") {
+		response->lastModified = trim(header.substr(separator + 1));
+	}
+	return size * nitems;
+}
+
+static Response fetch(const std::string &url, const std::string &etag,
+		      const std::string &lastModified,
+		      std::chrono::milliseconds timeout)
+{
+	struct curl_slist *headers = nullptr;
+	if (!etag.empty()) {
+		headers = CurlHelper::SlistAppend(
+			headers, ("If-None-Match: " + etag).c_str());
+	}
+	if (!lastModified.empty()) {
+		headers = CurlHelper::SlistAppend(
+			headers,
+			("If-Modified-Since: " + lastModified).c_str());
+	}
+
+	Response response;
+	CurlHelper::SetOpt(CURLOPT_URL, url.c_str());
+	CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, writeCallback);
+	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &response.body);
+	CurlHelper::SetOpt(CURLOPT_HEADERFUNCTION, headerCallback);
+	CurlHelper::SetOpt(CURLOPT_HEADERDATA, &response);
+	CurlHelper::SetOpt(CURLOPT_TIMEOUT_MS, (long)timeout.count());
+	if (headers) {
+		CurlHelper::SetOpt(CURLOPT_HTTPHEADER, headers);
+	}
+	const auto result = CurlHelper::Perform(&response.code);
+	CurlHelper::SlistFreeAll(headers);
+
+	response.ok = result == CURLE_OK;
+	if (!response.ok) {
+		vblog(LOG_INFO, "failed to fetch \"%s\": %s", url.c_str(),
+		      CurlHelper::GetError(result));
+	}
+	return response;
+}
+
+static std::chrono::milliseconds getRefreshInterval(RemoteFile &file,
+						    Clock::time_point now)
+{
+	// Intervals of requesters which are gone are no longer relevant
+	for (auto it = file.requests.begin(); it != file.requests.end();) {
+		if (now - it->second > maxUnusedTime &&
+		    std::next(it) != file.requests.end()) {
+			it = file.requests.erase(it);
+		} else {
+			++it;
+		}
+	}
+	return file.requests.begin()->first;
+}
+
+static Clock::time_point getLastRequest(const RemoteFile &file)
+{
+	Clock::time_point lastRequest;
+	for (const auto &[_, time] : file.requests) {
+		lastRequest = std::max(lastRequest, time);
+	}
+	return lastRequest;
+}
+
+static void updateFile(RemoteFile &file, Response &response)
+{
+	// Non-HTTP URLs, like "file://", report a response code of 0
+	const bool success =
+		response.ok && (response.code == 0 ||
+				(response.code >= 200 && response.code < 300));
+	if (!success) {
+		return;
+	}
+
+	file.etag = response.etag;
+	file.lastModified = response.lastModified;
+	const auto hash = std::hash<std::string>{}(response.body);
+	if (file.data && hash == file.hash && *file.data == response.body) {
+		return;
+	}
+	file.hash = hash;
+	file.data = std::make_shared<const std::string>(
+		std::move(response.body));
+}
+
+static void startFetch(const std::string &url,
+		       const std::shared_ptr<RemoteFile> &file,
+		       Clock::time_point now)
+{
+	const auto interval = getRefreshInterval(*file, now);
+	const auto timeout =
+		std::clamp<std::chrono::milliseconds>(interval, minTimeout,
+						      maxTimeout);
+	file->nextFetch = now + interval;
+	file->fetching = true;
+
+	(void)fetchPool.Submit([url, file, timeout,
+				etag = file->etag,
+				lastModified = file->lastModified]() {
+		auto response = fetch(url, etag, lastModified, timeout);
+		std::lock_guard<std::mutex> lock(mutex);
+		updateFile(*file, response);
+		file->fetching = false;
+		// The next fetch of the file has to be scheduled by the
+		// polling thread
+		cv.notify_all();
+	});
+}
+
+static void poll()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!stopPolling) {
+		const auto now = Clock::now();
+		auto nextFetch = Clock::time_point::max();
+		for (auto it = files.begin(); it != files.end();) {
+			auto &[url, file] = *it;
+			if (now - getLastRequest(*file) > maxUnusedTime &&
+			    !file->fetching) {
+				it = files.erase(it);
+				continue;
+			}
+			if (!file->fetching && file->nextFetch <= now) {
+				startFetch(url, file, now);
+			}
+			// Files still being fetched are rescheduled once the
+			// fetch completes, so fetches taking longer than the
+			// refresh interval do not result in busy waiting
+			if (!file->fetching) {
+				nextFetch =
+					std::min(nextFetch, file->nextFetch);
+			}
+			++it;
+		}
+
+		if (nextFetch == Clock::time_point::max()) {
+			cv.wait(lock);
+		} else {
+			cv.wait_until(lock, nextFetch);
+		}
+	}
+}
+
+std::optional<FileContent>
+GetRemoteFileContent(const std::string &url,
+		     std::chrono::milliseconds refreshInterval)
+{
+	refreshInterval = std::max(refreshInterval,
+				   std::chrono::milliseconds(100));
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (stopPolling) {
+		return {};
+	}
+
+	const auto now = Clock::now();
+	auto &file = files[url];
+	if (!file) {
+		file = std::make_shared<RemoteFile>();
+	}
+	auto &lastRequest = file->requests[refreshInterval];
+	const bool isNewInterval = lastRequest == Clock::time_point();
+	lastRequest = now;
+
+	if (!pollThread.joinable()) {
+		// The fetch tasks must never run on the polling thread, as it
+		// holds the lock while submitting them
+		fetchPool.SetThreadCount(fetchThreadCount);
+		pollThread = std::thread(poll);
+	}
+	if (isNewInterval) {
+		// New files are fetched immediately, as their next fetch time
+		// is not set yet
+		file->nextFetch = std::min(file->nextFetch,
+					   now + refreshInterval);
+		cv.notify_all();
+	}
+
+	if (!file->data) {
+		return {};
+	}
+	return FileContent{file->data, file->hash};
+}
+
+} // namespace advss
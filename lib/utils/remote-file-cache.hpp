@@ -0,0 +1,22 @@
+#pragma once
+#include "file-content-cache.hpp"
+
+#include <chrono>
+
+namespace advss {
+
+// Returns the most recently fetched content of the given URL, or an empty
+// optional if the URL was not fetched successfully yet.
+// This function never waits for the request to complete.
+//
+// The URL is fetched in the background every refreshInterval for as long as
+// its content keeps being requested.
+// Callers requesting the same URL share a single fetch using the shortest of
+// their refresh intervals.
+// The server is asked to only send the content again if it was modified, by
+// using the ETag and Last-Modified headers of the previous response.
+EXPORT std::optional<FileContent>
+GetRemoteFileContent(const std::string &url,
+		     std::chrono::milliseconds refreshInterval);
+
+} // namespace advss
@@ -0,0 +1,84 @@
+#include "save-data-cache.hpp"
+#ifndef UNIT_TEST
+#include "plugin-state-helpers.hpp"
+
+#include <obs.h>
+#endif
+
+namespace advss {
+
+static std::atomic<uint64_t> globalGeneration = {1};
+
+#ifndef UNIT_TEST
+static void invalidateAllSaveData(void *, calldata_t *)
+{
+	SaveDataCache::InvalidateAll();
+}
+
+// Source selections are saved by name, so renaming or removing a source will
+// change the saved settings of all objects referring to it
+static bool setup()
+{
+	AddPluginInitStep([]() {
+		auto sh = obs_get_signal_handler();
+		signal_handler_connect(sh, "source_rename",
+				       invalidateAllSaveData, nullptr);
+		signal_handler_connect(sh, "source_destroy",
+				       invalidateAllSaveData, nullptr);
+	});
+	AddPluginCleanupStep([]() {
+		auto sh = obs_get_signal_handler();
+		signal_handler_disconnect(sh, "source_rename",
+					  invalidateAllSaveData, nullptr);
+		signal_handler_disconnect(sh, "source_destroy",
+					  invalidateAllSaveData, nullptr);
+	});
+	return true;
+}
+
+static bool setupDone = setup();
+#endif
+
+SaveDataCache &SaveDataCache::operator=(const SaveDataCache &)
+{
+	Invalidate();
+	return *this;
+}
+
+SaveDataCache::~SaveDataCache()
+{
+	obs_data_release(_data);
+}
+
+void SaveDataCache::InvalidateAll()
+{
+	++globalGeneration;
+}
+
+uint64_t SaveDataCache::GetGlobalGeneration()
+{
+	return globalGeneration;
+}
+
+obs_data_t *SaveDataCache::Get(const std::function<void(obs_data_t *)> &save)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const uint64_t generation = _generation;
+	const uint64_t currentGlobalGeneration = globalGeneration;
+	if (!_data || generation != _dataGeneration ||
+	    currentGlobalGeneration != _dataGlobalGeneration) {
+		// Modifications while saving will cause the settings to be
+		// recreated on the next call, as the generation will not match
+		obs_data_t *data = obs_data_create();
+		save(data);
+		obs_data_release(_data);
+		_data = data;
+		_dataGeneration = generation;
+		_dataGlobalGeneration = currentGlobalGeneration;
+	}
+
+	obs_data_addref(_data);
+	return _data;
+}
+
+} // namespace advss
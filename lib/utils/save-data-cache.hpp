@@ -0,0 +1,49 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <obs-data.h>
+
+namespace advss {
+
+// Caches the serialized settings of an object, so they do not have to be
+// recreated each time the settings are saved.
+//
+// Invalidate() has to be called whenever the object was modified in a way
+// which affects its serialized settings.
+// InvalidateAll() has to be called whenever the serialized settings of any
+// object might have changed without the object itself being modified, which
+// for example is the case if a referenced source or macro was renamed.
+//
+// As the cached settings are shared with the data passed to OBS they must
+// never be modified.
+class EXPORT SaveDataCache {
+public:
+	SaveDataCache() = default;
+	// Copies of an object have to serialize their settings on their own
+	SaveDataCache(const SaveDataCache &) {}
+	SaveDataCache &operator=(const SaveDataCache &);
+	~SaveDataCache();
+
+	void Invalidate() { ++_generation; }
+	static void InvalidateAll();
+	// Changes whenever InvalidateAll() is called
+	static uint64_t GetGlobalGeneration();
+
+	// Returns the cached settings, if they are still valid, or creates
+	// them using the given save function.
+	// The returned reference has to be released by the caller.
+	obs_data_t *Get(const std::function<void(obs_data_t *)> &save);
+
+private:
+	std::mutex _mutex;
+	std::atomic<uint64_t> _generation = {1};
+	uint64_t _dataGeneration = 0;
+	uint64_t _dataGlobalGeneration = 0;
+	obs_data_t *_data = nullptr;
+};
+
+} // namespace advss
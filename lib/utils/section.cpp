@@ -171,6 +171,11 @@ void Section::SetupAnimations()
 			 SLOT(AnimationFinish()));
 }
 
+int Section::ContentHeight() const
+{
+	return _contentHeight;
+}
+
 void Section::CleanUpPreviousContent()
 {
 	if (_contentArea) {
@@ -20,6 +20,7 @@ public:
 	void SetContent(QWidget *w, bool collapsed);
 	void AddHeaderWidget(QWidget *);
 	void SetCollapsed(bool);
+	int ContentHeight() const;
 
 protected:
 	bool eventFilter(QObject *obj, QEvent *event) override;
@@ -111,6 +111,11 @@ void TempVariable::InvalidateValue()
 	_valueIsValid = false;
 }
 
+void TempVariable::RevalidateValue()
+{
+	_valueIsValid = true;
+}
+
 TempVariableRef TempVariable::GetRef() const
 {
 	TempVariableRef ref;
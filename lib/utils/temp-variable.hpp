@@ -42,6 +42,8 @@ public:
 	EXPORT std::optional<std::string> Value() const;
 	void SetValue(const std::string &val);
 	void InvalidateValue();
+	// Marks the previously set value as valid again
+	void RevalidateValue();
 	TempVariableRef GetRef() const;
 
 private:
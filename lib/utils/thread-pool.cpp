@@ -0,0 +1,149 @@
+#include "thread-pool.hpp"
+
+namespace advss {
+
+ThreadPool::~ThreadPool()
+{
+	Stop();
+}
+
+void ThreadPool::SetThreadCount(size_t count)
+{
+	std::lock_guard<std::mutex> resizeLock(_resizeMutex);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_stopped || count == _threads.size()) {
+			return;
+		}
+	}
+
+	JoinThreads();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_threadCount = count;
+	}
+
+	if (count == 0) {
+		// Nobody would be left to process the queued tasks
+		RunRemainingTasks();
+		return;
+	}
+
+	StartThreads(count);
+}
+
+size_t ThreadPool::GetThreadCount() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _threadCount;
+}
+
+std::future<void> ThreadPool::Submit(std::function<void()> task)
+{
+	std::packaged_task<void()> packagedTask(std::move(task));
+	auto future = packagedTask.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_stopped && _threadCount > 0) {
+			_tasks.emplace_back(std::move(packagedTask));
+			_cv.notify_one();
+			return future;
+		}
+	}
+
+	packagedTask();
+	return future;
+}
+
+void ThreadPool::Wait(const std::future<void> &future)
+{
+	while (future.wait_for(std::chrono::seconds(0)) !=
+	       std::future_status::ready) {
+		if (!RunPendingTask()) {
+			future.wait();
+		}
+	}
+}
+
+void ThreadPool::Stop()
+{
+	std::lock_guard<std::mutex> resizeLock(_resizeMutex);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_stopped) {
+			return;
+		}
+		_stopped = true;
+		_threadCount = 0;
+	}
+
+	JoinThreads();
+
+	// Nobody waiting for these tasks must be left hanging
+	RunRemainingTasks();
+}
+
+void ThreadPool::Worker()
+{
+	while (true) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_cv.wait(lock,
+			 [this]() { return _stopWorkers || !_tasks.empty(); });
+		if (_stopWorkers) {
+			return;
+		}
+
+		auto task = std::move(_tasks.front());
+		_tasks.pop_front();
+		lock.unlock();
+		task();
+	}
+}
+
+bool ThreadPool::RunPendingTask()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_tasks.empty()) {
+		return false;
+	}
+
+	auto task = std::move(_tasks.front());
+	_tasks.pop_front();
+	lock.unlock();
+	task();
+	return true;
+}
+
+void ThreadPool::RunRemainingTasks()
+{
+	while (RunPendingTask()) {
+	}
+}
+
+void ThreadPool::StartThreads(size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		_threads.emplace_back(&ThreadPool::Worker, this);
+	}
+}
+
+void ThreadPool::JoinThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopWorkers = true;
+	}
+	_cv.notify_all();
+	for (auto &thread : _threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	_threads.clear();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_stopWorkers = false;
+}
+
+} // namespace advss
@@ -0,0 +1,66 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace advss {
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+// Fixed size thread pool with a single task queue shared by all workers.
+//
+// No threads are started until SetThreadCount() is called.
+class EXPORT ThreadPool {
+public:
+	ThreadPool() = default;
+	~ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	// Waits for the currently running tasks to complete
+	void SetThreadCount(size_t count);
+	size_t GetThreadCount() const;
+
+	// Tasks submitted after Stop() was called or while no worker threads
+	// are available are run on the calling thread
+	[[nodiscard]] std::future<void> Submit(std::function<void()> task);
+
+	// Helps processing queued tasks on the calling thread until the
+	// given future is ready
+	void Wait(const std::future<void> &future);
+
+	// Runs all remaining tasks and stops the worker threads
+	void Stop();
+
+private:
+	void Worker();
+	bool RunPendingTask();
+	void RunRemainingTasks();
+	void StartThreads(size_t count);
+	void JoinThreads();
+
+	std::vector<std::thread> _threads;
+	std::mutex _resizeMutex;
+
+	mutable std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<std::packaged_task<void()>> _tasks;
+	size_t _threadCount = 0;
+	bool _stopWorkers = false;
+	bool _stopped = false;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+} // namespace advss
@@ -0,0 +1,81 @@
+#include "wakeup-helpers.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+
+namespace advss {
+
+static std::array<std::atomic<uint64_t>, 3> wakeupCounts{};
+static std::atomic<uint64_t> totalWakeupCount{0};
+static std::function<void()> notifyCallback;
+static std::mutex callbackMutex;
+
+static std::optional<size_t> getSourceIndex(WakeupSource source)
+{
+	switch (source) {
+	case WakeupSource::FRONTEND_EVENT:
+		return 0;
+	case WakeupSource::VARIABLE_CHANGE:
+		return 1;
+	case WakeupSource::MESSAGE:
+		return 2;
+	default:
+		break;
+	}
+	return {};
+}
+
+bool WakeupSnapshot::FiredSince(const WakeupSnapshot &previous,
+				WakeupSource sources) const
+{
+	for (const auto source :
+	     {WakeupSource::FRONTEND_EVENT, WakeupSource::VARIABLE_CHANGE,
+	      WakeupSource::MESSAGE}) {
+		if (!(sources & source)) {
+			continue;
+		}
+		const auto idx = *getSourceIndex(source);
+		if (counts[idx] != previous.counts[idx]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void SignalWakeup(WakeupSource source)
+{
+	const auto idx = getSourceIndex(source);
+	if (!idx) {
+		return;
+	}
+	++wakeupCounts[*idx];
+	++totalWakeupCount;
+
+	std::lock_guard<std::mutex> lock(callbackMutex);
+	if (notifyCallback) {
+		notifyCallback();
+	}
+}
+
+WakeupSnapshot GetWakeupSnapshot()
+{
+	WakeupSnapshot snapshot;
+	for (size_t i = 0; i < wakeupCounts.size(); i++) {
+		snapshot.counts[i] = wakeupCounts[i];
+	}
+	return snapshot;
+}
+
+uint64_t GetWakeupCount()
+{
+	return totalWakeupCount;
+}
+
+void SetWakeupNotifyCallback(const std::function<void()> &callback)
+{
+	std::lock_guard<std::mutex> lock(callbackMutex);
+	notifyCallback = callback;
+}
+
+} // namespace advss
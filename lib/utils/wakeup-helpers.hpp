@@ -0,0 +1,49 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+namespace advss {
+
+// Sources which can cause the conditions of a macro to be re-evaluated when
+// event driven macro checks are enabled.
+//
+// Conditions which are not able to declare the sources their state depends on
+// use POLL and are thus re-evaluated every interval.
+enum class WakeupSource : uint32_t {
+	NONE = 0,
+	POLL = 1 << 0,
+	FRONTEND_EVENT = 1 << 1,
+	VARIABLE_CHANGE = 1 << 2,
+	MESSAGE = 1 << 3,
+};
+
+constexpr WakeupSource operator|(WakeupSource lhs, WakeupSource rhs)
+{
+	return static_cast<WakeupSource>(static_cast<uint32_t>(lhs) |
+					 static_cast<uint32_t>(rhs));
+}
+
+constexpr bool operator&(WakeupSource lhs, WakeupSource rhs)
+{
+	return (static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs)) != 0;
+}
+
+// Number of times each of the event based wakeup sources fired
+struct WakeupSnapshot {
+	bool FiredSince(const WakeupSnapshot &, WakeupSource) const;
+
+	std::array<uint64_t, 3> counts{};
+};
+
+// Can be called from any thread
+EXPORT void SignalWakeup(WakeupSource);
+EXPORT WakeupSnapshot GetWakeupSnapshot();
+uint64_t GetWakeupCount();
+
+// Used by the main loop to get notified about new wakeups
+void SetWakeupNotifyCallback(const std::function<void()> &);
+
+} // namespace advss
@@ -1,19 +1,116 @@
 #include "variable-string.hpp"
-#include "utility.hpp"
 
 namespace advss {
 
+static const std::string variablePrefix = "${";
+
+bool StringVariable::ParseIsOutdated() const
+{
+	// Variables are added to the list after they were constructed, so the
+	// variable count has to be checked in addition to the generation.
+	// Not all ways of renaming a variable update the structure generation,
+	// so the item name generation has to be checked as well.
+	return _structureGeneration != GetVariableStructureGeneration() ||
+	       _nameGeneration != GetItemNameGeneration() ||
+	       _variableCount != GetVariables().size();
+}
+
+void StringVariable::Parse() const
+{
+	_tokens.clear();
+	_structureGeneration = GetVariableStructureGeneration();
+	_nameGeneration = GetItemNameGeneration();
+	_variableCount = GetVariables().size();
+	_mayContainVariables = _value.find(variablePrefix) != std::string::npos;
+	_parsed = true;
+
+	std::string literal;
+	size_t pos = 0;
+	while (pos < _value.size()) {
+		const auto start = _value.find(variablePrefix, pos);
+		if (start == std::string::npos) {
+			literal += _value.substr(pos);
+			break;
+		}
+		literal += _value.substr(pos, start - pos);
+
+		// Variable names might contain '}' so the first closing bracket
+		// resulting in the name of an existing variable is used
+		const auto nameStart = start + variablePrefix.size();
+		bool foundVariable = false;
+		for (auto end = _value.find('}', nameStart);
+		     end != std::string::npos;
+		     end = _value.find('}', end + 1)) {
+			auto variable = GetWeakVariableByName(
+				_value.substr(nameStart, end - nameStart));
+			if (variable.expired()) {
+				continue;
+			}
+			if (!literal.empty()) {
+				_tokens.push_back({std::move(literal), {}});
+				literal.clear();
+			}
+			_tokens.push_back({"", variable});
+			pos = end + 1;
+			foundVariable = true;
+			break;
+		}
+
+		if (!foundVariable) {
+			literal += variablePrefix;
+			pos = nameStart;
+		}
+	}
+
+	if (!literal.empty()) {
+		_tokens.push_back({std::move(literal), {}});
+	}
+}
+
 void StringVariable::Resolve() const
 {
-	if (GetVariables().empty()) {
-		_resolvedValue = _value;
+	if (_parsed && !_mayContainVariables) {
 		return;
 	}
-	if (_lastResolve == GetLastVariableChangeTime()) {
+
+	bool changed = false;
+	if (!_parsed || ParseIsOutdated()) {
+		Parse();
+		changed = true;
+	}
+
+	for (const auto &token : _tokens) {
+		auto variable = token.variable.lock();
+		if (variable &&
+		    variable->GetValueGeneration() != token.valueGeneration) {
+			changed = true;
+			break;
+		}
+	}
+
+	if (!changed) {
 		return;
 	}
-	_resolvedValue = SubstitueVariables(_value);
-	_lastResolve = GetLastVariableChangeTime();
+
+	_resolvedValue.clear();
+	for (const auto &token : _tokens) {
+		auto variable = token.variable.lock();
+		if (!variable) {
+			_resolvedValue += token.text;
+			continue;
+		}
+		// Read the generation first so a concurrent change of the value
+		// will be picked up by the next call to Resolve()
+		token.valueGeneration = variable->GetValueGeneration();
+		_resolvedValue += variable->Value(false);
+		variable->UpdateLastUsed();
+	}
+}
+
+void StringVariable::Invalidate()
+{
+	_parsed = false;
+	_tokens.clear();
 }
 
 StringVariable::operator std::string() const
@@ -30,19 +127,19 @@ StringVariable::operator QVariant() const
 void StringVariable::operator=(std::string value)
 {
 	_value = value;
-	_lastResolve = {};
+	Invalidate();
 }
 
 void StringVariable::operator=(const char *value)
 {
 	_value = value;
-	_lastResolve = {};
+	Invalidate();
 }
 
 void StringVariable::Load(obs_data_t *obj, const char *name)
 {
 	_value = obs_data_get_string(obj, name);
-	_lastResolve = {};
+	Invalidate();
 	Resolve();
 }
 
@@ -55,6 +152,26 @@ void StringVariable::ResolveVariables()
 {
 	Resolve();
 	_value = _resolvedValue;
+	Invalidate();
+}
+
+void StringVariable::VisitSegments(
+	const std::function<void(const std::string &)> &onText,
+	const std::function<void(const Variable &)> &onVariable) const
+{
+	if (!_parsed || ParseIsOutdated()) {
+		Parse();
+	}
+
+	for (const auto &token : _tokens) {
+		auto variable = token.variable.lock();
+		if (!variable) {
+			onText(token.text);
+			continue;
+		}
+		onVariable(*variable);
+		variable->UpdateLastUsed();
+	}
 }
 
 const char *StringVariable::c_str()
@@ -77,14 +194,7 @@ bool StringVariable::empty() const
 
 std::string SubstitueVariables(std::string str)
 {
-	for (const auto &v : GetVariables()) {
-		const auto &variable = std::dynamic_pointer_cast<Variable>(v);
-		const std::string pattern = "${" + variable->Name() + "}";
-		if (ReplaceAll(str, pattern, variable->Value(false))) {
-			variable->UpdateLastUsed();
-		}
-	}
-	return str;
+	return StringVariable(std::move(str));
 }
 
 } // namespace advss
@@ -1,7 +1,9 @@
 #pragma once
 #include "variable.hpp"
 
+#include <functional>
 #include <string>
+#include <vector>
 #include <obs-data.h>
 
 namespace advss {
@@ -28,13 +30,35 @@ public:
 	EXPORT void Save(obs_data_t *obj, const char *name) const;
 
 	EXPORT void ResolveVariables();
+	// Calls onText for each literal part of the unresolved value and
+	// onVariable for each reference to a variable in order
+	EXPORT void VisitSegments(
+		const std::function<void(const std::string &)> &onText,
+		const std::function<void(const Variable &)> &onVariable) const;
 
 private:
+	// The unresolved value is split into literal text and references to
+	// variables, so it only has to be parsed again if variables are added,
+	// removed, or renamed
+	struct Token {
+		std::string text;
+		std::weak_ptr<Variable> variable;
+		mutable uint64_t valueGeneration = 0;
+	};
+
 	void Resolve() const;
+	void Parse() const;
+	bool ParseIsOutdated() const;
+	void Invalidate();
 
 	std::string _value = "";
 	mutable std::string _resolvedValue = "";
-	mutable std::chrono::high_resolution_clock::time_point _lastResolve{};
+	mutable std::vector<Token> _tokens;
+	mutable bool _parsed = false;
+	mutable bool _mayContainVariables = false;
+	mutable uint64_t _structureGeneration = 0;
+	mutable uint64_t _nameGeneration = 0;
+	mutable size_t _variableCount = 0;
 };
 
 std::string SubstitueVariables(std::string str);
@@ -1,27 +1,30 @@
 #include "variable.hpp"
 #include "math-helpers.hpp"
+#include "name-index.hpp"
 #include "obs-module-helper.hpp"
 #include "ui-helpers.hpp"
 #include "utility.hpp"
+#include "wakeup-helpers.hpp"
 
 #include <QGridLayout>
 
 namespace advss {
 
 static std::deque<std::shared_ptr<Item>> variables;
+static NameIndex<Item> variableIndex(variables, GetItemNameGeneration);
 
-// Keep track of the last time a variable was changed to save some work when
-// when resolving strings containing variables, etc.
-static std::chrono::high_resolution_clock::time_point lastVariableChange{};
+// Incremented whenever variables are added, removed, or renamed to allow
+// strings referencing variables to detect when they need to be parsed again
+static std::atomic_uint64_t variableStructureGeneration = 0;
 
 Variable::Variable() : Item()
 {
-	lastVariableChange = std::chrono::high_resolution_clock::now();
+	++variableStructureGeneration;
 }
 
 Variable::~Variable()
 {
-	lastVariableChange = std::chrono::high_resolution_clock::now();
+	++variableStructureGeneration;
 }
 
 void Variable::Load(obs_data_t *obj)
@@ -37,7 +40,7 @@ void Variable::Load(obs_data_t *obj)
 		SetValue(_defaultValue);
 	}
 
-	lastVariableChange = std::chrono::high_resolution_clock::now();
+	++variableStructureGeneration;
 }
 
 void Variable::Save(obs_data_t *obj) const
@@ -74,13 +77,24 @@ std::optional<int> Variable::IntValue() const
 
 void Variable::SetValue(const std::string &value)
 {
-	std::lock_guard<std::mutex> lock(_mutex);
+	std::unique_lock<std::mutex> lock(_mutex);
+	const bool valueChanged = _value != value;
 	_previousValue = _value;
 	_value = value;
+	if (valueChanged) {
+		++_valueGeneration;
+		if (_saveAction == SaveAction::SAVE) {
+			SettingsModified();
+		}
+	}
 
 	UpdateLastUsed();
 	UpdateLastChanged();
-	lastVariableChange = std::chrono::high_resolution_clock::now();
+	lock.unlock();
+
+	if (valueChanged) {
+		SignalWakeup(WakeupSource::VARIABLE_CHANGE);
+	}
 }
 
 void Variable::SetValue(double value)
@@ -200,13 +214,14 @@ bool VariableSettingsDialog::AskForSettings(QWidget *parent, Variable &settings)
 		return false;
 	}
 
-	settings._name = dialog._name->text().toStdString();
+	settings.SetName(dialog._name->text().toStdString());
 	settings.SetValue(dialog._value->toPlainText().toStdString());
 	settings._defaultValue =
 		dialog._defaultValue->toPlainText().toStdString();
 	settings._saveAction =
 		static_cast<Variable::SaveAction>(dialog._save->currentIndex());
-	lastVariableChange = std::chrono::high_resolution_clock::now();
+	settings.SettingsModified();
+	++variableStructureGeneration;
 
 	return true;
 }
@@ -332,13 +347,7 @@ std::deque<std::shared_ptr<Item>> &GetVariables()
 
 Variable *GetVariableByName(const std::string &name)
 {
-	for (const auto &v : variables) {
-		if (v->Name() == name) {
-			return dynamic_cast<Variable *>(v.get());
-		}
-	}
-
-	return nullptr;
+	return dynamic_cast<Variable *>(variableIndex.Find(name).get());
 }
 
 Variable *GetVariableByQString(const QString &name)
@@ -348,15 +357,7 @@ Variable *GetVariableByQString(const QString &name)
 
 std::weak_ptr<Variable> GetWeakVariableByName(const std::string &name)
 {
-	for (const auto &v : variables) {
-		if (v->Name() == name) {
-			std::weak_ptr<Variable> wp =
-				std::dynamic_pointer_cast<Variable>(v);
-			return wp;
-		}
-	}
-
-	return std::weak_ptr<Variable>();
+	return std::dynamic_pointer_cast<Variable>(variableIndex.Find(name));
 }
 
 std::weak_ptr<Variable> GetWeakVariableByQString(const QString &name)
@@ -395,10 +396,9 @@ void SaveVariables(obs_data_t *obj)
 {
 	obs_data_array_t *variablesArray = obs_data_array_create();
 	for (const auto &v : variables) {
-		obs_data_t *array_obj = obs_data_create();
-		v->Save(array_obj);
-		obs_data_array_push_back(variablesArray, array_obj);
-		obs_data_release(array_obj);
+		obs_data_t *data = v->GetSaveData();
+		obs_data_array_push_back(variablesArray, data);
+		obs_data_release(data);
 	}
 
 	obs_data_set_array(obj, "variables", variablesArray);
@@ -459,9 +459,9 @@ void ImportVariables(obs_data_t *data)
 	QeueUITask(signalImportedVariables, importedVars);
 }
 
-std::chrono::high_resolution_clock::time_point GetLastVariableChangeTime()
+uint64_t GetVariableStructureGeneration()
 {
-	return lastVariableChange;
+	return variableStructureGeneration;
 }
 
 } // namespace advss
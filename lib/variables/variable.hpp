@@ -3,6 +3,7 @@
 #include "item-selection-helpers.hpp"
 #include "resizing-text-edit.hpp"
 
+#include <atomic>
 #include <mutex>
 #include <obs-data.h>
 #include <optional>
@@ -40,6 +41,8 @@ public:
 	void SetValue(double value);
 	SaveAction GetSaveAction() const { return _saveAction; }
 	int GetValueChangeCount() const { return _valueChangeCount; }
+	// Incremented every time the value changes
+	uint64_t GetValueGeneration() const { return _valueGeneration; }
 	std::optional<uint64_t> GetSecondsSinceLastUse() const;
 	std::optional<uint64_t> GetSecondsSinceLastChange() const;
 	void UpdateLastUsed() const;
@@ -51,6 +54,7 @@ private:
 	std::string _previousValue = "";
 	std::string _defaultValue = "";
 	int _valueChangeCount = 0;
+	std::atomic_uint64_t _valueGeneration = 0;
 	mutable std::chrono::high_resolution_clock::time_point _lastUsed;
 	mutable std::chrono::high_resolution_clock::time_point _lastChanged;
 	mutable std::mutex _mutex;
@@ -119,6 +123,6 @@ void SaveVariables(obs_data_t *obj);
 void LoadVariables(obs_data_t *obj);
 void ImportVariables(obs_data_t *obj);
 
-std::chrono::high_resolution_clock::time_point GetLastVariableChangeTime();
+uint64_t GetVariableStructureGeneration();
 
 } // namespace advss
@@ -5,6 +5,7 @@
 #include "selection-helpers.hpp"
 
 #include <chrono>
+#include <cmath>
 
 namespace advss {
 
@@ -44,155 +45,51 @@ static const std::map<MacroActionAudio::FadeType, std::string> fadeTypes = {
 	 "AdvSceneSwitcher.action.audio.fade.type.rate"},
 };
 
-namespace {
-struct FadeInfo {
-	std::atomic_bool active = {false};
-	std::atomic_int id = {0};
+static const std::map<VolumeFadeCurve, std::string> fadeCurves = {
+	{VolumeFadeCurve::LINEAR,
+	 "AdvSceneSwitcher.action.audio.fade.curve.linear"},
+	{VolumeFadeCurve::DB_LINEAR,
+	 "AdvSceneSwitcher.action.audio.fade.curve.dBLinear"},
+	{VolumeFadeCurve::S_CURVE,
+	 "AdvSceneSwitcher.action.audio.fade.curve.sCurve"},
 };
-} // namespace
-
-static FadeInfo masterAudioFade;
-static std::unordered_map<std::string, FadeInfo> audioFades;
-
-constexpr auto fadeInterval = std::chrono::milliseconds(100);
-constexpr float minFade = 0.000001f;
-
-// For backwards compatibility
-#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(29, 0, 0)
-static float get_master_volume()
-{
-	return 1.f;
-}
-
-static void set_master_volume(float)
-{
-	return;
-}
-#else
-auto get_master_volume = obs_get_master_volume;
-auto set_master_volume = obs_set_master_volume;
-#endif
-
-void MacroActionAudio::SetFadeActive(bool value) const
-{
-	if (_action == Action::SOURCE_VOLUME) {
-		audioFades[_audioSource.ToString()].active = value;
-	} else {
-		masterAudioFade.active = value;
-	}
-}
-
-bool MacroActionAudio::FadeActive() const
-{
-	bool active = true;
-	if (_action == Action::SOURCE_VOLUME) {
-		auto it = audioFades.find(_audioSource.ToString());
-		if (it == audioFades.end()) {
-			return false;
-		}
-		active = it->second.active;
-	} else {
-		active = masterAudioFade.active;
-	}
-
-	return active;
-}
-
-std::atomic_int *MacroActionAudio::GetFadeIdPtr() const
-{
-
-	if (_action == Action::SOURCE_VOLUME) {
-		auto it = audioFades.find(_audioSource.ToString());
-		if (it == audioFades.end()) {
-			return nullptr;
-		}
-		return &it->second.id;
-	}
-	return &masterAudioFade.id;
-}
 
 float MacroActionAudio::GetVolume() const
 {
 	return _useDb ? DecibelToPercent(_volumeDB) : (float)_volume / 100.0f;
 }
 
-void MacroActionAudio::SetVolume(float vol) const
+OBSWeakSource MacroActionAudio::GetFadeSource() const
 {
-	if (_action == Action::SOURCE_VOLUME) {
-		auto s = obs_weak_source_get_source(_audioSource.GetSource());
-		obs_source_set_volume(s, vol);
-		obs_source_release(s);
-	} else {
-		set_master_volume(vol);
-	}
+	return _action == Action::SOURCE_VOLUME ? _audioSource.GetSource()
+						: OBSWeakSource();
 }
 
-float MacroActionAudio::GetCurrentVolume() const
+std::chrono::milliseconds MacroActionAudio::GetFadeDuration() const
 {
-	float curVol;
-	if (_action == Action::SOURCE_VOLUME) {
-		auto s = obs_weak_source_get_source(_audioSource.GetSource());
-		if (!s) {
-			return 0.;
-		}
-		curVol = obs_source_get_volume(s);
-		obs_source_release(s);
-	} else {
-		curVol = get_master_volume();
-	}
-	return curVol;
-}
-
-void MacroActionAudio::FadeVolume() const
-{
-	float vol = GetVolume();
-	float curVol = GetCurrentVolume();
-	bool volIncrease = curVol <= vol;
-	float volDiff = (volIncrease) ? vol - curVol : curVol - vol;
-	int nrSteps = 0;
-	float volStep = 0.;
 	if (_fadeType == FadeType::DURATION) {
-		nrSteps = _duration.Milliseconds() / fadeInterval.count();
-		volStep = volDiff / nrSteps;
-	} else {
-		volStep = _rate / 1000.0f;
-		nrSteps = volDiff / volStep;
-	}
-
-	if (volStep < minFade || nrSteps <= 1) {
-		SetVolume(vol);
-		SetFadeActive(false);
-		return;
-	}
-
-	auto macro = GetMacro();
-	int step = 0;
-	auto fadeId = GetFadeIdPtr();
-	int expectedFadeId = ++(*fadeId);
-	for (; step < nrSteps && !MacroIsStopped(macro) &&
-	       expectedFadeId == *fadeId;
-	     ++step) {
-		curVol = (volIncrease) ? curVol + volStep : curVol - volStep;
-		SetVolume(curVol);
-		std::this_thread::sleep_for(fadeInterval);
+		return std::chrono::milliseconds(
+			static_cast<int64_t>(_duration.Milliseconds()));
 	}
 
-	// As a final step set desired volume once again in case floating-point
-	// precision errors compounded to a noticeable error
-	if (step == nrSteps) {
-		SetVolume(vol);
+	const double volumeDiff =
+		std::abs(GetVolume() - GetAudioVolume(GetFadeSource()));
+	const double ratePerMs = _rate / 100. / 1000.;
+	if (ratePerMs <= 0.) {
+		return std::chrono::milliseconds(0);
 	}
-
-	SetFadeActive(false);
+	return std::chrono::milliseconds(
+		static_cast<int64_t>(volumeDiff / ratePerMs));
 }
 
 void MacroActionAudio::StartFade() const
 {
-	if (_action == Action::SOURCE_VOLUME && !_audioSource.GetSource()) {
+	const auto source = GetFadeSource();
+	if (_action == Action::SOURCE_VOLUME && !source) {
 		return;
 	}
 
-	if (FadeActive() && !_abortActiveFade) {
+	if (VolumeFadeActive(source) && !_abortActiveFade) {
 		blog(LOG_WARNING,
 		     "Audio fade for volume of %s already active! New fade request will be ignored!",
 		     (_action == Action::SOURCE_VOLUME)
@@ -200,14 +97,12 @@ void MacroActionAudio::StartFade() const
 			     : "master volume");
 		return;
 	}
-	SetFadeActive(true);
 
+	const auto id =
+		StartVolumeFade(source, GetVolume(), GetFadeDuration(),
+				_fadeCurve, GetMacroStopCheck(GetMacro()));
 	if (_wait) {
-		FadeVolume();
-	} else {
-		AddMacroHelperThread(GetMacro(),
-				     std::thread(&MacroActionAudio::FadeVolume,
-						 this));
+		WaitForVolumeFade(id);
 	}
 }
 
@@ -260,7 +155,7 @@ bool MacroActionAudio::PerformAction()
 		if (_fade) {
 			StartFade();
 		} else {
-			SetVolume(GetVolume());
+			SetAudioVolume(GetFadeSource(), GetVolume());
 		}
 		break;
 	case Action::SYNC_OFFSET:
@@ -314,6 +209,7 @@ bool MacroActionAudio::Save(obs_data_t *obj) const
 	_rate.Save(obj, "rate");
 	obs_data_set_bool(obj, "fade", _fade);
 	obs_data_set_int(obj, "fadeType", static_cast<int>(_fadeType));
+	obs_data_set_int(obj, "fadeCurve", static_cast<int>(_fadeCurve));
 	obs_data_set_bool(obj, "wait", _wait);
 	obs_data_set_bool(obj, "abortActiveFade", _abortActiveFade);
 	obs_data_set_bool(obj, "useDb", _useDb);
@@ -353,6 +249,8 @@ bool MacroActionAudio::Load(obs_data_t *obj)
 	} else {
 		_fadeType = FadeType::DURATION;
 	}
+	_fadeCurve = static_cast<VolumeFadeCurve>(
+		obs_data_get_int(obj, "fadeCurve"));
 	if (obs_data_has_user_value(obj, "abortActiveFade")) {
 		_abortActiveFade = obs_data_get_bool(obj, "abortActiveFade");
 	} else {
@@ -421,6 +319,13 @@ static inline void populateFadeTypeSelection(QComboBox *list)
 	}
 }
 
+static inline void populateFadeCurveSelection(QComboBox *list)
+{
+	for (const auto &[_, name] : fadeCurves) {
+		list->addItem(obs_module_text(name.c_str()));
+	}
+}
+
 static QStringList getAudioSourcesList()
 {
 	auto sources = GetAudioSourceNames();
@@ -434,6 +339,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	  _sources(new SourceSelectionWidget(this, getAudioSourcesList, true)),
 	  _actions(new QComboBox),
 	  _fadeTypes(new QComboBox),
+	  _fadeCurves(new QComboBox),
 	  _syncOffset(new VariableSpinBox),
 	  _monitorTypes(new QComboBox),
 	  _balance(new SliderSpinBox(
@@ -452,6 +358,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	  _abortActiveFade(new QCheckBox(
 		  obs_module_text("AdvSceneSwitcher.action.audio.fade.abort"))),
 	  _fadeTypeLayout(new QHBoxLayout),
+	  _fadeCurveLayout(new QHBoxLayout),
 	  _fadeOptionsLayout(new QVBoxLayout)
 {
 	_syncOffset->setMinimum(-950);
@@ -476,6 +383,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 
 	populateActionSelection(_actions);
 	populateFadeTypeSelection(_fadeTypes);
+	populateFadeCurveSelection(_fadeCurves);
 	PopulateMonitorTypeSelection(_monitorTypes);
 
 	QWidget::connect(_actions, SIGNAL(currentIndexChanged(int)), this,
@@ -521,6 +429,8 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 			 SLOT(AbortActiveFadeChanged(int)));
 	QWidget::connect(_fadeTypes, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(FadeTypeChanged(int)));
+	QWidget::connect(_fadeCurves, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(FadeCurveChanged(int)));
 
 	const std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{audioSources}}", _sources},
@@ -538,6 +448,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 		{"{{wait}}", _wait},
 		{"{{abortActiveFade}}", _abortActiveFade},
 		{"{{fadeTypes}}", _fadeTypes},
+		{"{{fadeCurves}}", _fadeCurves},
 	};
 	QHBoxLayout *entryLayout = new QHBoxLayout;
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.action.audio.entry"),
@@ -547,7 +458,12 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 		obs_module_text("AdvSceneSwitcher.action.audio.fade.duration"),
 		_fadeTypeLayout, widgetPlaceholders);
 
+	PlaceWidgets(
+		obs_module_text("AdvSceneSwitcher.action.audio.fade.curve"),
+		_fadeCurveLayout, widgetPlaceholders);
+
 	_fadeOptionsLayout->addLayout(_fadeTypeLayout);
+	_fadeOptionsLayout->addLayout(_fadeCurveLayout);
 	_fadeOptionsLayout->addWidget(_abortActiveFade);
 	_fadeOptionsLayout->addWidget(_wait);
 
@@ -627,6 +543,9 @@ void MacroActionAudioEdit::SetWidgetVisibility()
 	_duration->setEnabled(_entryData->_fade);
 	_rate->setEnabled(_entryData->_fade);
 	_fadeTypes->setEnabled(_entryData->_fade);
+	SetLayoutVisible(_fadeCurveLayout,
+			 hasVolumeControl(_entryData->_action) &&
+				 _entryData->_fade);
 
 	// TODO: Remove this in a future version:
 	if (_entryData->_action != MacroActionAudio::Action::MASTER_VOLUME &&
@@ -661,6 +580,7 @@ void MacroActionAudioEdit::UpdateEntryData()
 	_wait->setChecked(_entryData->_wait);
 	_abortActiveFade->setChecked(_entryData->_abortActiveFade);
 	_fadeTypes->setCurrentIndex(static_cast<int>(_entryData->_fadeType));
+	_fadeCurves->setCurrentIndex(static_cast<int>(_entryData->_fadeCurve));
 	SetWidgetVisibility();
 }
 
@@ -761,4 +681,10 @@ void MacroActionAudioEdit::FadeTypeChanged(int value)
 	SetWidgetVisibility();
 }
 
+void MacroActionAudioEdit::FadeCurveChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_fadeCurve = static_cast<VolumeFadeCurve>(value);
+}
+
 } // namespace advss
@@ -3,6 +3,7 @@
 #include "duration-control.hpp"
 #include "slider-spinbox.hpp"
 #include "source-selection.hpp"
+#include "volume-fade.hpp"
 
 #include <QCheckBox>
 #include <QHBoxLayout>
@@ -43,6 +44,7 @@ public:
 
 	Action _action = Action::MUTE;
 	FadeType _fadeType = FadeType::DURATION;
+	VolumeFadeCurve _fadeCurve = VolumeFadeCurve::LINEAR;
 	IntVariable _syncOffset = 0;
 	obs_monitoring_type _monitorType = OBS_MONITORING_TYPE_NONE;
 	DoubleVariable _balance = 0.5;
@@ -58,12 +60,8 @@ public:
 
 private:
 	void StartFade() const;
-	void FadeVolume() const;
-	void SetVolume(float vol) const;
-	float GetCurrentVolume() const;
-	void SetFadeActive(bool value) const;
-	bool FadeActive() const;
-	std::atomic_int *GetFadeIdPtr() const;
+	OBSWeakSource GetFadeSource() const;
+	std::chrono::milliseconds GetFadeDuration() const;
 	float GetVolume() const;
 
 	static bool _registered;
@@ -102,6 +100,7 @@ private slots:
 	void WaitChanged(int value);
 	void AbortActiveFadeChanged(int value);
 	void FadeTypeChanged(int value);
+	void FadeCurveChanged(int value);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -109,6 +108,7 @@ protected:
 	SourceSelectionWidget *_sources;
 	QComboBox *_actions;
 	QComboBox *_fadeTypes;
+	QComboBox *_fadeCurves;
 	VariableSpinBox *_syncOffset;
 	QComboBox *_monitorTypes;
 	SliderSpinBox *_balance;
@@ -122,6 +122,7 @@ protected:
 	QCheckBox *_wait;
 	QCheckBox *_abortActiveFade;
 	QHBoxLayout *_fadeTypeLayout;
+	QHBoxLayout *_fadeCurveLayout;
 	QVBoxLayout *_fadeOptionsLayout;
 	std::shared_ptr<MacroActionAudio> _entryData;
 
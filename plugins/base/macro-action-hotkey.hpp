@@ -16,6 +16,8 @@ public:
 	void LogAction() const;
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
+	// Hotkeys registered by OBS can be changed without editing the action
+	bool SettingsChangeAtRuntime() const { return true; }
 	std::string GetId() const { return id; };
 	static std::shared_ptr<MacroAction> Create(Macro *m);
 	std::shared_ptr<MacroAction> Copy() const;
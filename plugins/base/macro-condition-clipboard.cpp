@@ -153,6 +153,14 @@ void MacroConditionClipboard::SetCondition(Condition condition)
 	}
 }
 
+WakeupSource MacroConditionClipboard::GetConditionWakeupSources() const
+{
+	if (_condition == Condition::CHANGED) {
+		return WakeupSource::MESSAGE;
+	}
+	return WakeupSource::POLL;
+}
+
 void MacroConditionClipboard::SetupTempVars()
 {
 	MacroCondition::SetupTempVars();
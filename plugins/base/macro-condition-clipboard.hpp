@@ -53,6 +53,7 @@ public:
 	RegexConfig _regex;
 
 private:
+	WakeupSource GetConditionWakeupSources() const;
 	void SetupTempVars();
 
 	Condition _condition = Condition::CHANGED;
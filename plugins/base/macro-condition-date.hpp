@@ -15,6 +15,10 @@ public:
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
+	bool SettingsChangeAtRuntime() const
+	{
+		return _repeat && _updateOnRepeat;
+	}
 	std::string GetShortDesc() const;
 	std::string GetId() const { return id; };
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
@@ -1,11 +1,10 @@
 #include "macro-condition-file.hpp"
-#include "curl-helper.hpp"
 #include "layout-helpers.hpp"
-#include "plugin-state-helpers.hpp"
+#include "remote-file-cache.hpp"
 #include "utility.hpp"
 
 #include <QFileDialog>
-#include <QTextStream>
+#include <QFileInfo>
 #include <regex>
 
 namespace advss {
@@ -17,118 +16,161 @@ bool MacroConditionFile::_registered = MacroConditionFactory::Register(
 	{MacroConditionFile::Create, MacroConditionFileEdit::Create,
 	 "AdvSceneSwitcher.condition.file"});
 
-static std::hash<std::string> strHash;
-
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb,
-			    void *userp)
+void MacroConditionFile::SetCondition(Condition condition)
 {
-	((std::string *)userp)->append((char *)contents, size * nmemb);
-	return size * nmemb;
+	_condition = condition;
+	SetupTempVars();
 }
 
-static std::string getRemoteData(std::string &url)
+bool MacroConditionFile::Matches(const std::string &data)
 {
-	std::string readBuffer;
-	CurlHelper::SetOpt(CURLOPT_URL, url.c_str());
-	CurlHelper::SetOpt(CURLOPT_WRITEFUNCTION, WriteCallback);
-	CurlHelper::SetOpt(CURLOPT_WRITEDATA, &readBuffer);
-	// Set timeout to at least one second
-	int timeout = GetIntervalValue() / 1000;
-	if (timeout == 0) {
-		timeout = 1;
+	if (_regex.Enabled()) {
+		return _regex.Matches(data, _text);
 	}
-	CurlHelper::SetOpt(CURLOPT_TIMEOUT, 1);
-	CurlHelper::Perform();
-	return readBuffer;
-}
 
-void MacroConditionFile::SetCondition(Condition condition)
-{
-	_condition = condition;
-	SetupTempVars();
+	QString text = QString::fromStdString(_text);
+	QString filedata = QString::fromStdString(data);
+	return CompareIgnoringLineEnding(text, filedata);
 }
 
-bool MacroConditionFile::MatchFileContent(QString &filedata)
+bool MacroConditionFile::MatchFileContent(const std::string &data,
+					  uint64_t hash)
 {
 	if (_onlyMatchIfChanged) {
-		size_t newHash = strHash(filedata.toUtf8().constData());
-		if (newHash == _lastHash) {
+		if (hash == _lastHash) {
 			return false;
 		}
-		_lastHash = newHash;
+		_lastHash = hash;
 	}
 
-	if (_regex.Enabled()) {
-		return _regex.Matches(filedata, QString::fromStdString(_text));
+	MatchResult result;
+	result.hash = hash;
+	result.text = _text;
+	result.useRegex = _regex.Enabled();
+	result.partialMatch = _regex.PartialMatchEnabled();
+	result.options = _regex.GetPatternOptions();
+	if (_lastMatch && _lastMatch->hash == result.hash &&
+	    _lastMatch->text == result.text &&
+	    _lastMatch->useRegex == result.useRegex &&
+	    _lastMatch->partialMatch == result.partialMatch &&
+	    _lastMatch->options == result.options) {
+		return _lastMatch->matched;
 	}
 
-	QString text = QString::fromStdString(_text);
-	return CompareIgnoringLineEnding(text, filedata);
+	result.matched = Matches(data);
+	_lastMatch = result;
+	return result.matched;
 }
 
-bool MacroConditionFile::CheckRemoteFileContent()
+void MacroConditionFile::SetContentValues(const std::string &data,
+					  uint64_t hash)
 {
-	std::string path = _file;
-	std::string data = getRemoteData(path);
+	// Avoid copying the whole file content, if it did not change since
+	// the values were last set
+	const bool referencedInVars = IsReferencedInVars();
+	if (_lastContentHash == hash &&
+	    _lastContentReferencedInVars == referencedInVars) {
+		RevalidateTempVarValue("content");
+		return;
+	}
+
+	_lastContentHash = hash;
+	_lastContentReferencedInVars = referencedInVars;
 	SetVariableValue(data);
 	SetTempVarValue("content", data);
-	QString qdata = QString::fromStdString(data);
-	return MatchFileContent(qdata);
+}
+
+bool MacroConditionFile::CheckRemoteFileContent()
+{
+	const auto content = GetRemoteFileContent(_file, GetRefreshInterval());
+	if (!content) {
+		return false;
+	}
+
+	SetContentValues(*content->data, content->hash);
+	return MatchFileContent(*content->data, content->hash);
 }
 
 bool MacroConditionFile::CheckLocalFileContent()
 {
-	QFile file(QString::fromStdString(_file));
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+	const std::string path = _file;
+	const auto content = GetFileContent(path);
+	if (!content) {
 		return false;
 	}
 
 	if (_useTime) {
-		QDateTime newLastMod = QFileInfo(file).lastModified();
+		QDateTime newLastMod =
+			QFileInfo(QString::fromStdString(path)).lastModified();
 		if (_lastMod == newLastMod) {
 			return false;
 		}
 		_lastMod = newLastMod;
 	}
 
-	QString filedata = QTextStream(&file).readAll();
-	SetVariableValue(filedata.toStdString());
-	SetTempVarValue("content", filedata.toStdString());
-	bool match = MatchFileContent(filedata);
-
-	file.close();
-	return match;
+	SetContentValues(*content->data, content->hash);
+	return MatchFileContent(*content->data, content->hash);
 }
 
 bool MacroConditionFile::CheckChangeContent()
 {
-	QString filedata;
+	std::string path = _file;
+	uint64_t newHash = 0;
 	switch (_fileType) {
 	case FileType::LOCAL: {
-		std::string path = _file;
-		QFile file(QString::fromStdString(path));
-		if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		const auto content = GetFileContent(path);
+		if (!content) {
 			return false;
 		}
-		filedata = QTextStream(&file).readAll();
-		file.close();
+		SetTempVarValue("content", *content->data);
+		newHash = content->hash;
 	} break;
 	case FileType::REMOTE: {
-		std::string path = _file;
-		std::string data = getRemoteData(path);
-		QString filedata = QString::fromStdString(data);
+		const auto content =
+			GetRemoteFileContent(path, GetRefreshInterval());
+		if (!content) {
+			return false;
+		}
+		SetTempVarValue("content", *content->data);
+		newHash = content->hash;
 	} break;
 	default:
 		break;
 	}
 
-	SetTempVarValue("content", filedata.toStdString());
-	size_t newHash = strHash(filedata.toUtf8().constData());
 	const bool contentChanged = newHash != _lastHash;
 	_lastHash = newHash;
 	return contentChanged;
 }
 
+std::chrono::milliseconds MacroConditionFile::GetRefreshInterval() const
+{
+	return std::chrono::milliseconds(
+		static_cast<int64_t>(_refreshInterval.Milliseconds()));
+}
+
+bool MacroConditionFile::CheckNewLines()
+{
+	if (_fileType == FileType::REMOTE) {
+		return false;
+	}
+
+	std::vector<std::string> lines;
+	if (!ReadNewFileLines(_file, _tailPosition, lines)) {
+		return false;
+	}
+
+	for (const auto &line : lines) {
+		if (!Matches(line)) {
+			continue;
+		}
+		SetVariableValue(line);
+		SetTempVarValue("content", line);
+		return true;
+	}
+	return false;
+}
+
 bool MacroConditionFile::CheckChangeDate()
 {
 	if (_fileType == FileType::REMOTE) {
@@ -147,6 +189,8 @@ bool MacroConditionFile::CheckChangeDate()
 void MacroConditionFile::SetupTempVars()
 {
 	MacroCondition::SetupTempVars();
+	// The values of the new temp vars are not set yet
+	_lastContentHash.reset();
 	if (_condition == Condition::DATE_CHANGE) {
 		AddTempvar(
 			"date",
@@ -175,6 +219,9 @@ bool MacroConditionFile::CheckCondition()
 	case Condition::DATE_CHANGE:
 		ret = CheckChangeDate();
 		break;
+	case Condition::NEW_LINE_MATCH:
+		ret = CheckNewLines();
+		break;
 	default:
 		break;
 	}
@@ -195,6 +242,7 @@ bool MacroConditionFile::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
 	obs_data_set_bool(obj, "useTime", _useTime);
 	obs_data_set_bool(obj, "onlyMatchIfChanged", _onlyMatchIfChanged);
+	_refreshInterval.Save(obj, "refreshInterval");
 	return true;
 }
 
@@ -214,6 +262,9 @@ bool MacroConditionFile::Load(obs_data_t *obj)
 		static_cast<Condition>(obs_data_get_int(obj, "condition")));
 	_useTime = obs_data_get_bool(obj, "useTime");
 	_onlyMatchIfChanged = obs_data_get_bool(obj, "onlyMatchIfChanged");
+	if (obs_data_has_user_value(obj, "refreshInterval")) {
+		_refreshInterval.Load(obj, "refreshInterval");
+	}
 	return true;
 }
 
@@ -237,6 +288,8 @@ static void populateConditions(QComboBox *list)
 		"AdvSceneSwitcher.condition.file.type.contentChange"));
 	list->addItem(obs_module_text(
 		"AdvSceneSwitcher.condition.file.type.dateChange"));
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.file.type.newLineMatch"));
 }
 
 MacroConditionFileEdit::MacroConditionFileEdit(
@@ -249,8 +302,10 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 	  _regex(new RegexConfigWidget(parent)),
 	  _checkModificationDate(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.fileTab.checkfileContentTime"))),
-	  _checkFileContent(new QCheckBox(
-		  obs_module_text("AdvSceneSwitcher.fileTab.checkfileContent")))
+	  _checkFileContent(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.fileTab.checkfileContent"))),
+	  _refreshInterval(new DurationSelection(this, false, 0.1)),
+	  _refreshIntervalLayout(new QHBoxLayout())
 {
 	populateFileTypes(_fileTypes);
 	populateConditions(_conditions);
@@ -270,6 +325,9 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 			 this, SLOT(CheckModificationDateChanged(int)));
 	QWidget::connect(_checkFileContent, SIGNAL(stateChanged(int)), this,
 			 SLOT(OnlyMatchIfChangedChanged(int)));
+	QWidget::connect(_refreshInterval,
+			 SIGNAL(DurationChanged(const Duration &)), this,
+			 SLOT(RefreshIntervalChanged(const Duration &)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{fileType}}", _fileTypes},
@@ -279,6 +337,7 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 		{"{{useRegex}}", _regex},
 		{"{{checkModificationDate}}", _checkModificationDate},
 		{"{{checkFileContent}}", _checkFileContent},
+		{"{{refreshInterval}}", _refreshInterval},
 	};
 
 	QVBoxLayout *mainLayout = new QVBoxLayout;
@@ -300,6 +359,11 @@ MacroConditionFileEdit::MacroConditionFileEdit(
 	mainLayout->addLayout(line1Layout);
 	mainLayout->addLayout(line2Layout);
 	mainLayout->addLayout(line3Layout);
+	_refreshIntervalLayout->setContentsMargins(0, 0, 0, 0);
+	PlaceWidgets(obs_module_text(
+			     "AdvSceneSwitcher.condition.file.refreshInterval"),
+		     _refreshIntervalLayout, widgetPlaceholders);
+	mainLayout->addLayout(_refreshIntervalLayout);
 
 	setLayout(mainLayout);
 
@@ -322,6 +386,7 @@ void MacroConditionFileEdit::UpdateEntryData()
 	_regex->SetRegexConfig(_entryData->_regex);
 	_checkModificationDate->setChecked(_entryData->_useTime);
 	_checkFileContent->setChecked(_entryData->_onlyMatchIfChanged);
+	_refreshInterval->SetDuration(_entryData->_refreshInterval);
 
 	// TODO: Remove in future version
 	if (!_entryData->_useTime) {
@@ -400,16 +465,25 @@ void MacroConditionFileEdit::OnlyMatchIfChangedChanged(int state)
 	_entryData->_onlyMatchIfChanged = state;
 }
 
+void MacroConditionFileEdit::RefreshIntervalChanged(const Duration &duration)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_refreshInterval = duration;
+}
+
 void MacroConditionFileEdit::SetWidgetVisibility()
 {
 	if (!_entryData) {
 		return;
 	}
 
-	_matchText->setVisible(_entryData->GetCondition() ==
-			       MacroConditionFile::Condition::MATCH);
-	_regex->setVisible(_entryData->GetCondition() ==
-			   MacroConditionFile::Condition::MATCH);
+	const bool matchText =
+		_entryData->GetCondition() ==
+			MacroConditionFile::Condition::MATCH ||
+		_entryData->GetCondition() ==
+			MacroConditionFile::Condition::NEW_LINE_MATCH;
+	_matchText->setVisible(matchText);
+	_regex->setVisible(matchText);
 	_checkModificationDate->setVisible(
 		_entryData->_useTime &&
 		_entryData->GetCondition() ==
@@ -424,6 +498,13 @@ void MacroConditionFileEdit::SetWidgetVisibility()
 	// Hide the option for now, if it is not used already.
 	_fileTypes->setVisible(_entryData->_fileType ==
 			       MacroConditionFile::FileType::REMOTE);
+	const bool isRemoteContentCheck =
+		_entryData->_fileType == MacroConditionFile::FileType::REMOTE &&
+		(_entryData->GetCondition() ==
+			 MacroConditionFile::Condition::MATCH ||
+		 _entryData->GetCondition() ==
+			 MacroConditionFile::Condition::CONTENT_CHANGE);
+	SetLayoutVisible(_refreshIntervalLayout, isRemoteContentCheck);
 
 	adjustSize();
 	updateGeometry();
@@ -1,5 +1,7 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "duration-control.hpp"
+#include "file-content-cache.hpp"
 #include "file-selection.hpp"
 #include "variable-text-edit.hpp"
 #include "regex-config.hpp"
@@ -10,6 +12,7 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QCheckBox>
+#include <QHBoxLayout>
 
 namespace advss {
 
@@ -35,6 +38,7 @@ public:
 		MATCH,
 		CONTENT_CHANGE,
 		DATE_CHANGE,
+		NEW_LINE_MATCH,
 	};
 	void SetCondition(Condition condition);
 	Condition GetCondition() const { return _condition; }
@@ -47,18 +51,39 @@ public:
 	bool _useTime = false;
 	bool _onlyMatchIfChanged = false;
 	FileType _fileType = FileType::LOCAL;
+	// How often the content of remote files is fetched in the background
+	Duration _refreshInterval = 1.0;
 
 private:
-	bool MatchFileContent(QString &filedata);
+	void SetContentValues(const std::string &data, uint64_t hash);
+	bool MatchFileContent(const std::string &data, uint64_t hash);
+	bool Matches(const std::string &data);
 	bool CheckRemoteFileContent();
 	bool CheckLocalFileContent();
 	bool CheckChangeContent();
 	bool CheckChangeDate();
+	bool CheckNewLines();
 	void SetupTempVars();
+	std::chrono::milliseconds GetRefreshInterval() const;
+
+	// Matching unchanged file content against the same text will always
+	// yield the same result
+	struct MatchResult {
+		uint64_t hash = 0;
+		std::string text;
+		bool useRegex = false;
+		bool partialMatch = false;
+		QRegularExpression::PatternOptions options;
+		bool matched = false;
+	};
 
 	Condition _condition = Condition::MATCH;
 	QDateTime _lastMod;
-	size_t _lastHash = 0;
+	uint64_t _lastHash = 0;
+	std::optional<MatchResult> _lastMatch;
+	std::optional<uint64_t> _lastContentHash;
+	bool _lastContentReferencedInVars = false;
+	FileTailPosition _tailPosition;
 	static bool _registered;
 	static const std::string id;
 };
@@ -87,6 +112,7 @@ private slots:
 	void RegexChanged(const RegexConfig &);
 	void CheckModificationDateChanged(int state);
 	void OnlyMatchIfChangedChanged(int state);
+	void RefreshIntervalChanged(const Duration &);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -98,6 +124,8 @@ protected:
 	RegexConfigWidget *_regex;
 	QCheckBox *_checkModificationDate;
 	QCheckBox *_checkFileContent;
+	DurationSelection *_refreshInterval;
+	QHBoxLayout *_refreshIntervalLayout;
 	std::shared_ptr<MacroConditionFile> _entryData;
 
 private:
@@ -52,8 +52,8 @@ bool MacroConditionFilter::CheckConditionHelper(const OBSWeakSource &filter)
 		ret = !obs_source_enabled(filterSource);
 		break;
 	case Condition::SETTINGS_MATCH: {
-		ret = CompareSourceSettings(filter, _settings, _regex);
-		const auto settings = GetSourceSettings(filter);
+		ret = _settingsMatcher.Matches(filter, _settings, _regex);
+		const auto &settings = _settingsMatcher.GetSettings();
 		SetVariableValue(settings);
 		SetTempVarValue("settings", settings);
 		break;
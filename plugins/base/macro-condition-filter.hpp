@@ -5,6 +5,7 @@
 #include "source-selection.hpp"
 #include "filter-selection.hpp"
 #include "source-setting.hpp"
+#include "source-settings-helpers.hpp"
 
 #include <QComboBox>
 #include <QPushButton>
@@ -49,6 +50,7 @@ private:
 
 	Condition _condition = Condition::ENABLED;
 	std::string _currentSettings;
+	SourceSettingsMatcher _settingsMatcher;
 	std::string _currentSettingsValue;
 
 	static bool _registered;
@@ -13,6 +13,8 @@ public:
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
+	// The key bindings of the hotkey can be changed in the OBS settings
+	bool SettingsChangeAtRuntime() const { return true; }
 	std::string GetId() const { return id; };
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
@@ -1,6 +1,7 @@
 #include "macro-condition-process.hpp"
 #include "layout-helpers.hpp"
 #include "platform-funcs.hpp"
+#include "process-table.hpp"
 #include "selection-helpers.hpp"
 
 #include <regex>
@@ -14,18 +15,60 @@ bool MacroConditionProcess::_registered = MacroConditionFactory::Register(
 	{MacroConditionProcess::Create, MacroConditionProcessEdit::Create,
 	 "AdvSceneSwitcher.condition.process"});
 
+bool MacroConditionProcess::RegexMatchesAreValid(
+	const QString &expression) const
+{
+	return _regexMatchesValid && _regexMatchesExpression == expression &&
+	       _regexMatchesOptions == _regex.GetPatternOptions() &&
+	       _regexMatchesPartial == _regex.PartialMatchEnabled();
+}
+
+void MacroConditionProcess::UpdateRegexMatches(const ProcessTable &table,
+					       const QString &expression)
+{
+	const bool isValid = RegexMatchesAreValid(expression);
+	if (isValid && _regexMatchesGeneration == table.generation) {
+		return;
+	}
+
+	// Only the processes which were started or exited since the last
+	// snapshot have to be checked if the snapshots are consecutive
+	if (isValid && _regexMatchesGeneration + 1 == table.generation) {
+		for (const auto &process : table.exited) {
+			_regexMatches.removeAll(process);
+		}
+		for (const auto &process : table.started) {
+			if (_regex.Matches(process, expression)) {
+				_regexMatches.append(process);
+			}
+		}
+	} else {
+		_regexMatches.clear();
+		for (const auto &process : table.processes) {
+			if (_regex.Matches(process, expression)) {
+				_regexMatches.append(process);
+			}
+		}
+	}
+
+	_regexMatchesGeneration = table.generation;
+	_regexMatchesExpression = expression;
+	_regexMatchesOptions = _regex.GetPatternOptions();
+	_regexMatchesPartial = _regex.PartialMatchEnabled();
+	_regexMatchesValid = true;
+}
+
 bool MacroConditionProcess::CheckCondition()
 {
-	QStringList runningProcesses;
+	const auto processTable = GetProcessTable();
 	QString proc = QString::fromStdString(_process);
-	GetProcessList(runningProcesses);
 	std::string foregroundProcessName;
 	GetForegroundProcessName(foregroundProcessName);
 
 	SetVariableValue(foregroundProcessName);
 
 	if (!_regex.Enabled()) {
-		if (runningProcesses.contains(proc) &&
+		if (processTable->names.contains(proc) &&
 		    (!_checkFocus || IsInFocus(proc))) {
 			SetTempVarValue("name", proc.toStdString());
 			return true;
@@ -33,21 +76,12 @@ bool MacroConditionProcess::CheckCondition()
 		return false;
 	}
 
-	int matchIndex = -1;
-	bool foundMatch = false;
-	for (const auto &process : runningProcesses) {
-		matchIndex++;
-		if (_regex.Matches(process, proc)) {
-			foundMatch = true;
-			break;
-		}
-	}
-	if (!foundMatch) {
+	UpdateRegexMatches(*processTable, proc);
+	if (_regexMatches.isEmpty()) {
 		return false;
 	}
 	if (!_checkFocus) {
-		SetTempVarValue("name",
-				runningProcesses.at(matchIndex).toStdString());
+		SetTempVarValue("name", _regexMatches.first().toStdString());
 		return true;
 	}
 	if (!IsInFocus(proc)) {
@@ -1,6 +1,7 @@
 #pragma once
 #include "macro-condition-edit.hpp"
 #include "regex-config.hpp"
+#include "process-table.hpp"
 #include "variable-string.hpp"
 
 #include <QCheckBox>
@@ -26,6 +27,17 @@ public:
 
 private:
 	void SetupTempVars();
+	bool RegexMatchesAreValid(const QString &expression) const;
+	void UpdateRegexMatches(const ProcessTable &,
+				const QString &expression);
+
+	// Running processes matching the regular expression
+	QStringList _regexMatches;
+	bool _regexMatchesValid = false;
+	uint64_t _regexMatchesGeneration = 0;
+	QString _regexMatchesExpression;
+	QRegularExpression::PatternOptions _regexMatchesOptions;
+	bool _regexMatchesPartial = false;
 
 	static bool _registered;
 	static const std::string id;
@@ -1,5 +1,6 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "json-helpers.hpp"
 #include "regex-config.hpp"
 #include "scene-item-selection.hpp"
 #include "scene-selection.hpp"
@@ -54,6 +55,7 @@ private:
 	Condition _condition = Condition::MATCHES;
 
 	std::vector<std::string> _previousTransform;
+	JsonMatcher _transformMatcher;
 	std::vector<std::string> _previousSettingValues;
 
 	static bool _registered;
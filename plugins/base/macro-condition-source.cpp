@@ -82,9 +82,9 @@ bool MacroConditionSource::CheckCondition()
 		ret = obs_source_showing(s);
 		break;
 	case Condition::ALL_SETTINGS_MATCH: {
-		ret = CompareSourceSettings(_source.GetSource(), _settings,
-					    _regex);
-		const auto settings = GetSourceSettings(_source.GetSource());
+		ret = _settingsMatcher.Matches(_source.GetSource(), _settings,
+					       _regex);
+		const auto &settings = _settingsMatcher.GetSettings();
 		SetVariableValue(settings);
 		SetTempVarValue("settings", settings);
 		break;
@@ -4,6 +4,7 @@
 #include "regex-config.hpp"
 #include "source-selection.hpp"
 #include "source-setting.hpp"
+#include "source-settings-helpers.hpp"
 
 #include <QComboBox>
 #include <QPushButton>
@@ -52,6 +53,7 @@ private:
 
 	Condition _condition = Condition::ACTIVE;
 	std::string _currentSettings;
+	SourceSettingsMatcher _settingsMatcher;
 	std::string _currentSettingsValue;
 
 	static bool _registered;
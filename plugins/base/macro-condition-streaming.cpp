@@ -202,6 +202,15 @@ bool MacroConditionStream::Load(obs_data_t *obj)
 	return true;
 }
 
+WakeupSource MacroConditionStream::GetConditionWakeupSources() const
+{
+	// The streaming state only changes in combination with frontend events
+	if (_condition == Condition::STOP || _condition == Condition::START) {
+		return WakeupSource::FRONTEND_EVENT;
+	}
+	return WakeupSource::POLL;
+}
+
 void MacroConditionStream::SetupTempVars()
 {
 	MacroCondition::SetupTempVars();
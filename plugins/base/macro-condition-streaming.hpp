@@ -38,6 +38,7 @@ public:
 	RegexConfig _regex;
 
 private:
+	WakeupSource GetConditionWakeupSources() const;
 	void SetupTempVars();
 
 	std::chrono::high_resolution_clock::time_point _lastStreamStartingTime{};
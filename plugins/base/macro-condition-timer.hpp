@@ -16,6 +16,8 @@ public:
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
+	// The timer state can be modified by timer actions
+	bool SettingsChangeAtRuntime() const { return true; }
 	std::string GetId() const { return id; };
 	static std::shared_ptr<MacroCondition> Create(Macro *m)
 	{
@@ -36,6 +36,10 @@ public:
 	bool _clearBufferOnMatch = true;
 
 private:
+	WakeupSource GetConditionWakeupSources() const
+	{
+		return WakeupSource::MESSAGE;
+	}
 	void SetupTempVars();
 
 	Type _type = Type::REQUEST;
@@ -1,6 +1,7 @@
 #include "connection-manager.hpp"
 #include "layout-helpers.hpp"
 #include "name-dialog.hpp"
+#include "name-index.hpp"
 #include "obs-module-helper.hpp"
 #include "plugin-state-helpers.hpp"
 #include "ui-helpers.hpp"
@@ -14,6 +15,7 @@ Q_DECLARE_METATYPE(advss::WSConnection *);
 namespace advss {
 
 static std::deque<std::shared_ptr<Item>> connections;
+static NameIndex<Item> connectionIndex(connections, GetItemNameGeneration);
 static void saveConnections(obs_data_t *obj);
 static void loadConnections(obs_data_t *obj);
 static bool setup();
@@ -30,10 +32,9 @@ static void saveConnections(obs_data_t *obj)
 {
 	obs_data_array_t *connectionArray = obs_data_array_create();
 	for (const auto &c : connections) {
-		obs_data_t *array_obj = obs_data_create();
-		c->Save(array_obj);
-		obs_data_array_push_back(connectionArray, array_obj);
-		obs_data_release(array_obj);
+		obs_data_t *data = c->GetSaveData();
+		obs_data_array_push_back(connectionArray, data);
+		obs_data_release(data);
 	}
 	obs_data_set_array(obj, "websocketConnections", connectionArray);
 	obs_data_array_release(connectionArray);
@@ -86,7 +87,7 @@ WSConnection::WSConnection(const WSConnection &other) : Item(other)
 {
 	_useCustomURI = other._useCustomURI;
 	_customURI = other._customURI;
-	_name = other._name;
+	SetName(other._name);
 	_address = other._address;
 	_port = other._port;
 	_password = other._password;
@@ -102,7 +103,7 @@ WSConnection &WSConnection::operator=(const WSConnection &other)
 	if (this != &other) {
 		_useCustomURI = other._useCustomURI;
 		_customURI = other._customURI;
-		_name = other._name;
+		SetName(other._name);
 		_address = other._address;
 		_port = other._port;
 		_password = other._password;
@@ -218,24 +219,13 @@ WSConnection *GetConnectionByName(const QString &name)
 
 WSConnection *GetConnectionByName(const std::string &name)
 {
-	for (auto &con : connections) {
-		if (con->Name() == name) {
-			return dynamic_cast<WSConnection *>(con.get());
-		}
-	}
-	return nullptr;
+	return dynamic_cast<WSConnection *>(connectionIndex.Find(name).get());
 }
 
 std::weak_ptr<WSConnection> GetWeakConnectionByName(const std::string &name)
 {
-	for (const auto &c : connections) {
-		if (c->Name() == name) {
-			std::weak_ptr<WSConnection> wp =
-				std::dynamic_pointer_cast<WSConnection>(c);
-			return wp;
-		}
-	}
-	return std::weak_ptr<WSConnection>();
+	return std::dynamic_pointer_cast<WSConnection>(
+		connectionIndex.Find(name));
 }
 
 std::weak_ptr<WSConnection> GetWeakConnectionByQString(const QString &name)
@@ -539,7 +529,7 @@ bool WSConnectionSettingsDialog::AskForSettings(QWidget *parent,
 		return false;
 	}
 
-	settings._name = dialog._name->text().toStdString();
+	settings.SetName(dialog._name->text().toStdString());
 	settings._useCustomURI = dialog._useCustomURI->isChecked();
 	settings._customURI = dialog._customUri->text().toStdString();
 	settings._address = dialog._address->text().toStdString();
@@ -549,6 +539,7 @@ bool WSConnectionSettingsDialog::AskForSettings(QWidget *parent,
 	settings._reconnect = dialog._reconnect->isChecked();
 	settings._reconnectDelay = dialog._reconnectDelay->value();
 	settings.UseOBSWebsocketProtocol(dialog._useOBSWSProtocol->isChecked());
+	settings.SettingsModified();
 	settings.Reconnect();
 	return true;
 }
@@ -2,6 +2,8 @@
 #include "log-helper.hpp"
 #include "json-helpers.hpp"
 
+#include <string_view>
+
 namespace advss {
 
 std::string GetSourceSettings(OBSWeakSource ws)
@@ -39,12 +41,130 @@ void SetSourceSettings(obs_source_t *s, const std::string &settings)
 	obs_data_release(data);
 }
 
-bool CompareSourceSettings(const OBSWeakSource &source,
-			   const std::string &settings,
-			   const RegexConfig &regex)
+static void hashCombine(size_t &hash, size_t value)
+{
+	hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+static size_t hashData(obs_data_t *data);
+
+static size_t hashItem(obs_data_item_t *item)
+{
+	size_t hash = std::hash<int>()(obs_data_item_gettype(item));
+	switch (obs_data_item_gettype(item)) {
+	case OBS_DATA_STRING: {
+		const char *value = obs_data_item_get_string(item);
+		const std::string_view string = value ? value : "";
+		hashCombine(hash, std::hash<std::string_view>()(string));
+		break;
+	}
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT) {
+			const long long value = obs_data_item_get_int(item);
+			hashCombine(hash, std::hash<long long>()(value));
+		} else {
+			const double value = obs_data_item_get_double(item);
+			hashCombine(hash, std::hash<double>()(value));
+		}
+		break;
+	case OBS_DATA_BOOLEAN:
+		hashCombine(hash, obs_data_item_get_bool(item));
+		break;
+	case OBS_DATA_OBJECT: {
+		obs_data_t *obj = obs_data_item_get_obj(item);
+		hashCombine(hash, hashData(obj));
+		obs_data_release(obj);
+		break;
+	}
+	case OBS_DATA_ARRAY: {
+		obs_data_array_t *array = obs_data_item_get_array(item);
+		const size_t count = obs_data_array_count(array);
+		hashCombine(hash, count);
+		for (size_t i = 0; i < count; i++) {
+			obs_data_t *obj = obs_data_array_item(array, i);
+			hashCombine(hash, hashData(obj));
+			obs_data_release(obj);
+		}
+		obs_data_array_release(array);
+		break;
+	}
+	default:
+		break;
+	}
+	return hash;
+}
+
+// Only covers values which are part of the JSON representation of the data
+static size_t hashData(obs_data_t *data)
+{
+	size_t hash = 0;
+	for (obs_data_item_t *item = obs_data_first(data); item;
+	     obs_data_item_next(&item)) {
+		if (!obs_data_item_has_user_value(item)) {
+			continue;
+		}
+		const char *name = obs_data_item_get_name(item);
+		hashCombine(hash, std::hash<std::string_view>()(name));
+		hashCombine(hash, hashItem(item));
+	}
+	return hash;
+}
+
+bool SourceSettingsMatcher::IsUpToDate(const Entry &entry,
+				       size_t settingsHash,
+				       const std::string &expected,
+				       const RegexConfig &regex) const
+{
+	return entry.valid && entry.settingsHash == settingsHash &&
+	       entry.expected == expected &&
+	       entry.regexEnabled == regex.Enabled() &&
+	       entry.options == regex.GetPatternOptions() &&
+	       entry.partialMatch == regex.PartialMatchEnabled();
+}
+
+bool SourceSettingsMatcher::Matches(const OBSWeakSource &source,
+				    const std::string &expected,
+				    const RegexConfig &regex)
+{
+	_lastEntry = nullptr;
+	OBSSourceAutoRelease s = obs_weak_source_get_source(source);
+	if (!s) {
+		return false;
+	}
+	OBSDataAutoRelease data = obs_source_get_settings(s);
+	const size_t settingsHash = hashData(data);
+
+	// Entries of sources which no longer exist are never removed otherwise
+	constexpr size_t maxEntries = 64;
+	obs_weak_source_t *key = source;
+	if (_entries.size() >= maxEntries && _entries.count(key) == 0) {
+		_entries.clear();
+	}
+
+	auto &entry = _entries[key];
+	_lastEntry = &entry;
+	if (IsUpToDate(entry, settingsHash, expected, regex)) {
+		return entry.result;
+	}
+
+	if (!entry.valid || entry.settingsHash != settingsHash) {
+		const char *json = obs_data_get_json(data);
+		entry.settings = json ? json : "";
+	}
+	entry.settingsHash = settingsHash;
+	entry.valid = true;
+	entry.expected = expected;
+	entry.regexEnabled = regex.Enabled();
+	entry.options = regex.GetPatternOptions();
+	entry.partialMatch = regex.PartialMatchEnabled();
+	entry.result = _matcher.Matches(data.Get(), expected, regex);
+	return entry.result;
+}
+
+const std::string &SourceSettingsMatcher::GetSettings() const
 {
-	std::string currentSettings = GetSourceSettings(source);
-	return MatchJson(currentSettings, settings, regex);
+	static const std::string empty;
+	return _lastEntry ? _lastEntry->settings : empty;
 }
 
 } // namespace advss
@@ -1,14 +1,47 @@
 #pragma once
+#include <json-helpers.hpp>
 #include <obs.hpp>
 #include <string>
 #include <regex-config.hpp>
+#include <unordered_map>
 
 namespace advss {
 
 std::string GetSourceSettings(OBSWeakSource ws);
 void SetSourceSettings(obs_source_t *s, const std::string &settings);
-bool CompareSourceSettings(const OBSWeakSource &source,
-			   const std::string &settings,
-			   const RegexConfig &regex);
+
+// Compares the settings of sources to the expected settings without
+// serializing them.
+//
+// The result is reused as long as neither the settings of the source, nor the
+// expected settings, nor the regular expression options changed.
+class SourceSettingsMatcher {
+public:
+	bool Matches(const OBSWeakSource &source, const std::string &expected,
+		     const RegexConfig &regex);
+	// Returns the settings of the source passed to the last call of
+	// Matches() in JSON format
+	const std::string &GetSettings() const;
+
+private:
+	struct Entry {
+		bool valid = false;
+		size_t settingsHash = 0;
+		std::string settings;
+		std::string expected;
+		bool regexEnabled = false;
+		QRegularExpression::PatternOptions options;
+		bool partialMatch = false;
+		bool result = false;
+	};
+
+	bool IsUpToDate(const Entry &, size_t settingsHash,
+			const std::string &expected,
+			const RegexConfig &regex) const;
+
+	JsonMatcher _matcher;
+	std::unordered_map<obs_weak_source_t *, Entry> _entries;
+	const Entry *_lastEntry = nullptr;
+};
 
 } // namespace advss
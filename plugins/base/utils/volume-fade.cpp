@@ -0,0 +1,261 @@
+#include "volume-fade.hpp"
+#include "audio-helpers.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace advss {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct VolumeFade {
+	OBSWeakSource source;
+	uint64_t id = 0;
+	float startVolume = 0.f;
+	float targetVolume = 0.f;
+	Clock::time_point start;
+	std::chrono::milliseconds duration;
+	VolumeFadeCurve curve = VolumeFadeCurve::LINEAR;
+	std::function<bool()> shouldCancel;
+};
+
+} // namespace
+
+// Volumes below this level are inaudible, so fades in dB do not have to
+// start or end at -inf dB
+constexpr float minFadeDB = -60.f;
+
+static std::mutex mutex;
+static std::condition_variable fadeDone;
+static std::unordered_map<obs_weak_source_t *, VolumeFade> fades;
+static uint64_t nextFadeId = 1;
+static std::atomic_bool tickCallbackRegistered = {false};
+
+// For backwards compatibility
+#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(29, 0, 0)
+static float get_master_volume()
+{
+	return 1.f;
+}
+
+static void set_master_volume(float)
+{
+	return;
+}
+#else
+auto get_master_volume = obs_get_master_volume;
+auto set_master_volume = obs_set_master_volume;
+#endif
+
+static void fadeTick(void *, float);
+
+static void cleanup()
+{
+	// The tick callbacks are removed while holding a libobs internal lock,
+	// which is also held while fadeTick() acquires the mutex
+	if (tickCallbackRegistered.exchange(false)) {
+		obs_remove_tick_callback(fadeTick, nullptr);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	fades.clear();
+	fadeDone.notify_all();
+}
+
+static bool setup()
+{
+	AddPluginCleanupStep(cleanup);
+	return true;
+}
+
+static bool setupDone = setup();
+
+float GetAudioVolume(const OBSWeakSource &weakSource)
+{
+	if (!weakSource) {
+		return get_master_volume();
+	}
+	OBSSourceAutoRelease source = obs_weak_source_get_source(weakSource);
+	if (!source) {
+		return 0.f;
+	}
+	return obs_source_get_volume(source);
+}
+
+void SetAudioVolume(const OBSWeakSource &weakSource, float volume)
+{
+	if (!weakSource) {
+		set_master_volume(volume);
+		return;
+	}
+	OBSSourceAutoRelease source = obs_weak_source_get_source(weakSource);
+	obs_source_set_volume(source, volume);
+}
+
+static float getFadeVolume(const VolumeFade &fade, float progress)
+{
+	switch (fade.curve) {
+	case VolumeFadeCurve::DB_LINEAR: {
+		const float startDB = std::max(
+			PercentToDecibel(fade.startVolume), minFadeDB);
+		const float targetDB = std::max(
+			PercentToDecibel(fade.targetVolume), minFadeDB);
+		return DecibelToPercent(startDB +
+					(targetDB - startDB) * progress);
+	}
+	case VolumeFadeCurve::S_CURVE:
+		progress = progress * progress * (3.f - 2.f * progress);
+		break;
+	default:
+		break;
+	}
+	return fade.startVolume +
+	       (fade.targetVolume - fade.startVolume) * progress;
+}
+
+// The cancel callbacks are called without holding the lock, as they might
+// have to wait for other threads
+static std::vector<uint64_t> getCancelledFades()
+{
+	std::vector<std::pair<uint64_t, std::function<bool()>>> callbacks;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto &[_, fade] : fades) {
+			if (fade.shouldCancel) {
+				callbacks.emplace_back(fade.id,
+						       fade.shouldCancel);
+			}
+		}
+	}
+
+	std::vector<uint64_t> cancelledFades;
+	for (const auto &[id, shouldCancel] : callbacks) {
+		if (shouldCancel()) {
+			cancelledFades.emplace_back(id);
+		}
+	}
+	return cancelledFades;
+}
+
+static void fadeTick(void *, float)
+{
+	const auto cancelledFades = getCancelledFades();
+	std::vector<std::pair<OBSWeakSource, float>> volumes;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (fades.empty()) {
+			return;
+		}
+
+		const auto now = Clock::now();
+		bool fadeCompleted = false;
+		for (auto it = fades.begin(); it != fades.end();) {
+			auto &fade = it->second;
+			if (std::find(cancelledFades.begin(),
+				      cancelledFades.end(),
+				      fade.id) != cancelledFades.end()) {
+				it = fades.erase(it);
+				fadeCompleted = true;
+				continue;
+			}
+
+			const float progress = std::min(
+				std::chrono::duration<float>(now - fade.start) /
+					fade.duration,
+				1.f);
+			if (progress < 1.f) {
+				volumes.emplace_back(
+					fade.source,
+					getFadeVolume(fade, progress));
+				++it;
+				continue;
+			}
+
+			// Set the exact target volume as the last step
+			volumes.emplace_back(fade.source, fade.targetVolume);
+			it = fades.erase(it);
+			fadeCompleted = true;
+		}
+		if (fadeCompleted) {
+			fadeDone.notify_all();
+		}
+	}
+
+	for (const auto &[source, volume] : volumes) {
+		SetAudioVolume(source, volume);
+	}
+}
+
+uint64_t StartVolumeFade(const OBSWeakSource &source, float targetVolume,
+			 std::chrono::milliseconds duration,
+			 VolumeFadeCurve curve,
+			 const std::function<bool()> &shouldCancel)
+{
+	const float startVolume = GetAudioVolume(source);
+
+	// Must not be done while holding the mutex, as the tick callbacks are
+	// added while holding a libobs internal lock, which is also held while
+	// fadeTick() acquires the mutex
+	if (duration.count() > 0 && !tickCallbackRegistered.exchange(true)) {
+		obs_add_tick_callback(fadeTick, nullptr);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	const uint64_t id = nextFadeId++;
+	if (duration.count() <= 0) {
+		if (fades.erase(source.Get()) > 0) {
+			fadeDone.notify_all();
+		}
+		SetAudioVolume(source, targetVolume);
+		return id;
+	}
+
+	auto &fade = fades[source.Get()];
+	fade.source = source;
+	fade.id = id;
+	fade.startVolume = startVolume;
+	fade.targetVolume = targetVolume;
+	fade.start = Clock::now();
+	fade.duration = duration;
+	fade.curve = curve;
+	fade.shouldCancel = shouldCancel;
+
+	// Callers waiting for the fade, which was retargeted, stop waiting
+	fadeDone.notify_all();
+	return id;
+}
+
+bool VolumeFadeActive(const OBSWeakSource &source)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return fades.find(source.Get()) != fades.end();
+}
+
+void CancelVolumeFade(const OBSWeakSource &source)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (fades.erase(source.Get()) > 0) {
+		fadeDone.notify_all();
+	}
+}
+
+void WaitForVolumeFade(uint64_t id)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	fadeDone.wait(lock, [id]() {
+		return std::none_of(fades.begin(), fades.end(),
+				    [id](const auto &entry) {
+					    return entry.second.id == id;
+				    });
+	});
+}
+
+} // namespace advss
@@ -0,0 +1,41 @@
+#pragma once
+#include <obs.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace advss {
+
+enum class VolumeFadeCurve {
+	LINEAR,
+	DB_LINEAR,
+	S_CURVE,
+};
+
+// An empty weak source refers to the master volume
+float GetAudioVolume(const OBSWeakSource &);
+void SetAudioVolume(const OBSWeakSource &, float volume);
+
+// All active volume fades are advanced once per frame from a single OBS tick
+// callback, so no thread has to be started for each fade.
+// Only one fade can be active per source, which is identified by its weak
+// source and not by its name.
+//
+// Starts a fade from the current to the given target volume.
+// An already active fade of the same source is retargeted and will continue
+// from the volume it reached so far.
+// The fade is cancelled as soon as shouldCancel returns true.
+// shouldCancel is called from the video thread, so it must neither block nor
+// release the last reference to objects which have to be destroyed on other
+// threads, like macros.
+// Returns the id of the fade.
+uint64_t StartVolumeFade(const OBSWeakSource &, float targetVolume,
+			 std::chrono::milliseconds duration, VolumeFadeCurve,
+			 const std::function<bool()> &shouldCancel);
+bool VolumeFadeActive(const OBSWeakSource &);
+void CancelVolumeFade(const OBSWeakSource &);
+// Blocks until the fade with the given id completed or was cancelled
+void WaitForVolumeFade(uint64_t id);
+
+} // namespace advss
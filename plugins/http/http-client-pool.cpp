@@ -0,0 +1,130 @@
+#include "http-client-pool.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <algorithm>
+
+namespace advss {
+
+// Servers will close connections which were idle for too long at some point,
+// so there is no point in keeping those around
+static constexpr auto maxIdleTime = std::chrono::seconds(30);
+static constexpr size_t workerThreadCount = 4;
+
+HttpClientPool::HttpClientPool() {}
+
+HttpClientPool::~HttpClientPool()
+{
+	Stop();
+}
+
+static void setTimeout(httplib::Client &client,
+		       std::chrono::milliseconds timeout)
+{
+	const time_t seconds = timeout.count() / 1000;
+	const time_t usecs = (timeout.count() % 1000) * 1000;
+	client.set_connection_timeout(seconds, usecs);
+	client.set_read_timeout(seconds, usecs);
+	client.set_write_timeout(seconds, usecs);
+}
+
+httplib::Result HttpClientPool::Send(const std::string &host,
+				     const Request &request,
+				     std::chrono::milliseconds timeout)
+{
+	auto connection = Acquire(host);
+	setTimeout(*connection.client, timeout);
+	auto result = request(*connection.client);
+	Release(host, std::move(connection), !!result);
+	return result;
+}
+
+std::future<httplib::Result>
+HttpClientPool::SendAsync(const std::string &host, Request request,
+			  std::chrono::milliseconds timeout)
+{
+	_threadPool.SetThreadCount(workerThreadCount);
+
+	auto promise = std::make_shared<std::promise<httplib::Result>>();
+	auto future = promise->get_future();
+	(void)_threadPool.Submit(
+		[this, host, request = std::move(request), timeout, promise]() {
+			promise->set_value(Send(host, request, timeout));
+		});
+	return future;
+}
+
+void HttpClientPool::Stop()
+{
+	_threadPool.Stop();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (auto &[_, host] : _hosts) {
+		host->openConnections -= host->idleConnections.size();
+		host->idleConnections.clear();
+	}
+}
+
+HttpClientPool::Connection HttpClientPool::Acquire(const std::string &hostName)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto &host = _hosts[hostName];
+	if (!host) {
+		host = std::make_unique<Host>();
+	}
+
+	host->cv.wait(lock, [&host]() {
+		return !host->idleConnections.empty() ||
+		       host->openConnections < GetMaxConnectionsPerHost();
+	});
+
+	// Idle connections are sorted from least to most recently used
+	auto &idle = host->idleConnections;
+	const auto now = Clock::now();
+	const auto isUsable = [now](const Connection &connection) {
+		return now - connection.lastUsed < maxIdleTime;
+	};
+	auto firstUsable = std::find_if(idle.begin(), idle.end(), isUsable);
+	host->openConnections -= std::distance(idle.begin(), firstUsable);
+	idle.erase(idle.begin(), firstUsable);
+
+	if (!idle.empty()) {
+		auto connection = std::move(idle.back());
+		idle.pop_back();
+		return connection;
+	}
+
+	host->openConnections++;
+	lock.unlock();
+
+	Connection connection;
+	connection.client = std::make_unique<httplib::Client>(hostName);
+	connection.client->set_keep_alive(true);
+	return connection;
+}
+
+void HttpClientPool::Release(const std::string &hostName,
+			     Connection &&connection, bool reuse)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto &host = _hosts[hostName];
+	if (reuse) {
+		connection.lastUsed = Clock::now();
+		host->idleConnections.emplace_back(std::move(connection));
+	} else {
+		// The connection might be in an unusable state after errors
+		host->openConnections--;
+	}
+	host->cv.notify_one();
+}
+
+HttpClientPool &GetHttpClientPool()
+{
+	static HttpClientPool pool;
+	[[maybe_unused]] static bool _ = []() {
+		AddPluginCleanupStep([]() { pool.Stop(); });
+		return true;
+	}();
+	return pool;
+}
+
+} // namespace advss
@@ -0,0 +1,72 @@
+#pragma once
+#include "thread-pool.hpp"
+
+#include <httplib.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Keeps HTTP connections alive between requests, so consecutive requests to
+// the same host do not have to set up a new TCP and TLS connection each time.
+//
+// Connections are pooled per scheme, host and port.
+// At most GetMaxConnectionsPerHost() requests are sent to the same host at
+// the same time. Further requests wait until a connection is available.
+class HttpClientPool {
+public:
+	using Request = std::function<httplib::Result(httplib::Client &)>;
+
+	HttpClientPool();
+	~HttpClientPool();
+	HttpClientPool(const HttpClientPool &) = delete;
+	HttpClientPool &operator=(const HttpClientPool &) = delete;
+
+	// Sends the request on the calling thread.
+	// The host is expected to be in the form "scheme://host:port".
+	httplib::Result Send(const std::string &host, const Request &,
+			     std::chrono::milliseconds timeout);
+	// Sends the request on one of the pool's worker threads
+	std::future<httplib::Result>
+	SendAsync(const std::string &host, Request,
+		  std::chrono::milliseconds timeout);
+
+	static size_t GetMaxConnectionsPerHost() { return 4; }
+
+	// Stops the worker threads and closes all idle connections
+	void Stop();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Connection {
+		std::unique_ptr<httplib::Client> client;
+		Clock::time_point lastUsed;
+	};
+
+	struct Host {
+		std::vector<Connection> idleConnections;
+		size_t openConnections = 0;
+		std::condition_variable cv;
+	};
+
+	Connection Acquire(const std::string &host);
+	void Release(const std::string &host, Connection &&, bool reuse);
+
+	std::mutex _mutex;
+	std::unordered_map<std::string, std::unique_ptr<Host>> _hosts;
+	ThreadPool _threadPool;
+};
+
+// Returns the pool shared by all requests of this module
+HttpClientPool &GetHttpClientPool();
+
+} // namespace advss
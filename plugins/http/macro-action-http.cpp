@@ -1,4 +1,5 @@
 #include "macro-action-http.hpp"
+#include "http-client-pool.hpp"
 #include "layout-helpers.hpp"
 
 #include <httplib.h>
@@ -44,14 +45,6 @@ static httplib::Params getParams(const StringList &strings)
 	return params;
 }
 
-static void setTimeout(httplib::Client &client, const Duration &timeout)
-{
-	const time_t seconds = timeout.Seconds();
-	const time_t usecs = timeout.Milliseconds() - (seconds * 1000);
-	client.set_read_timeout(seconds, usecs);
-	client.set_write_timeout(seconds, usecs);
-}
-
 void MacroActionHttp::SetupTempVars()
 {
 	MacroAction::SetupTempVars();
@@ -96,52 +89,58 @@ static URLInfo getURLInfo(const std::string &input)
 	return {host, path};
 }
 
+static HttpClientPool::Request
+createRequest(MacroActionHttp::Method method, const std::string &path,
+	      const httplib::Params &params, const httplib::Headers &headers,
+	      const std::string &body, const std::string &contentType)
+{
+	return [=](httplib::Client &cli) -> httplib::Result {
+		if (method == MacroActionHttp::Method::GET) {
+			return cli.Get(path, params, headers);
+		}
+
+		const auto pathWithParam =
+			httplib::append_query_params(path, params);
+		switch (method) {
+		case MacroActionHttp::Method::POST:
+			return cli.Post(pathWithParam, headers, body,
+					contentType);
+		case MacroActionHttp::Method::PUT:
+			return cli.Put(pathWithParam, headers, body,
+				       contentType);
+		case MacroActionHttp::Method::PATCH:
+			return cli.Patch(pathWithParam, headers, body,
+					 contentType);
+		case MacroActionHttp::Method::DELETE:
+			return cli.Delete(pathWithParam, headers, body,
+					  contentType);
+		default:
+			break;
+		}
+		return httplib::Result();
+	};
+}
+
 bool MacroActionHttp::PerformAction()
 {
 	const auto [host, path] = getURLInfo(_url);
-
-	httplib::Client cli(host);
-	setTimeout(cli, _timeout);
 	const auto params = _setParams ? getParams(_params) : httplib::Params();
 	const auto headers = _setHeaders ? getHeaders(_headers)
 					 : httplib::Headers();
-
-	httplib::Result response;
-	switch (_method) {
-	case MacroActionHttp::Method::GET:
-		response = cli.Get(path, params, headers);
-		break;
-	case MacroActionHttp::Method::POST: {
-		const auto pathWithParam =
-			httplib::append_query_params(path, params);
-		response =
-			cli.Post(pathWithParam, headers, _body, _contentType);
-		break;
-	}
-	case MacroActionHttp::Method::PUT: {
-		const auto pathWithParam =
-			httplib::append_query_params(path, params);
-		response = cli.Put(pathWithParam, headers, _body, _contentType);
-		break;
-	}
-	case MacroActionHttp::Method::PATCH: {
-		const auto pathWithParam =
-			httplib::append_query_params(path, params);
-		response =
-			cli.Patch(pathWithParam, headers, _body, _contentType);
-		break;
-	}
-	case MacroActionHttp::Method::DELETE: {
-		const auto pathWithParam =
-			httplib::append_query_params(path, params);
-		response =
-			cli.Delete(pathWithParam, headers, _body, _contentType);
-		break;
-	}
-	default:
-		break;
+	const auto request = createRequest(_method, path, params, headers,
+					   _body, _contentType);
+	const std::chrono::milliseconds timeout(_timeout.Milliseconds());
+
+	if (!_waitForResponse) {
+		(void)GetHttpClientPool().SendAsync(host, request, timeout);
+		SetTempVarValue("status", "");
+		SetTempVarValue("body", "");
+		SetTempVarValue("error", "");
+		return true;
 	}
 
+	auto response = GetHttpClientPool().Send(host, request, timeout);
+
 	if (VerboseLoggingEnabled() && !response) {
 		blog(LOG_INFO, "HTTP action error: %s",
 		     httplib::to_string(response.error()).c_str());
@@ -198,12 +197,15 @@ void MacroActionHttp::LogAction() const
 	      "with body \"%s\" "
 	      "with headers \"%s\" "
 	      "with parameters \"%s\" "
-	      "with timeout \"%s\"",
+	      "with timeout \"%s\" "
+	      "%s",
 	      methodToString(_method).data(), _url.c_str(),
 	      _contentType.c_str(), _body.c_str(),
 	      _setHeaders ? stringListToString(_headers).c_str() : "-",
 	      _setParams ? stringListToString(_params).c_str() : "-",
-	      _timeout.ToString().c_str());
+	      _timeout.ToString().c_str(),
+	      _waitForResponse ? "and waited for response"
+			       : "without waiting for response");
 }
 
 bool MacroActionHttp::Save(obs_data_t *obj) const
@@ -218,6 +220,7 @@ bool MacroActionHttp::Save(obs_data_t *obj) const
 	_params.Save(obj, "params", "param");
 	obs_data_set_int(obj, "method", static_cast<int>(_method));
 	_timeout.Save(obj);
+	obs_data_set_bool(obj, "waitForResponse", _waitForResponse);
 	return true;
 }
 
@@ -238,6 +241,8 @@ bool MacroActionHttp::Load(obs_data_t *obj)
 	_params.Load(obj, "params", "param");
 	_method = static_cast<Method>(obs_data_get_int(obj, "method"));
 	_timeout.Load(obj);
+	obs_data_set_default_bool(obj, "waitForResponse", true);
+	_waitForResponse = obs_data_get_bool(obj, "waitForResponse");
 	return true;
 }
 
@@ -314,7 +319,9 @@ MacroActionHttpEdit::MacroActionHttpEdit(
 		  obs_module_text(
 			  "AdvSceneSwitcher.action.http.addParam.value"))),
 	  _paramListLayout(new QVBoxLayout()),
-	  _timeout(new DurationSelection(this, false))
+	  _timeout(new DurationSelection(this, false)),
+	  _waitForResponse(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.action.http.waitForResponse")))
 {
 	populateMethodSelection(_methods);
 
@@ -342,6 +349,7 @@ void MacroActionHttpEdit::UpdateEntryData()
 	_methods->setCurrentIndex(
 		_methods->findData(static_cast<int>(_entryData->_method)));
 	_timeout->SetDuration(_entryData->_timeout);
+	_waitForResponse->setChecked(_entryData->_waitForResponse);
 	SetWidgetVisibility();
 }
 
@@ -381,6 +389,12 @@ void MacroActionHttpEdit::TimeoutChanged(const Duration &dur)
 	_entryData->_timeout = dur;
 }
 
+void MacroActionHttpEdit::WaitForResponseChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_waitForResponse = value;
+}
+
 void MacroActionHttpEdit::SetHeadersChanged(int value)
 {
 	GUARD_LOADING_AND_LOCK();
@@ -433,6 +447,8 @@ void MacroActionHttpEdit::SetWidgetSignalConnections()
 			 SLOT(ParamsChanged(const StringList &)));
 	QWidget::connect(_timeout, SIGNAL(DurationChanged(const Duration &)),
 			 this, SLOT(TimeoutChanged(const Duration &)));
+	QWidget::connect(_waitForResponse, SIGNAL(stateChanged(int)), this,
+			 SLOT(WaitForResponseChanged(int)));
 }
 
 void MacroActionHttpEdit::SetWidgetLayout()
@@ -478,6 +494,7 @@ void MacroActionHttpEdit::SetWidgetLayout()
 	layout->addLayout(_contentTypeLayout);
 	layout->addLayout(_bodyLayout);
 	layout->addLayout(timeoutLayout);
+	layout->addWidget(_waitForResponse);
 	setLayout(layout);
 }
 
@@ -41,6 +41,7 @@ public:
 	StringList _params;
 	Method _method = Method::GET;
 	Duration _timeout = Duration(1.0);
+	bool _waitForResponse = true;
 
 private:
 	void SetupTempVars();
@@ -71,6 +72,7 @@ private slots:
 	void ContentTypeChanged();
 	void MethodChanged(int);
 	void TimeoutChanged(const Duration &seconds);
+	void WaitForResponseChanged(int);
 	void SetHeadersChanged(int);
 	void HeadersChanged(const StringList &);
 	void SetParamsChanged(int);
@@ -96,6 +98,7 @@ private:
 	KeyValueListEdit *_paramList;
 	QVBoxLayout *_paramListLayout;
 	DurationSelection *_timeout;
+	QCheckBox *_waitForResponse;
 
 	std::shared_ptr<MacroActionHttp> _entryData;
 	bool _loading = true;
@@ -200,7 +200,7 @@ void MacroActionMidiEdit::SetMessageSelectionToLastReceived()
 		return;
 	}
 
-	std::optional<MidiMessage> message;
+	std::shared_ptr<const MidiMessage> message;
 	while (!_messageBuffer->Empty()) {
 		message = _messageBuffer->ConsumeMessage();
 		if (!message) {
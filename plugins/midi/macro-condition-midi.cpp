@@ -250,7 +250,7 @@ void MacroConditionMidiEdit::SetMessageSelectionToLastReceived()
 		return;
 	}
 
-	std::optional<MidiMessage> message;
+	std::shared_ptr<const MidiMessage> message;
 	while (!_messageBuffer->Empty()) {
 		message = _messageBuffer->ConsumeMessage();
 		if (!message) {
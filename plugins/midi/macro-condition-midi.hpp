@@ -27,6 +27,10 @@ public:
 	bool _clearBufferOnMatch = true;
 
 private:
+	WakeupSource GetConditionWakeupSources() const
+	{
+		return WakeupSource::MESSAGE;
+	}
 	void SetupTempVars();
 	void SetVariableValues(const MidiMessage &);
 
@@ -248,7 +248,7 @@ void MacroConditionMqttEdit::SetMessageSelectionToLastReceived()
 		return;
 	}
 
-	std::optional<std::string> message;
+	std::shared_ptr<const std::string> message;
 	while (!_messageBuffer->Empty()) {
 		message = _messageBuffer->ConsumeMessage();
 		if (!message) {
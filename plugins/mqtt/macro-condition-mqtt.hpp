@@ -31,6 +31,10 @@ public:
 	bool _clearBufferOnMatch = true;
 
 private:
+	WakeupSource GetConditionWakeupSources() const
+	{
+		return WakeupSource::MESSAGE;
+	}
 	void SetupTempVars();
 
 	std::weak_ptr<MqttConnection> _connection;
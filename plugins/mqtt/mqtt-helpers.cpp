@@ -1,6 +1,7 @@
 #include "mqtt-helpers.hpp"
 #include "layout-helpers.hpp"
 #include "log-helper.hpp"
+#include "name-index.hpp"
 #include "obs-module-helper.hpp"
 #include "plugin-state-helpers.hpp"
 #include "ui-helpers.hpp"
@@ -408,7 +409,7 @@ bool MqttConnectionSettingsDialog::AskForSettings(QWidget *parent,
 		return false;
 	}
 
-	connection._name = dialog._name->text().toStdString();
+	connection.SetName(dialog._name->text().toStdString());
 	connection._uri = dialog._uri->text().toStdString();
 	connection._username = dialog._username->text().toStdString();
 	connection._password = dialog._password->text().toStdString();
@@ -451,7 +452,7 @@ void MqttConnectionSettingsDialog::TestConnection()
 	}
 
 	auto connection = std::make_shared<MqttConnection>();
-	connection->_name = _name->text().toStdString();
+	connection->SetName(_name->text().toStdString());
 	connection->_uri = _uri->text().toStdString();
 	connection->_username = _username->text().toStdString();
 	connection->_password = _password->text().toStdString();
@@ -560,28 +561,22 @@ MqttConnection *GetMqttConnectionByName(const QString &name)
 	return GetMqttConnectionByName(name.toStdString());
 }
 
+static std::shared_ptr<Item> findConnection(const std::string &name)
+{
+	static NameIndex<Item> index(GetMqttConnections(),
+				     GetItemNameGeneration);
+	return index.Find(name);
+}
+
 MqttConnection *GetMqttConnectionByName(const std::string &name)
 {
-	for (const auto &connection : GetMqttConnections()) {
-		if (connection->Name() == name) {
-			return dynamic_cast<MqttConnection *>(connection.get());
-		}
-	}
-	return nullptr;
+	return dynamic_cast<MqttConnection *>(findConnection(name).get());
 }
 
 std::weak_ptr<MqttConnection>
 GetWeakMqttConnectionByName(const std::string &name)
 {
-	for (const auto &connection : GetMqttConnections()) {
-		if (connection->Name() == name) {
-			std::weak_ptr<MqttConnection> weak =
-				std::dynamic_pointer_cast<MqttConnection>(
-					connection);
-			return weak;
-		}
-	}
-	return std::weak_ptr<MqttConnection>();
+	return std::dynamic_pointer_cast<MqttConnection>(findConnection(name));
 }
 
 std::weak_ptr<MqttConnection>
@@ -50,6 +50,10 @@ public:
 	StreamDeckMessagePattern _pattern;
 
 private:
+	WakeupSource GetConditionWakeupSources() const
+	{
+		return WakeupSource::MESSAGE;
+	}
 	void SetTempVarValues(const StreamDeckMessage &);
 	void SetupTempVars();
 	bool MessageMatches(const StreamDeckMessage &);
@@ -333,6 +333,80 @@ static std::vector<IRCMessage> parseMessages(const std::string &messagesStr)
 
 /* ------------------------------------------------------------------------- */
 
+static uint32_t getFlags(const IRCMessage &message)
+{
+	uint32_t flags = 0;
+	if (message.properties.isFirstMessage) {
+		flags |= ChatMessageFilter::FIRST_MESSAGE;
+	}
+	if (message.properties.isUsingOnlyEmotes) {
+		flags |= ChatMessageFilter::EMOTE_ONLY;
+	}
+	if (message.properties.isMod) {
+		flags |= ChatMessageFilter::MOD;
+	}
+	if (message.properties.isSubscriber) {
+		flags |= ChatMessageFilter::SUBSCRIBER;
+	}
+	if (message.properties.isTurbo) {
+		flags |= ChatMessageFilter::TURBO;
+	}
+	if (message.properties.isVIP) {
+		flags |= ChatMessageFilter::VIP;
+	}
+	return flags;
+}
+
+static bool badgeIsEnabled(const IRCMessage &message, const std::string &name)
+{
+	for (const auto &badge : message.properties.badges) {
+		if (badge.enabled && badge.name == name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ChatMessageFilter::Matches(const IRCMessage &message) const
+{
+	if (!types.empty() && std::find(types.begin(), types.end(),
+					message.type) == types.end()) {
+		return false;
+	}
+
+	const auto flags = getFlags(message);
+	if ((flags & requiredFlags) != requiredFlags ||
+	    (flags & excludedFlags) != 0) {
+		return false;
+	}
+
+	for (const auto &badge : badges) {
+		if (!badgeIsEnabled(message, badge)) {
+			return false;
+		}
+	}
+
+	switch (textMatch) {
+	case TextMatch::ANY:
+		return true;
+	case TextMatch::EXACT:
+		return message.message == text;
+	case TextMatch::PREFIX:
+		return message.message.compare(0, text.size(), text) == 0;
+	case TextMatch::CONTAINS:
+		return message.message.find(text) != std::string::npos;
+	}
+	return true;
+}
+
+bool ChatMessageFilter::MatchesAnyMessage() const
+{
+	return types.empty() && requiredFlags == 0 && excludedFlags == 0 &&
+	       badges.empty() && textMatch == TextMatch::ANY;
+}
+
+/* ------------------------------------------------------------------------- */
+
 static constexpr std::string_view defaultURL =
 	"wss://irc-ws.chat.twitch.tv:443";
 
@@ -498,10 +572,17 @@ void TwitchChatConnection::ConnectToChat()
 	}
 }
 
-ChatMessageBuffer TwitchChatConnection::RegisterForMessages()
+ChatMessageBuffer
+TwitchChatConnection::RegisterForMessages(const ChatMessageFilter &filter)
 {
 	ConnectToChat();
-	return _messageDispatcher.RegisterClient();
+	if (filter.MatchesAnyMessage()) {
+		return _messageDispatcher.RegisterClient();
+	}
+	return _messageDispatcher.RegisterClient(
+		[filter](const IRCMessage &message) {
+			return filter.Matches(message);
+		});
 }
 
 ChatMessageBuffer TwitchChatConnection::RegisterForWhispers()
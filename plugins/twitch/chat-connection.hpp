@@ -74,6 +74,40 @@ struct IRCMessage {
 	std::string message;
 };
 
+// Criteria checked by the chat connection before passing a message to a
+// subscriber, so subscribers are not flooded with messages they are not
+// interested in.
+// Unset criteria match any message.
+struct ChatMessageFilter {
+	enum Flag : uint32_t {
+		FIRST_MESSAGE = 1 << 0,
+		EMOTE_ONLY = 1 << 1,
+		MOD = 1 << 2,
+		SUBSCRIBER = 1 << 3,
+		TURBO = 1 << 4,
+		VIP = 1 << 5,
+	};
+
+	enum class TextMatch {
+		ANY,
+		EXACT,
+		PREFIX,
+		CONTAINS,
+	};
+
+	bool Matches(const IRCMessage &) const;
+	bool MatchesAnyMessage() const;
+
+	std::vector<IRCMessage::Type> types;
+	// Flags which have to be set or not set respectively
+	uint32_t requiredFlags = 0;
+	uint32_t excludedFlags = 0;
+	// Names of badges which all have to be enabled
+	std::vector<std::string> badges;
+	TextMatch textMatch = TextMatch::ANY;
+	std::string text;
+};
+
 using ChatMessageBuffer = std::shared_ptr<MessageBuffer<IRCMessage>>;
 using ChatMessageDispatcher = MessageDispatcher<IRCMessage>;
 
@@ -84,7 +118,8 @@ public:
 	static std::shared_ptr<TwitchChatConnection>
 	GetChatConnection(const TwitchToken &token,
 			  const TwitchChannel &channel);
-	[[nodiscard]] ChatMessageBuffer RegisterForMessages();
+	[[nodiscard]] ChatMessageBuffer
+	RegisterForMessages(const ChatMessageFilter &filter = {});
 	[[nodiscard]] ChatMessageBuffer RegisterForWhispers();
 	void SendChatMessage(const std::string &message);
 	void ConnectToChat();
@@ -4,6 +4,7 @@
 #include <obs-module-helper.hpp>
 #include <QComboBox>
 #include <ui-helpers.hpp>
+#include <unordered_map>
 
 namespace advss {
 
@@ -543,4 +544,71 @@ bool ChatMessagePattern::Matches(const IRCMessage &chatMessage) const
 	return true;
 }
 
+static bool containsVariables(const StringVariable &value)
+{
+	return value.UnresolvedValue().find("${") != std::string::npos;
+}
+
+static void setTextFilter(ChatMessageFilter &filter, const std::string &text,
+			  const RegexConfig &regex)
+{
+	const auto literal = GetRegexLiteral(text, regex);
+	switch (literal.type) {
+	case RegexLiteral::Type::ANY:
+		return;
+	case RegexLiteral::Type::EXACT:
+		filter.textMatch = ChatMessageFilter::TextMatch::EXACT;
+		break;
+	case RegexLiteral::Type::PREFIX:
+		filter.textMatch = ChatMessageFilter::TextMatch::PREFIX;
+		break;
+	case RegexLiteral::Type::CONTAINS:
+		filter.textMatch = ChatMessageFilter::TextMatch::CONTAINS;
+		break;
+	}
+	filter.text = literal.text;
+}
+
+ChatMessageFilter ChatMessagePattern::GetFilter() const
+{
+	static const std::unordered_map<std::string, ChatMessageFilter::Flag>
+		flags = {
+			{"firstMessage", ChatMessageFilter::FIRST_MESSAGE},
+			{"emoteOnly", ChatMessageFilter::EMOTE_ONLY},
+			{"mod", ChatMessageFilter::MOD},
+			{"subscriber", ChatMessageFilter::SUBSCRIBER},
+			{"turbo", ChatMessageFilter::TURBO},
+			{"vip", ChatMessageFilter::VIP},
+		};
+
+	ChatMessageFilter filter;
+	filter.types = {IRCMessage::Type::MESSAGE_RECEIVED};
+
+	for (const auto &property : _properties) {
+		if (std::holds_alternative<bool>(property._value)) {
+			auto it = flags.find(property._id);
+			if (it == flags.end()) {
+				continue;
+			}
+			if (std::get<bool>(property._value)) {
+				filter.requiredFlags |= it->second;
+			} else {
+				filter.excludedFlags |= it->second;
+			}
+			continue;
+		}
+
+		const auto &value = std::get<StringVariable>(property._value);
+		if (property._id == "badge" && !property._regex.Enabled() &&
+		    !containsVariables(value)) {
+			filter.badges.emplace_back(value.UnresolvedValue());
+		}
+	}
+
+	if (!containsVariables(_message)) {
+		setTextFilter(filter, _message.UnresolvedValue(), _regex);
+	}
+	return filter;
+}
+
 } // namespace advss
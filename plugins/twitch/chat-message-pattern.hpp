@@ -44,6 +44,9 @@ public:
 	void Load(obs_data_t *obj);
 
 	bool Matches(const IRCMessage &) const;
+	// Returns criteria, which all messages matching this pattern fulfill
+	// and which can be checked without resolving any variables
+	ChatMessageFilter GetFilter() const;
 
 	StringVariable _message = ".*";
 	RegexConfig _regex = RegexConfig::PartialMatchRegexConfig(true);
@@ -157,9 +157,10 @@ void EventSub::Disconnect()
 	ClearActiveSubscriptions();
 }
 
-EventSubMessageBuffer EventSub::RegisterForEvents()
+EventSubMessageBuffer
+EventSub::RegisterForEvents(const EventSubMessageDispatcher::Filter &filter)
 {
-	return _dispatcher.RegisterClient();
+	return _dispatcher.RegisterClient(filter);
 }
 
 bool EventSub::SubscriptionIsActive(const std::string &id)
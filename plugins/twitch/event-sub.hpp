@@ -53,7 +53,8 @@ public:
 
 	void Connect();
 	void Disconnect();
-	[[nodiscard]] EventSubMessageBuffer RegisterForEvents();
+	[[nodiscard]] EventSubMessageBuffer RegisterForEvents(
+		const EventSubMessageDispatcher::Filter &filter = {});
 	bool SubscriptionIsActive(const std::string &id);
 	static std::string AddEventSubscription(std::shared_ptr<TwitchToken>,
 						Subscription);
@@ -236,6 +236,8 @@ void MacroConditionTwitch::SetCondition(const Condition &condition)
 	_condition = condition;
 	SetupTempVars();
 	ResetSubscription();
+	_chatBuffer.reset();
+	_chatMessages.clear();
 }
 
 void MacroConditionTwitch::SetToken(const std::weak_ptr<TwitchToken> &t)
@@ -256,61 +258,63 @@ void MacroConditionTwitch::SetPointsReward(
 	ResetSubscription();
 }
 
-void MacroConditionTwitch::ResetChatConnection()
+void MacroConditionTwitch::SetChatMessagePattern(
+	const ChatMessagePattern &pattern)
 {
-	_chatConnection.reset();
+	_chatMessagePattern = pattern;
+	// The connection has to filter the messages using the new pattern
+	_chatBuffer.reset();
+	_chatMessages.clear();
 }
 
-bool MacroConditionTwitch::CheckChannelGenericEvents()
+void MacroConditionTwitch::ResetChatConnection()
 {
-	return HandleMatchingSubscriptionEvents([this](const Event &event) {
-		SetVariableValue(event.ToString());
-		SetJsonTempVars(event.data,
-				[this](const char *id, const char *value) {
-					SetTempVarValue(id, value);
-				});
-	});
+	_chatConnection.reset();
+	_chatBuffer.reset();
+	_chatMessages.clear();
 }
 
-bool MacroConditionTwitch::CheckChannelLiveEvents()
+// Messages are taken from the buffer in batches to avoid synchronizing with
+// the dispatching thread for each of the messages.
+// Messages following the first match are kept for the next check.
+template<class T>
+static bool
+handleMessages(MessageBuffer<T> &buffer,
+	       std::vector<typename MessageBuffer<T>::Message> &messages,
+	       bool clearBufferOnMatch,
+	       const std::function<bool(const T &)> &matchCb)
 {
-	if (!_eventBuffer) {
-		return false;
-	}
-
-	while (!_eventBuffer->Empty()) {
-		auto event = _eventBuffer->ConsumeMessage();
-		if (!event) {
-			continue;
-		}
-		if (_subscriptionID != event->id) {
+	while (!messages.empty() || buffer.ConsumeMessages(messages) > 0) {
+		auto it = std::find_if(messages.begin(), messages.end(),
+				       [&matchCb](const auto &message) {
+					       return message &&
+						      matchCb(*message);
+				       });
+		if (it == messages.end()) {
+			messages.clear();
 			continue;
 		}
 
-		auto it = liveEventIDs.find(_condition);
-		if (it == liveEventIDs.end()) {
-			continue;
-		}
-
-		auto type = obs_data_get_string(event->data, "type");
-		const auto &typeId = it->second;
-		if (type != typeId) {
-			continue;
+		if (clearBufferOnMatch) {
+			messages.clear();
+			buffer.Clear();
+		} else {
+			messages.erase(messages.begin(), it + 1);
 		}
+		return true;
+	}
+	return false;
+}
 
-		SetVariableValue(event->ToString());
-		SetJsonTempVars(event->data,
+bool MacroConditionTwitch::CheckChannelGenericEvents()
+{
+	return HandleMatchingSubscriptionEvents([this](const Event &event) {
+		SetVariableValue(event.ToString());
+		SetJsonTempVars(event.data,
 				[this](const char *id, const char *value) {
 					SetTempVarValue(id, value);
 				});
-
-		if (_clearBufferOnMatch) {
-			_eventBuffer->Clear();
-		}
-		return true;
-	}
-
-	return false;
+	});
 }
 
 bool MacroConditionTwitch::CheckChannelRewardChangeEvents()
@@ -389,23 +393,15 @@ bool MacroConditionTwitch::HandleMatchingSubscriptionEvents(
 		return false;
 	}
 
-	while (!_eventBuffer->Empty()) {
-		auto event = _eventBuffer->ConsumeMessage();
-		if (!event) {
-			continue;
-		}
-		if (_subscriptionID != event->id) {
-			continue;
-		}
-		matchCb(*event);
-
-		if (_clearBufferOnMatch) {
-			_eventBuffer->Clear();
-		}
-		return true;
-	}
-
-	return false;
+	return handleMessages<Event>(
+		*_eventBuffer, _events, _clearBufferOnMatch,
+		[this, &matchCb](const Event &event) {
+			if (_subscriptionID != event.id) {
+				return false;
+			}
+			matchCb(event);
+			return true;
+		});
 }
 
 static bool stringMatches(const RegexConfig &regex, const std::string &string,
@@ -549,31 +545,46 @@ bool MacroConditionTwitch::ChatConnectionIsSetup(TwitchToken &token)
 		if (!_chatConnection) {
 			return false;
 		}
-		_chatBuffer = _chatConnection->RegisterForMessages();
+	}
+	if (!_chatBuffer) {
+		_chatBuffer = _chatConnection->RegisterForMessages(
+			GetChatMessageFilter());
+		_chatMessages.clear();
 		return false;
 	}
 	return true;
 }
 
+ChatMessageFilter MacroConditionTwitch::GetChatMessageFilter() const
+{
+	ChatMessageFilter filter;
+	switch (_condition) {
+	case Condition::CHAT_MESSAGE_RECEIVED:
+		filter = _chatMessagePattern.GetFilter();
+		break;
+	case Condition::CHAT_MESSAGE_REMOVED:
+		filter.types = {IRCMessage::Type::MESSAGE_REMOVED};
+		break;
+	case Condition::CHAT_CLEARED:
+		filter.types = {IRCMessage::Type::MESSAGE_CLEARED};
+		break;
+	case Condition::CHAT_USER_JOINED:
+		filter.types = {IRCMessage::Type::USER_JOIN};
+		break;
+	case Condition::CHAT_USER_LEFT:
+		filter.types = {IRCMessage::Type::USER_LEAVE};
+		break;
+	default:
+		break;
+	}
+	return filter;
+}
+
 bool MacroConditionTwitch::HandleChatEvents(
 	const std::function<bool(const IRCMessage &)> &matchCb)
 {
-	while (!_chatBuffer->Empty()) {
-		auto message = _chatBuffer->ConsumeMessage();
-		if (!message) {
-			continue;
-		}
-
-		if (!matchCb(*message)) {
-			continue;
-		}
-
-		if (_clearBufferOnMatch) {
-			_chatBuffer->Clear();
-		}
-		return true;
-	}
-	return false;
+	return handleMessages(*_chatBuffer, _chatMessages, _clearBufferOnMatch,
+			      matchCb);
 }
 
 void MacroConditionTwitch::SetTempVarValues(const ChannelLiveInfo &info)
@@ -654,9 +665,11 @@ void MacroConditionTwitch::HandleMacroPause()
 		if (_eventBuffer) {
 			_eventBuffer->Clear();
 		}
+		_events.clear();
 		if (_chatBuffer) {
 			_chatBuffer->Clear();
 		}
+		_chatMessages.clear();
 	}
 }
 
@@ -725,7 +738,7 @@ bool MacroConditionTwitch::CheckCondition()
 	case Condition::STREAM_ONLINE_WATCHPARTY_EVENT:
 	case Condition::STREAM_ONLINE_PREMIERE_EVENT:
 	case Condition::STREAM_ONLINE_RERUN_EVENT:
-		return CheckChannelLiveEvents();
+		return CheckChannelGenericEvents();
 	case Condition::LIVE_POLLING: {
 		auto info = _channel.GetLiveInfo(*token);
 		if (!info) {
@@ -1042,6 +1055,7 @@ void MacroConditionTwitch::RegisterEventSubscription()
 void MacroConditionTwitch::ResetSubscription()
 {
 	_eventBuffer.reset();
+	_events.clear();
 	_subscriptionID = "";
 }
 
@@ -1058,7 +1072,30 @@ void MacroConditionTwitch::SetupEventSubscription(EventSub &eventSub)
 		return;
 	}
 	RegisterEventSubscription();
-	_eventBuffer = eventSub.RegisterForEvents();
+	_eventBuffer = eventSub.RegisterForEvents(GetEventFilter());
+	_events.clear();
+}
+
+EventSubMessageDispatcher::Filter MacroConditionTwitch::GetEventFilter() const
+{
+	auto it = eventIdentifiers.find(_condition);
+	if (it == eventIdentifiers.end()) {
+		return {};
+	}
+
+	const auto type = it->second;
+	auto liveIt = liveEventIDs.find(_condition);
+	if (liveIt == liveEventIDs.end()) {
+		return [type](const Event &event) {
+			return event.type == type;
+		};
+	}
+
+	const auto liveType = liveIt->second;
+	return [type, liveType](const Event &event) {
+		return event.type == type &&
+		       obs_data_get_string(event.data, "type") == liveType;
+	};
 }
 
 bool MacroConditionTwitch::IsUsingEventSubCondition()
@@ -1695,7 +1732,7 @@ void MacroConditionTwitchEdit::ChatMessagePatternChanged(
 	const ChatMessagePattern &chatMessagePattern)
 {
 	GUARD_LOADING_AND_LOCK();
-	_entryData->_chatMessagePattern = chatMessagePattern;
+	_entryData->SetChatMessagePattern(chatMessagePattern);
 	adjustSize();
 	updateGeometry();
 }
@@ -93,6 +93,7 @@ public:
 	TwitchChannel GetChannel() const { return _channel; }
 	void SetPointsReward(const TwitchPointsReward &pointsReward);
 	TwitchPointsReward GetPointsReward() const { return _pointsReward; }
+	void SetChatMessagePattern(const ChatMessagePattern &);
 	void ResetChatConnection();
 	bool IsUsingEventSubCondition();
 
@@ -112,7 +113,6 @@ public:
 
 private:
 	bool CheckChannelGenericEvents();
-	bool CheckChannelLiveEvents();
 	bool CheckChannelRewardChangeEvents();
 	bool CheckChannelRewardRedemptionEvents();
 	bool HandleMatchingSubscriptionEvents(
@@ -123,12 +123,14 @@ private:
 	bool CheckChatClear(TwitchToken &token);
 	bool CheckChatMessageRemove(TwitchToken &token);
 	bool ChatConnectionIsSetup(TwitchToken &token);
+	ChatMessageFilter GetChatMessageFilter() const;
 	bool HandleChatEvents(
 		const std::function<bool(const IRCMessage &)> &matchCb);
 
 	void RegisterEventSubscription();
 	void ResetSubscription();
 	void SetupEventSubscription(EventSub &);
+	EventSubMessageDispatcher::Filter GetEventFilter() const;
 	bool EventSubscriptionIsSetup(const std::shared_ptr<EventSub> &);
 	void AddChannelGenericEventSubscription(
 		const char *version, bool includeModeratorId = false,
@@ -146,10 +148,12 @@ private:
 	std::weak_ptr<TwitchToken> _token;
 
 	EventSubMessageBuffer _eventBuffer;
+	std::vector<EventSubMessageBuffer::element_type::Message> _events;
 	std::future<std::string> _subscriptionIDFuture;
 	std::string _subscriptionID;
 
 	ChatMessageBuffer _chatBuffer;
+	std::vector<ChatMessageBuffer::element_type::Message> _chatMessages;
 	std::shared_ptr<TwitchChatConnection> _chatConnection;
 
 	std::chrono::high_resolution_clock::time_point _lastCheck{};
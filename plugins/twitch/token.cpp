@@ -3,6 +3,7 @@
 
 #include <layout-helpers.hpp>
 #include <log-helper.hpp>
+#include <name-index.hpp>
 #include <obs-module-helper.hpp>
 #include <plugin-state-helpers.hpp>
 #include <QDesktopServices>
@@ -16,6 +17,7 @@ namespace advss {
 static const int tokenGrabberPort = 8080;
 
 static std::deque<std::shared_ptr<Item>> twitchTokens;
+static NameIndex<Item> tokenIndex(twitchTokens, GetItemNameGeneration);
 
 const std::unordered_map<std::string, std::string> TokenOption::_apiIdToLocale{
 	{"channel:manage:broadcast",
@@ -168,7 +170,7 @@ TwitchToken::TwitchToken(const TwitchToken &other)
 
 TwitchToken &TwitchToken::operator=(const TwitchToken &other)
 {
-	_name = other._name;
+	SetName(other._name);
 	_token = other._token;
 	_userID = other._userID;
 	_tokenOptions = other._tokenOptions;
@@ -267,7 +269,7 @@ void TwitchToken::SetToken(const std::string &value)
 	for (size_t i = 0; i < count; i++) {
 		OBSDataAutoRelease arrayObj = obs_data_array_item(array, i);
 		_userID = obs_data_get_string(arrayObj, "id");
-		_name = obs_data_get_string(arrayObj, "display_name");
+		SetName(obs_data_get_string(arrayObj, "display_name"));
 	}
 
 	// Trigger resubscribes with new token
@@ -337,24 +339,12 @@ TwitchToken *GetTwitchTokenByName(const QString &name)
 
 TwitchToken *GetTwitchTokenByName(const std::string &name)
 {
-	for (auto &t : twitchTokens) {
-		if (t->Name() == name) {
-			return dynamic_cast<TwitchToken *>(t.get());
-		}
-	}
-	return nullptr;
+	return dynamic_cast<TwitchToken *>(tokenIndex.Find(name).get());
 }
 
 std::weak_ptr<TwitchToken> GetWeakTwitchTokenByName(const std::string &name)
 {
-	for (const auto &t : twitchTokens) {
-		if (t->Name() == name) {
-			std::weak_ptr<TwitchToken> wp =
-				std::dynamic_pointer_cast<TwitchToken>(t);
-			return wp;
-		}
-	}
-	return std::weak_ptr<TwitchToken>();
+	return std::dynamic_pointer_cast<TwitchToken>(tokenIndex.Find(name));
 }
 
 std::weak_ptr<TwitchToken> GetWeakTwitchTokenByQString(const QString &name)
@@ -1,4 +1,5 @@
 #include "twitch-helpers.hpp"
+#include "http-client-pool.hpp"
 #include "plugin-state-helpers.hpp"
 #include "token.hpp"
 
@@ -11,6 +12,7 @@ namespace advss {
 static constexpr std::string_view clientID = "ds5tt4ogliifsqc04mz3d3etnck3e5";
 static const int cacheTimeoutSeconds = 10;
 static std::atomic_bool apiIsThrottling = {false};
+static constexpr std::chrono::milliseconds requestTimeout(5000);
 
 const char *GetClientID()
 {
@@ -195,7 +197,6 @@ static RequestResult sendGetRequest(const TwitchToken &token,
 		return {};
 	}
 
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -206,7 +207,12 @@ static RequestResult sendGetRequest(const TwitchToken &token,
 	vblog(LOG_INFO, "Twitch GET request to %s began", url.c_str());
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto response = cli.Get(path, params, headers);
+	auto response = GetHttpClientPool().Send(
+		uri,
+		[&](httplib::Client &cli) {
+			return cli.Get(path, params, headers);
+		},
+		requestTimeout);
 
 	return processResult(response, __func__);
 }
@@ -261,7 +267,6 @@ static RequestResult sendPostRequest(const TwitchToken &token,
 		return {};
 	}
 
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -274,8 +279,13 @@ static RequestResult sendPostRequest(const TwitchToken &token,
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
 	auto body = getRequestBody(data);
-	auto response =
-		cli.Post(pathWithParams, headers, body, "application/json");
+	auto response = GetHttpClientPool().Send(
+		uri,
+		[&](httplib::Client &cli) {
+			return cli.Post(pathWithParams, headers, body,
+					"application/json");
+		},
+		requestTimeout);
 
 	return processResult(response, __func__);
 }
@@ -332,7 +342,6 @@ static RequestResult sendPutRequest(const TwitchToken &token,
 		return {};
 	}
 
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -345,8 +354,13 @@ static RequestResult sendPutRequest(const TwitchToken &token,
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
 	auto body = getRequestBody(data);
-	auto response =
-		cli.Put(pathWithParams, headers, body, "application/json");
+	auto response = GetHttpClientPool().Send(
+		uri,
+		[&](httplib::Client &cli) {
+			return cli.Put(pathWithParams, headers, body,
+				       "application/json");
+		},
+		requestTimeout);
 
 	return processResult(response, __func__);
 }
@@ -403,7 +417,6 @@ static RequestResult sendPatchRequest(const TwitchToken &token,
 		return {};
 	}
 
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -416,8 +429,13 @@ static RequestResult sendPatchRequest(const TwitchToken &token,
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
 	auto body = getRequestBody(data);
-	auto response =
-		cli.Patch(pathWithParams, headers, body, "application/json");
+	auto response = GetHttpClientPool().Send(
+		uri,
+		[&](httplib::Client &cli) {
+			return cli.Patch(pathWithParams, headers, body,
+					 "application/json");
+		},
+		requestTimeout);
 
 	return processResult(response, __func__);
 }
@@ -473,7 +491,6 @@ static RequestResult sendDeleteRequest(const TwitchToken &token,
 		return {};
 	}
 
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -485,8 +502,13 @@ static RequestResult sendDeleteRequest(const TwitchToken &token,
 	vblog(LOG_INFO, "Twitch DELETE request to %s began", url.c_str());
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto response =
-		cli.Delete(pathWithParams, headers, "", "application/json");
+	auto response = GetHttpClientPool().Send(
+		uri,
+		[&](httplib::Client &cli) {
+			return cli.Delete(pathWithParams, headers, "",
+					  "application/json");
+		},
+		requestTimeout);
 
 	return processResult(response, __func__);
 }
@@ -38,28 +38,56 @@ void MacroConditionUSB::DeviceMatchOption::Load(obs_data_t *obj,
 	regex.Load(data);
 }
 
+bool MacroConditionUSB::Matches(const USBDeviceInfo &dev) const
+{
+	return _vendorID.Matches(dev.vendorID) &&
+	       _productID.Matches(dev.productID) &&
+	       _busNumber.Matches(dev.busNumber) &&
+	       _deviceAddress.Matches(dev.deviceAddress) &&
+	       _vendorName.Matches(dev.vendorName) &&
+	       _productName.Matches(dev.productName) &&
+	       _serialNumber.Matches(dev.serialNumber);
+}
+
+void MacroConditionUSB::SetTempVars(const USBDeviceInfo &dev)
+{
+	SetTempVarValue("vendorID", dev.vendorID);
+	SetTempVarValue("productID", dev.productID);
+	SetTempVarValue("busNumber", dev.busNumber);
+	SetTempVarValue("deviceAddress", dev.deviceAddress);
+	SetTempVarValue("vendorName", dev.vendorName);
+	SetTempVarValue("productName", dev.productName);
+	SetTempVarValue("serialNumber", dev.serialNumber);
+}
+
 bool MacroConditionUSB::CheckCondition()
 {
-	const auto devs = GetUSBDevices();
-	if (devs.empty()) {
+	if (_condition == Condition::CONNECTED) {
+		_nextEventId.reset();
+		const auto devs = GetUSBDeviceSnapshot();
+		for (const auto &dev : *devs) {
+			if (Matches(dev)) {
+				SetTempVars(dev);
+				return true;
+			}
+		}
 		return false;
 	}
 
-	for (const auto &dev : devs) {
-		if (_vendorID.Matches(dev.vendorID) &&
-		    _productID.Matches(dev.productID) &&
-		    _busNumber.Matches(dev.busNumber) &&
-		    _deviceAddress.Matches(dev.deviceAddress) &&
-		    _vendorName.Matches(dev.vendorName) &&
-		    _productName.Matches(dev.productName) &&
-		    _serialNumber.Matches(dev.serialNumber)) {
-			SetTempVarValue("vendorID", dev.vendorID);
-			SetTempVarValue("productID", dev.productID);
-			SetTempVarValue("busNumber", dev.busNumber);
-			SetTempVarValue("deviceAddress", dev.deviceAddress);
-			SetTempVarValue("vendorName", dev.vendorName);
-			SetTempVarValue("productName", dev.productName);
-			SetTempVarValue("serialNumber", dev.serialNumber);
+	// Only devices which arrived or were removed after the first check
+	// are considered
+	if (!_nextEventId) {
+		_nextEventId = GetNextUSBDeviceEventId();
+		return false;
+	}
+
+	const auto type = _condition == Condition::ARRIVED
+				  ? USBDeviceEvent::Type::ARRIVED
+				  : USBDeviceEvent::Type::REMOVED;
+	const auto events = GetUSBDeviceEvents(*_nextEventId);
+	for (const auto &event : events) {
+		if (event.type == type && Matches(event.device)) {
+			SetTempVars(event.device);
 			return true;
 		}
 	}
@@ -69,6 +97,7 @@ bool MacroConditionUSB::CheckCondition()
 bool MacroConditionUSB::Save(obs_data_t *obj) const
 {
 	MacroCondition::Save(obj);
+	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
 	_vendorID.Save(obj, "vendorID");
 	_productID.Save(obj, "productID");
 	_busNumber.Save(obj, "busNumber");
@@ -82,6 +111,7 @@ bool MacroConditionUSB::Save(obs_data_t *obj) const
 bool MacroConditionUSB::Load(obs_data_t *obj)
 {
 	MacroCondition::Load(obj);
+	_condition = static_cast<Condition>(obs_data_get_int(obj, "condition"));
 	_vendorID.Load(obj, "vendorID");
 	_productID.Load(obj, "productID");
 	_busNumber.Load(obj, "busNumber");
@@ -112,6 +142,16 @@ void MacroConditionUSB::SetupTempVars()
 		obs_module_text("AdvSceneSwitcher.tempVar.usb.serialNumber"));
 }
 
+static void populateConditionSelection(QComboBox *list)
+{
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.usb.condition.connected"));
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.usb.condition.arrived"));
+	list->addItem(obs_module_text(
+		"AdvSceneSwitcher.condition.usb.condition.removed"));
+}
+
 static void setupDevicePropertySelection(QComboBox *list,
 					 const QSet<QString> &items)
 {
@@ -142,6 +182,7 @@ void static populateNewLayoutRow(QGridLayout *layout, int &row,
 MacroConditionUSBEdit::MacroConditionUSBEdit(
 	QWidget *parent, std::shared_ptr<MacroConditionUSB> entryData)
 	: QWidget(parent),
+	  _conditions(new QComboBox()),
 	  _vendorID(new QComboBox()),
 	  _productID(new QComboBox()),
 	  _busNumber(new QComboBox()),
@@ -177,6 +218,7 @@ MacroConditionUSBEdit::MacroConditionUSBEdit(
 		serialNumbers.insert(QString::fromStdString(dev.serialNumber));
 	}
 
+	populateConditionSelection(_conditions);
 	setupDevicePropertySelection(_vendorID, vendorIDs);
 	setupDevicePropertySelection(_productID, productIDs);
 	setupDevicePropertySelection(_busNumber, busNumbers);
@@ -185,6 +227,8 @@ MacroConditionUSBEdit::MacroConditionUSBEdit(
 	setupDevicePropertySelection(_productName, productNames);
 	setupDevicePropertySelection(_serialNumber, serialNumbers);
 
+	QWidget::connect(_conditions, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(ConditionChanged(int)));
 	QWidget::connect(_vendorID, &QComboBox::currentTextChanged, this,
 			 &MacroConditionUSBEdit::VendorIDChanged);
 	QWidget::connect(_productID, &QComboBox::currentTextChanged, this,
@@ -247,9 +291,12 @@ MacroConditionUSBEdit::MacroConditionUSBEdit(
 	MinimizeSizeOfColumn(devicePropertyLayout, 0);
 	devicePropertyLayout->setContentsMargins(0, 0, 0, 0);
 
+	auto conditionLayout = new QHBoxLayout();
+	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.usb.entry"),
+		     conditionLayout, {{"{{conditions}}", _conditions}});
+
 	auto layout = new QVBoxLayout();
-	layout->addWidget(new QLabel(
-		obs_module_text("AdvSceneSwitcher.condition.usb.description")));
+	layout->addLayout(conditionLayout);
 	layout->addLayout(devicePropertyLayout);
 	if (devs.empty()) {
 		layout->addWidget(new QLabel(obs_module_text(
@@ -268,6 +315,7 @@ void MacroConditionUSBEdit::UpdateEntryData()
 		return;
 	}
 
+	_conditions->setCurrentIndex(static_cast<int>(_entryData->_condition));
 	_vendorID->setCurrentText(
 		QString::fromStdString(_entryData->_vendorID.pattern));
 	_productID->setCurrentText(
@@ -294,6 +342,13 @@ void MacroConditionUSBEdit::UpdateEntryData()
 	updateGeometry();
 }
 
+void MacroConditionUSBEdit::ConditionChanged(int index)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_condition =
+		static_cast<MacroConditionUSB::Condition>(index);
+}
+
 void MacroConditionUSBEdit::VendorIDChanged(const QString &text)
 {
 	GUARD_LOADING_AND_LOCK();
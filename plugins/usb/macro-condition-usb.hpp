@@ -4,6 +4,7 @@
 #include "regex-config.hpp"
 
 #include <QPushButton>
+#include <optional>
 
 namespace advss {
 
@@ -19,6 +20,13 @@ public:
 		return std::make_shared<MacroConditionUSB>(m);
 	}
 
+	enum class Condition {
+		CONNECTED,
+		ARRIVED,
+		REMOVED,
+	};
+	Condition _condition = Condition::CONNECTED;
+
 	struct DeviceMatchOption {
 		std::string pattern = ".*";
 		RegexConfig regex = RegexConfig(true);
@@ -37,8 +45,13 @@ public:
 	DeviceMatchOption _serialNumber;
 
 private:
+	bool Matches(const USBDeviceInfo &) const;
+	void SetTempVars(const USBDeviceInfo &);
 	void SetupTempVars();
 
+	// Id of the first device event not yet processed
+	std::optional<uint64_t> _nextEventId;
+
 	static bool _registered;
 	static const std::string id;
 };
@@ -59,6 +72,7 @@ public:
 	}
 
 private slots:
+	void ConditionChanged(int index);
 	void VendorIDChanged(const QString &text);
 	void ProductIDChanged(const QString &text);
 	void BusNumberChanged(const QString &text);
@@ -75,6 +89,7 @@ private slots:
 	void SerialNumberRegexChanged(const RegexConfig &regex);
 
 private:
+	QComboBox *_conditions;
 	QComboBox *_vendorID;
 	QComboBox *_productID;
 	QComboBox *_busNumber;
@@ -2,27 +2,87 @@
 #include "log-helper.hpp"
 #include "plugin-state-helpers.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <libusb.h>
+#include <map>
 #include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
 
 #define LOG_PREFIX "[usb] "
 
 namespace advss {
 
+namespace {
+
+// Identifies a device for as long as it is connected
+struct DeviceKey {
+	uint8_t bus = 0;
+	uint8_t address = 0;
+	uint16_t vendorID = 0;
+	uint16_t productID = 0;
+
+	bool operator<(const DeviceKey &other) const
+	{
+		return std::tie(bus, address, vendorID, productID) <
+		       std::tie(other.bus, other.address, other.vendorID,
+				other.productID);
+	}
+};
+
+} // namespace
+
+using Clock = std::chrono::steady_clock;
+
+// Without hotplug support changes can only be detected by rescanning.
+// Otherwise rescanning is only used to recover from missed hotplug events.
+static constexpr auto rescanInterval = std::chrono::seconds(10);
+static constexpr auto hotplugRescanInterval = std::chrono::minutes(1);
+static constexpr size_t maxEventCount = 256;
+
+static std::mutex mutex;
+static std::map<DeviceKey, USBDeviceInfo> devices;
+static USBDeviceSnapshot snapshot =
+	std::make_shared<const std::vector<USBDeviceInfo>>();
+static std::deque<USBDeviceEvent> events;
+static uint64_t nextEventId = 0;
+
+// Only accessed by the registry thread
+static std::vector<libusb_device *> arrivedDevices;
+static libusb_hotplug_callback_handle hotplugHandle;
+static bool hotplugRegistered = false;
+
+static std::thread registryThread;
+static std::atomic_bool stopRegistry = {false};
+static std::mutex stopMutex;
+static std::condition_variable stopCV;
+
 static bool setup();
 static bool setupDone = setup();
-static bool hotplugsAreSupported = false;
-static std::mutex mutex;
+
+static void startRegistry();
+static void stopRegistryThread();
 
 static bool setup()
 {
 	AddPluginInitStep([]() {
-		libusb_init(NULL);
-		hotplugsAreSupported =
-			libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG);
+		const int ret = libusb_init(NULL);
+		if (ret != LIBUSB_SUCCESS) {
+			blog(LOG_WARNING,
+			     LOG_PREFIX "failed to initialize libusb: %s",
+			     libusb_strerror(ret));
+			return;
+		}
+		startRegistry();
+	});
+	AddPluginCleanupStep([]() {
+		stopRegistryThread();
+		libusb_exit(NULL);
 	});
-	AddPluginCleanupStep([]() { libusb_exit(NULL); });
 	return true;
 }
 
@@ -34,178 +94,294 @@ static void logLibusbError(int value, const char *msg)
 	vblog(LOG_WARNING, LOG_PREFIX "%s: %s", msg, libusb_strerror(value));
 }
 
-static USBDeviceInfo
-getDeviceInfo(libusb_device *device, libusb_device_handle *handle,
-	      const struct libusb_device_descriptor &descriptor)
-{
-	char vendor_name[256] = {};
-	char product_name[256] = {};
-	char serial_number[256] = {};
-	int ret = libusb_get_string_descriptor_ascii(handle,
-						     descriptor.iManufacturer,
-						     (uint8_t *)vendor_name,
-						     sizeof(vendor_name));
-	logLibusbError(ret, "Failed to query vendor name");
-	ret = libusb_get_string_descriptor_ascii(handle, descriptor.iProduct,
-						 (uint8_t *)product_name,
-						 sizeof(product_name));
-	logLibusbError(ret, "Failed to query product name");
-	ret = libusb_get_string_descriptor_ascii(handle,
-						 descriptor.iSerialNumber,
-						 (uint8_t *)serial_number,
-						 sizeof(serial_number));
-	logLibusbError(ret, "Failed to query serial number");
-
-	const USBDeviceInfo deviceInfo = {
-		std::to_string(descriptor.idVendor),
-		std::to_string(descriptor.idProduct),
-		std::to_string(libusb_get_bus_number(device)),
-		std::to_string(libusb_get_device_address(device)),
-		vendor_name,
-		product_name,
-		serial_number};
-	return deviceInfo;
-}
-
-static std::vector<USBDeviceInfo> pollUSBDevices()
+static std::string getStringDescriptor(libusb_device_handle *handle,
+				       uint8_t index, const char *name)
 {
-	libusb_device **devices;
-	ssize_t count = libusb_get_device_list(NULL, &devices);
-	if (count < 0) {
-		logLibusbError(count, "Failed to query device list");
-		return {};
+	if (index == 0) {
+		return "";
 	}
 
-	std::vector<USBDeviceInfo> result;
-
-	for (int i = 0; i < count; i++) {
-		libusb_device *device = devices[i];
-		struct libusb_device_descriptor descriptor;
-
-		int ret = libusb_get_device_descriptor(device, &descriptor);
-		if (ret != LIBUSB_SUCCESS) {
-			logLibusbError(ret, "Error getting device descriptor");
-			continue;
-		}
+	char value[256] = {};
+	const int ret = libusb_get_string_descriptor_ascii(
+		handle, index, (uint8_t *)value, sizeof(value));
+	if (ret < LIBUSB_SUCCESS) {
+		const auto msg = std::string("Failed to query ") + name;
+		logLibusbError(ret, msg.c_str());
+		return "";
+	}
+	return value;
+}
 
-		libusb_device_handle *handle;
-		ret = libusb_open(device, &handle);
-		if (ret != LIBUSB_SUCCESS) {
-			logLibusbError(ret, "Error opening device");
-			continue;
-		}
-		result.emplace_back(getDeviceInfo(device, handle, descriptor));
-		libusb_close(handle);
+static bool getDeviceKey(libusb_device *device, DeviceKey &key,
+			 libusb_device_descriptor &descriptor)
+{
+	const int ret = libusb_get_device_descriptor(device, &descriptor);
+	if (ret != LIBUSB_SUCCESS) {
+		logLibusbError(ret, "Error getting device descriptor");
+		return false;
 	}
+	key.bus = libusb_get_bus_number(device);
+	key.address = libusb_get_device_address(device);
+	key.vendorID = descriptor.idVendor;
+	key.productID = descriptor.idProduct;
+	return true;
+}
 
-	libusb_free_device_list(devices, 1);
+// Opens the device to read its descriptor strings, which is why this must
+// only be done once per connected device
+static USBDeviceInfo
+queryDeviceInfo(libusb_device *device, const DeviceKey &key,
+		const struct libusb_device_descriptor &descriptor)
+{
+	USBDeviceInfo deviceInfo = {std::to_string(key.vendorID),
+				    std::to_string(key.productID),
+				    std::to_string(key.bus),
+				    std::to_string(key.address),
+				    "",
+				    "",
+				    ""};
+
+	libusb_device_handle *handle;
+	const int ret = libusb_open(device, &handle);
+	if (ret != LIBUSB_SUCCESS) {
+		logLibusbError(ret, "Error opening device");
+		return deviceInfo;
+	}
+	deviceInfo.vendorName = getStringDescriptor(
+		handle, descriptor.iManufacturer, "vendor name");
+	deviceInfo.productName = getStringDescriptor(
+		handle, descriptor.iProduct, "product name");
+	deviceInfo.serialNumber = getStringDescriptor(
+		handle, descriptor.iSerialNumber, "serial number");
+	libusb_close(handle);
+	return deviceInfo;
+}
 
-	return result;
+static void addEvent(USBDeviceEvent::Type type, const USBDeviceInfo &device)
+{
+	events.push_back({type, device, nextEventId++});
+	if (events.size() > maxEventCount) {
+		events.pop_front();
+	}
 }
 
-static int hotplugCallback(struct libusb_context *,
-			   struct libusb_device *device,
-			   libusb_hotplug_event event, void *user_data)
+static void updateSnapshot()
 {
-	auto devices = static_cast<std::vector<USBDeviceInfo> *>(user_data);
+	auto newSnapshot = std::make_shared<std::vector<USBDeviceInfo>>();
+	newSnapshot->reserve(devices.size());
+	for (const auto &[_, device] : devices) {
+		newSnapshot->emplace_back(device);
+	}
+	snapshot = newSnapshot;
+}
 
-	static libusb_device_handle *handle = nullptr;
-	struct libusb_device_descriptor descriptor;
+static bool isKnownDevice(const DeviceKey &key)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return devices.find(key) != devices.end();
+}
 
-	int ret = libusb_get_device_descriptor(device, &descriptor);
-	logLibusbError(ret, "Error getting device descriptor");
+// Devices which are already connected when the plugin starts did not arrive,
+// so the initial scan does not report them as device events
+static void addDevice(libusb_device *device, bool addArrivedEvent)
+{
+	DeviceKey key;
+	libusb_device_descriptor descriptor;
+	if (!getDeviceKey(device, key, descriptor) || isKnownDevice(key)) {
+		return;
+	}
 
-	ret = libusb_open(device, &handle);
-	if (ret != LIBUSB_SUCCESS) {
-		logLibusbError(ret, "Error opening device");
-		return 0;
+	const auto deviceInfo = queryDeviceInfo(device, key, descriptor);
+	std::lock_guard<std::mutex> lock(mutex);
+	devices[key] = deviceInfo;
+	if (addArrivedEvent) {
+		addEvent(USBDeviceEvent::Type::ARRIVED, deviceInfo);
 	}
-	const auto deviceInfo = getDeviceInfo(device, handle, descriptor);
+	updateSnapshot();
+}
 
+static void removeDevice(const DeviceKey &key)
+{
 	std::lock_guard<std::mutex> lock(mutex);
-	if (LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED == event) {
-		devices->emplace_back(deviceInfo);
-	} else if (LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT == event) {
-		devices->erase(std::find(devices->begin(), devices->end(),
-					 deviceInfo));
+	auto it = devices.find(key);
+	if (it == devices.end()) {
+		return;
 	}
+	addEvent(USBDeviceEvent::Type::REMOVED, it->second);
+	devices.erase(it);
+	updateSnapshot();
+}
 
-	libusb_close(handle);
+static void rescan(bool initialScan = false)
+{
+	libusb_device **list;
+	const ssize_t count = libusb_get_device_list(NULL, &list);
+	if (count < 0) {
+		logLibusbError((int)count, "Failed to query device list");
+		return;
+	}
+
+	std::set<DeviceKey> connectedDevices;
+	for (ssize_t i = 0; i < count; i++) {
+		DeviceKey key;
+		libusb_device_descriptor descriptor;
+		if (getDeviceKey(list[i], key, descriptor)) {
+			connectedDevices.insert(key);
+			addDevice(list[i], !initialScan);
+		}
+	}
+	libusb_free_device_list(list, 1);
+
+	std::vector<DeviceKey> removedDevices;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto &[key, _] : devices) {
+			if (connectedDevices.count(key) == 0) {
+				removedDevices.emplace_back(key);
+			}
+		}
+	}
+	for (const auto &key : removedDevices) {
+		removeDevice(key);
+	}
+}
 
+// Synchronous requests, like querying the descriptor strings, must not be sent
+// from within the hotplug callback, so arrived devices are only queued here
+static int hotplugCallback(struct libusb_context *,
+			   struct libusb_device *device,
+			   libusb_hotplug_event event, void *)
+{
+	if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED) {
+		arrivedDevices.emplace_back(libusb_ref_device(device));
+	} else if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT) {
+		DeviceKey key;
+		libusb_device_descriptor descriptor;
+		if (getDeviceKey(device, key, descriptor)) {
+			removeDevice(key);
+		}
+	}
 	return 0;
 }
 
-static std::vector<USBDeviceInfo> getHotplugBasedDeviceList()
+static void addArrivedDevices()
 {
-	static std::vector<USBDeviceInfo> devices;
-	static bool hotplugSetupDone = false;
+	for (auto device : arrivedDevices) {
+		addDevice(device, true);
+		libusb_unref_device(device);
+	}
+	arrivedDevices.clear();
+}
 
-	if (!hotplugSetupDone) {
-		hotplugSetupDone = true;
-		devices = pollUSBDevices();
+static void waitForStop(std::chrono::seconds timeout)
+{
+	std::unique_lock<std::mutex> lock(stopMutex);
+	stopCV.wait_for(lock, timeout, []() { return stopRegistry.load(); });
+}
 
-		int ret = libusb_hotplug_register_callback(
+static void runRegistry()
+{
+	if (libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+		const int ret = libusb_hotplug_register_callback(
 			nullptr,
 			LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED |
 				LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
 			0, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
-			LIBUSB_HOTPLUG_MATCH_ANY, hotplugCallback, &devices,
-			nullptr);
-		if (ret != LIBUSB_SUCCESS) {
-			hotplugsAreSupported = false;
-		} else {
-			blog(LOG_WARNING, LOG_PREFIX "hotplug supported!");
-		}
+			LIBUSB_HOTPLUG_MATCH_ANY, hotplugCallback, nullptr,
+			&hotplugHandle);
+		hotplugRegistered = ret == LIBUSB_SUCCESS;
+		logLibusbError(ret, "Failed to register hotplug callback");
 	}
 
-	std::lock_guard<std::mutex> lock(mutex);
-	return devices;
+	rescan(true);
+	auto lastRescan = Clock::now();
+	while (!stopRegistry) {
+		if (!hotplugRegistered) {
+			waitForStop(rescanInterval);
+			if (!stopRegistry) {
+				rescan();
+			}
+			continue;
+		}
+
+		struct timeval timeout = {1, 0};
+		libusb_handle_events_timeout_completed(nullptr, &timeout,
+						       nullptr);
+		addArrivedDevices();
+		if (Clock::now() - lastRescan >= hotplugRescanInterval) {
+			rescan();
+			lastRescan = Clock::now();
+		}
+	}
 }
 
-static std::vector<USBDeviceInfo> getPollingBasedDeviceList()
+static void startRegistry()
 {
-	// Polling can be very expensive
-	// Perform this operation at most once every 10 seconds
-	static const int timeout = 10;
-	static std::vector<USBDeviceInfo> deviceList = {};
-	static std::chrono::high_resolution_clock::time_point lastUpdate = {};
+	stopRegistry = false;
+	registryThread = std::thread(runRegistry);
+}
 
-	std::lock_guard<std::mutex> lock(mutex);
-	auto now = std::chrono::high_resolution_clock::now();
-	if (std::chrono::duration_cast<std::chrono::seconds>(now - lastUpdate)
-		    .count() >= timeout) {
-		deviceList = pollUSBDevices();
-		lastUpdate = now;
+static void stopRegistryThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(stopMutex);
+		stopRegistry = true;
+	}
+	stopCV.notify_all();
+	if (hotplugRegistered) {
+		// Will also interrupt the event handling of the registry thread
+		libusb_hotplug_deregister_callback(nullptr, hotplugHandle);
+	}
+	if (registryThread.joinable()) {
+		registryThread.join();
 	}
+	hotplugRegistered = false;
+	for (auto device : arrivedDevices) {
+		libusb_unref_device(device);
+	}
+	arrivedDevices.clear();
+}
 
-	return deviceList;
+USBDeviceSnapshot GetUSBDeviceSnapshot()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return snapshot;
 }
 
 std::vector<USBDeviceInfo> GetUSBDevices()
 {
-	// Hotplug events do not seem to be firing consistently during testing
-	// on Linux so for now only rely on polling based functionality instead
-	return getPollingBasedDeviceList();
-
-	/*
-	if (hotplugsAreSupported) {
-		return getHotplugBasedDeviceList();
-	} else {
-		return getPollingBasedDeviceList();
-	}
-	*/
+	return *GetUSBDeviceSnapshot();
 }
 
 QStringList GetUSBDevicesStringList()
 {
 	QStringList result;
-	const auto devices = GetUSBDevices();
-	for (const auto &device : devices) {
+	const auto devices = GetUSBDeviceSnapshot();
+	for (const auto &device : *devices) {
 		result << device.ToQString();
 	}
 	return result;
 }
 
+uint64_t GetNextUSBDeviceEventId()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return nextEventId;
+}
+
+std::vector<USBDeviceEvent> GetUSBDeviceEvents(uint64_t &eventId)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<USBDeviceEvent> result;
+	for (const auto &event : events) {
+		if (event.id >= eventId) {
+			result.emplace_back(event);
+		}
+	}
+	eventId = nextEventId;
+	return result;
+}
+
 std::string USBDeviceInfo::ToString() const
 {
 	return "Vendor ID: " + vendorID + "\nProduct ID: " + productID +
@@ -220,7 +396,7 @@ QString USBDeviceInfo::ToQString() const
 	return QString::fromStdString(ToString());
 }
 
-bool USBDeviceInfo::operator==(const USBDeviceInfo &other)
+bool USBDeviceInfo::operator==(const USBDeviceInfo &other) const
 {
 	return vendorID == other.vendorID && productID == other.productID &&
 	       busNumber == other.busNumber &&
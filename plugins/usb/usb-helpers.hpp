@@ -1,6 +1,8 @@
 #pragma once
 #include <QString>
 #include <QStringList>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -18,10 +20,36 @@ struct USBDeviceInfo {
 	std::string ToString() const;
 	QString ToQString() const;
 
-	bool operator==(const USBDeviceInfo &other);
+	bool operator==(const USBDeviceInfo &other) const;
 };
 
+struct USBDeviceEvent {
+	enum class Type {
+		ARRIVED,
+		REMOVED,
+	};
+	Type type;
+	USBDeviceInfo device;
+	uint64_t id;
+};
+
+// The connected devices are tracked by a background thread, which enumerates
+// the devices once and then applies hotplug events or, if those are not
+// supported, periodically checks for changes.
+// The descriptor strings of a device are only queried once when it arrives.
+//
+// None of these functions access the devices directly.
+using USBDeviceSnapshot = std::shared_ptr<const std::vector<USBDeviceInfo>>;
+USBDeviceSnapshot GetUSBDeviceSnapshot();
 std::vector<USBDeviceInfo> GetUSBDevices();
 QStringList GetUSBDevicesStringList();
 
+// Returns the id the next device event will be assigned.
+// Devices which were already connected when the plugin was started are part
+// of the snapshot but were never reported as device events.
+uint64_t GetNextUSBDeviceEventId();
+// Returns the device events with an id of at least nextEventId, which were
+// not yet discarded, and updates nextEventId accordingly
+std::vector<USBDeviceEvent> GetUSBDeviceEvents(uint64_t &nextEventId);
+
 } // namespace advss
@@ -3,6 +3,7 @@
 
 #include <layout-helpers.hpp>
 #include <macro-condition-edit.hpp>
+#include <macro-helpers.hpp>
 #include <plugin-state-helpers.hpp>
 #include <QBuffer>
 #include <QColorDialog>
@@ -133,25 +134,16 @@ bool MacroConditionVideo::CheckCondition()
 		LoadImageFromFile();
 	}
 
-	if (_blockUntilScreenshotDone) {
-		GetScreenshot(true);
-	}
-
-	if (_screenshotData.IsDone()) {
+	if (GetScreenshot(_blockUntilScreenshotDone)) {
 		match = Compare();
 		_lastMatchResult = match;
 
 		if (!requiresFileInput(_condition)) {
-			_matchImage = std::move(_screenshotData.GetImage());
+			_matchImage = _screenshot;
 		}
-		_getNextScreenshot = true;
 	} else {
 		match = _lastMatchResult;
 	}
-
-	if (!_blockUntilScreenshotDone && _getNextScreenshot) {
-		GetScreenshot();
-	}
 	return match;
 }
 
@@ -208,10 +200,26 @@ std::string MacroConditionVideo::GetShortDesc() const
 	return _video.ToString();
 }
 
-void MacroConditionVideo::GetScreenshot(bool blocking)
+bool MacroConditionVideo::GetScreenshot(bool blocking)
 {
-	auto source = obs_weak_source_get_source(_video.GetVideo());
-	_screenshotData.~Screenshot();
+	const auto now = std::chrono::high_resolution_clock::now();
+	const std::chrono::milliseconds interval(GetIntervalValue());
+
+	// When blocking, a frame captured during the current check is required.
+	// Using the start of the check instead of the time of this request
+	// allows all video conditions of the same source to share one frame.
+	// Otherwise the frame requested during the previous check is used.
+	const auto notBefore = blocking ? GetMacroCheckStartTime()
+					: _lastFrameRequest;
+	const auto timeout = std::max(interval, std::chrono::milliseconds(300));
+
+	OBSSourceAutoRelease source =
+		obs_weak_source_get_source(_video.GetVideo());
+	auto frame = GetCapturedFrame(source, notBefore, blocking, timeout);
+	if (!frame) {
+		return false;
+	}
+
 	QRect screenshotArea;
 	if (_areaParameters.enable && _condition != VideoCondition::NO_IMAGE) {
 		screenshotArea.setRect(_areaParameters.area.x,
@@ -219,11 +227,14 @@ void MacroConditionVideo::GetScreenshot(bool blocking)
 				       _areaParameters.area.width,
 				       _areaParameters.area.height);
 	}
-	const int timeout = GetIntervalValue() < 300 ? 300 : GetIntervalValue();
-	new (&_screenshotData)
-		Screenshot(source, screenshotArea, blocking, timeout);
-	obs_source_release(source);
-	_getNextScreenshot = false;
+	_screenshot = GetCapturedFrameArea(frame, screenshotArea);
+	_lastFrameRequest = now;
+
+	if (!blocking) {
+		// Request the frame to be used during the next check
+		(void)GetCapturedFrame(source, now);
+	}
+	return true;
 }
 
 bool MacroConditionVideo::LoadImageFromFile()
@@ -272,17 +283,32 @@ void MacroConditionVideo::SetCondition(VideoCondition condition)
 
 bool MacroConditionVideo::ScreenshotContainsPattern()
 {
+	PatternMatchSearchOptions options;
+	options.coarseToFine = _patternMatchParameters.useCoarseToFine;
+	if (_patternMatchParameters.restrictToLastMatch) {
+		options.lastMatch = _lastPatternMatchLocation;
+	}
+
 	cv::Mat result;
-	MatchPattern(_screenshotData.GetImage(), _patternImageData,
+	MatchPattern(_screenshot, _patternImageData,
 		     _patternMatchParameters.threshold, result, nullptr,
 		     _patternMatchParameters.useAlphaAsMask,
-		     _patternMatchParameters.matchMode);
+		     _patternMatchParameters.matchMode, options);
 	if (result.total() == 0) {
+		_lastPatternMatchLocation.reset();
 		SetTempVarValue("patternCount", "0");
 		return false;
 	}
 	const auto count = countNonZero(result);
 	SetTempVarValue("patternCount", std::to_string(count));
+	if (count > 0) {
+		cv::Point bestMatchLocation;
+		cv::minMaxLoc(result, nullptr, nullptr, nullptr,
+			      &bestMatchLocation);
+		_lastPatternMatchLocation = bestMatchLocation;
+	} else {
+		_lastPatternMatchLocation.reset();
+	}
 	return count > 0;
 }
 
@@ -299,12 +325,12 @@ bool MacroConditionVideo::FileInputIsUpToDate() const
 bool MacroConditionVideo::OutputChanged()
 {
 	if (!_patternMatchParameters.useForChangedCheck) {
-		return _screenshotData.GetImage() != _matchImage;
+		return _screenshot != _matchImage;
 	}
 
 	cv::Mat result;
 	_patternImageData = CreatePatternData(_matchImage);
-	MatchPattern(_screenshotData.GetImage(), _patternImageData,
+	MatchPattern(_screenshot, _patternImageData,
 		     _patternMatchParameters.threshold, result, nullptr,
 		     _patternMatchParameters.useAlphaAsMask,
 		     _patternMatchParameters.matchMode);
@@ -320,7 +346,7 @@ bool MacroConditionVideo::ScreenshotContainsObject()
 	if (!model) {
 		return false;
 	}
-	auto objects = MatchObject(_screenshotData.GetImage(), *model,
+	auto objects = MatchObject(_screenshot, *model,
 				   _objMatchParameters.scaleFactor,
 				   _objMatchParameters.minNeighbors,
 				   _objMatchParameters.minSize.CV(),
@@ -333,19 +359,26 @@ bool MacroConditionVideo::ScreenshotContainsObject()
 bool MacroConditionVideo::CheckBrightnessThreshold()
 {
 	_currentBrightness =
-		GetAvgBrightness(_screenshotData.GetImage()) / 255.;
+		GetAvgBrightness(_screenshot) / 255.;
 	SetTempVarValue("brightness", std::to_string(_currentBrightness));
 	return _currentBrightness > _brightnessThreshold;
 }
 
 bool MacroConditionVideo::CheckOCR()
 {
-	if (!_ocrParameters.Initialized()) {
-		return false;
+	if (!_ocrWorker) {
+		_ocrWorker = std::make_unique<OCRWorker>();
 	}
 
-	auto text = RunOCR(_ocrParameters.GetOCR(), _screenshotData.GetImage(),
-			   _ocrParameters.color, _ocrParameters.colorThreshold);
+	// Text recognition is too slow to run as part of the condition check,
+	// so the result of the previously submitted frame is used instead
+	OCRWorker::Settings settings;
+	settings.config = _ocrParameters.GetConfig();
+	settings.color = _ocrParameters.color;
+	settings.colorDiff = _ocrParameters.colorThreshold;
+	_ocrWorker->Submit(_screenshot, settings);
+
+	auto text = _ocrWorker->GetText();
 	if (!text) {
 		return false;
 	}
@@ -361,14 +394,14 @@ bool MacroConditionVideo::CheckOCR()
 bool MacroConditionVideo::CheckColor()
 {
 	const bool ret = ContainsPixelsInColorRange(
-		_screenshotData.GetImage(), _colorParameters.color,
+		_screenshot, _colorParameters.color,
 		_colorParameters.colorThreshold,
 		_colorParameters.matchThreshold);
 	// Way too slow for now
-	//SetTempVarValue("dominantColor", GetDominantColor(_screenshotData.image, 3)
+	//SetTempVarValue("dominantColor", GetDominantColor(_screenshot, 3)
 	//				 .name(QColor::HexArgb)
 	//				 .toStdString());
-	SetTempVarValue("color", GetAverageColor(_screenshotData.GetImage())
+	SetTempVarValue("color", GetAverageColor(_screenshot)
 					 .name(QColor::HexArgb)
 					 .toStdString());
 	return ret;
@@ -382,15 +415,15 @@ bool MacroConditionVideo::Compare()
 
 	switch (_condition) {
 	case VideoCondition::MATCH:
-		return _screenshotData.GetImage() == _matchImage;
+		return _screenshot == _matchImage;
 	case VideoCondition::DIFFER:
-		return _screenshotData.GetImage() != _matchImage;
+		return _screenshot != _matchImage;
 	case VideoCondition::HAS_CHANGED:
 		return OutputChanged();
 	case VideoCondition::HAS_NOT_CHANGED:
 		return !OutputChanged();
 	case VideoCondition::NO_IMAGE:
-		return _screenshotData.GetImage().isNull();
+		return _screenshot.isNull();
 	case VideoCondition::PATTERN:
 		return ScreenshotContainsPattern();
 	case VideoCondition::OBJECT:
@@ -1180,6 +1213,10 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			  "AdvSceneSwitcher.condition.video.patternThresholdDescription"))),
 	  _useAlphaAsMask(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.condition.video.patternThresholdUseAlphaAsMask"))),
+	  _useCoarseToFine(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.video.patternUseCoarseToFine"))),
+	  _restrictToLastMatch(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.video.patternRestrictToLastMatch"))),
 	  _patternMatchModeLayout(new QHBoxLayout()),
 	  _patternMatchMode(new QComboBox()),
 	  _showMatch(new QPushButton(obs_module_text(
@@ -1242,6 +1279,10 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		SLOT(PatternThresholdChanged(const NumberVariable<double> &)));
 	QWidget::connect(_useAlphaAsMask, SIGNAL(stateChanged(int)), this,
 			 SLOT(UseAlphaAsMaskChanged(int)));
+	QWidget::connect(_useCoarseToFine, SIGNAL(stateChanged(int)), this,
+			 SLOT(UseCoarseToFineChanged(int)));
+	QWidget::connect(_restrictToLastMatch, SIGNAL(stateChanged(int)), this,
+			 SLOT(RestrictToLastMatchChanged(int)));
 	QWidget::connect(_patternMatchMode, SIGNAL(currentIndexChanged(int)),
 			 this, SLOT(PatternMatchModeChanged(int)));
 
@@ -1301,6 +1342,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	mainLayout->addWidget(_usePatternForChangedCheck);
 	mainLayout->addWidget(_patternThreshold);
 	mainLayout->addWidget(_useAlphaAsMask);
+	mainLayout->addWidget(_useCoarseToFine);
+	mainLayout->addWidget(_restrictToLastMatch);
 	mainLayout->addLayout(_patternMatchModeLayout);
 	mainLayout->addWidget(_brightness);
 	mainLayout->addWidget(_ocr);
@@ -1504,6 +1547,18 @@ void MacroConditionVideoEdit::UseAlphaAsMaskChanged(int value)
 		_entryData->_patternMatchParameters);
 }
 
+void MacroConditionVideoEdit::UseCoarseToFineChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_patternMatchParameters.useCoarseToFine = value;
+}
+
+void MacroConditionVideoEdit::RestrictToLastMatchChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_patternMatchParameters.restrictToLastMatch = value;
+}
+
 void MacroConditionVideoEdit::PatternMatchModeChanged(int idx)
 {
 	GUARD_LOADING_AND_LOCK();
@@ -1579,6 +1634,10 @@ void MacroConditionVideoEdit::SetWidgetVisibility()
 		needsThreshold(_entryData->GetCondition()));
 	_useAlphaAsMask->setVisible(_entryData->GetCondition() ==
 				    VideoCondition::PATTERN);
+	_useCoarseToFine->setVisible(_entryData->GetCondition() ==
+				     VideoCondition::PATTERN);
+	_restrictToLastMatch->setVisible(_entryData->GetCondition() ==
+					 VideoCondition::PATTERN);
 	SetLayoutVisible(_patternMatchModeLayout,
 			 _entryData->GetCondition() == VideoCondition::PATTERN);
 	_brightness->setVisible(_entryData->GetCondition() ==
@@ -1653,6 +1712,10 @@ void MacroConditionVideoEdit::UpdateEntryData()
 		_entryData->_patternMatchParameters.threshold);
 	_useAlphaAsMask->setChecked(
 		_entryData->_patternMatchParameters.useAlphaAsMask);
+	_useCoarseToFine->setChecked(
+		_entryData->_patternMatchParameters.useCoarseToFine);
+	_restrictToLastMatch->setChecked(
+		_entryData->_patternMatchParameters.restrictToLastMatch);
 	_patternMatchMode->setCurrentIndex(_patternMatchMode->findData(
 		_entryData->_patternMatchParameters.matchMode));
 	_throttleEnable->setChecked(_entryData->_throttleEnabled);
@@ -1,12 +1,13 @@
 #pragma once
 #include "opencv-helpers.hpp"
 #include "area-selection.hpp"
+#include "ocr-worker.hpp"
 #include "parameter-wrappers.hpp"
 #include "preview-dialog.hpp"
 
 #include <macro-condition-edit.hpp>
 #include <file-selection.hpp>
-#include <screenshot-helper.hpp>
+#include <frame-capture.hpp>
 #include <slider-spinbox.hpp>
 #include <variable-line-edit.hpp>
 #include <variable-text-edit.hpp>
@@ -40,7 +41,7 @@ public:
 		return std::make_shared<MacroConditionVideo>(m);
 	}
 	QImage GetMatchImage() const { return _matchImage; };
-	void GetScreenshot(bool blocking = false);
+	bool GetScreenshot(bool blocking = false);
 	bool LoadImageFromFile();
 	void ResetLastMatch() { _lastMatchResult = false; }
 	double GetCurrentBrightness() const { return _currentBrightness; }
@@ -93,10 +94,12 @@ private:
 
 	VideoCondition _condition = VideoCondition::MATCH;
 
-	bool _getNextScreenshot = true;
-	Screenshot _screenshotData;
+	QImage _screenshot;
+	std::chrono::high_resolution_clock::time_point _lastFrameRequest{};
 	QImage _matchImage;
 	PatternImageData _patternImageData;
+	std::optional<cv::Point> _lastPatternMatchLocation;
+	std::unique_ptr<OCRWorker> _ocrWorker;
 
 	bool _lastMatchResult = false;
 	int _runCount = 0;
@@ -281,6 +284,8 @@ private slots:
 	void UsePatternForChangedCheckChanged(int value);
 	void PatternThresholdChanged(const NumberVariable<double> &);
 	void UseAlphaAsMaskChanged(int value);
+	void UseCoarseToFineChanged(int value);
+	void RestrictToLastMatchChanged(int value);
 	void PatternMatchModeChanged(int value);
 
 	void ThrottleEnableChanged(int value);
@@ -311,6 +316,8 @@ private:
 
 	SliderSpinBox *_patternThreshold;
 	QCheckBox *_useAlphaAsMask;
+	QCheckBox *_useCoarseToFine;
+	QCheckBox *_restrictToLastMatch;
 	QHBoxLayout *_patternMatchModeLayout;
 	QComboBox *_patternMatchMode;
 
@@ -0,0 +1,124 @@
+#include "ocr-worker.hpp"
+
+#include <string_view>
+
+namespace advss {
+
+static size_t hashImage(const QImage &image)
+{
+	if (image.isNull()) {
+		return 0;
+	}
+
+	std::hash<std::string_view> hasher;
+	size_t hash = std::hash<int>()(image.width()) ^
+		      (std::hash<int>()(image.height()) << 1);
+	const size_t rowSize =
+		static_cast<size_t>(image.width()) * image.depth() / 8;
+	for (int y = 0; y < image.height(); y++) {
+		const std::string_view row(
+			reinterpret_cast<const char *>(image.constScanLine(y)),
+			rowSize);
+		hash ^= hasher(row) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	}
+	return hash;
+}
+
+bool OCRWorker::Settings::operator==(const Settings &other) const
+{
+	return config == other.config && color == other.color &&
+	       colorDiff == other.colorDiff;
+}
+
+OCRWorker::OCRWorker() : _thread(&OCRWorker::Run, this) {}
+
+OCRWorker::~OCRWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+void OCRWorker::Submit(const QImage &image, const Settings &settings)
+{
+	// Hashing the image is much cheaper than running OCR on it, so it is
+	// done on the calling thread to skip unchanged images right away
+	const auto imageHash = hashImage(image);
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	const bool settingsChanged = !_hasSubmitted ||
+				     settings != _lastSettings;
+	if (!settingsChanged && imageHash == _lastImageHash) {
+		return;
+	}
+
+	++_lastRequestId;
+	if (settingsChanged) {
+		// Results of requests using the old settings are outdated
+		_settingsChangeRequestId = _lastRequestId;
+		_text.reset();
+	}
+
+	_hasSubmitted = true;
+	_lastSettings = settings;
+	_lastImageHash = imageHash;
+	_pendingRequest = Request{image, settings, _lastRequestId};
+	_cv.notify_one();
+}
+
+std::optional<std::string> OCRWorker::GetText() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _text;
+}
+
+void OCRWorker::Run()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_cv.wait(lock, [this]() {
+			return _stop || _pendingRequest.has_value();
+		});
+		if (_stop) {
+			break;
+		}
+
+		auto request = std::move(*_pendingRequest);
+		_pendingRequest.reset();
+
+		lock.unlock();
+		Process(request);
+		lock.lock();
+	}
+	_ocr.reset();
+}
+
+void OCRWorker::Process(const Request &request)
+{
+	if (!_ocrConfig || *_ocrConfig != request.settings.config) {
+		_ocr = CreateOCR(request.settings.config);
+		_ocrConfig = request.settings.config;
+	}
+
+	std::optional<std::string> text;
+	if (_ocr) {
+		text = RunOCR(_ocr.get(), request.image,
+			      request.settings.color,
+			      request.settings.colorDiff);
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (request.id < _settingsChangeRequestId ||
+	    request.id < _resultRequestId) {
+		return;
+	}
+	_resultRequestId = request.id;
+	_text = text;
+}
+
+} // namespace advss
@@ -0,0 +1,80 @@
+#pragma once
+#include "parameter-wrappers.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <QColor>
+#include <QImage>
+
+namespace advss {
+
+// Runs text recognition on a dedicated thread, so condition checks do not
+// have to wait for Tesseract.
+//
+// The Tesseract instance is kept alive between requests and is only set up
+// again if the OCR configuration changes.
+// Images identical to the previously submitted one are not processed again.
+class OCRWorker {
+public:
+	struct Settings {
+		bool operator==(const Settings &) const;
+		bool operator!=(const Settings &other) const
+		{
+			return !(*this == other);
+		}
+
+		OCRConfig config;
+		QColor color;
+		double colorDiff = 0.0;
+	};
+
+	OCRWorker();
+	~OCRWorker();
+	OCRWorker(const OCRWorker &) = delete;
+	OCRWorker &operator=(const OCRWorker &) = delete;
+
+	// Queues the image for text recognition.
+	// Images which were not processed yet are replaced by newer ones.
+	void Submit(const QImage &, const Settings &);
+	// Returns the text of the most recently completed request.
+	// Returns nothing if text recognition failed or if no request using
+	// the current settings was completed yet.
+	std::optional<std::string> GetText() const;
+
+private:
+	struct Request {
+		QImage image;
+		Settings settings;
+		uint64_t id = 0;
+	};
+
+	void Run();
+	void Process(const Request &);
+
+	mutable std::mutex _mutex;
+	std::condition_variable _cv;
+	std::optional<Request> _pendingRequest;
+	uint64_t _lastRequestId = 0;
+	Settings _lastSettings;
+	size_t _lastImageHash = 0;
+	bool _hasSubmitted = false;
+
+	uint64_t _settingsChangeRequestId = 0;
+	uint64_t _resultRequestId = 0;
+	std::optional<std::string> _text;
+
+	// Only accessed by the worker thread
+	std::unique_ptr<tesseract::TessBaseAPI> _ocr;
+	std::optional<OCRConfig> _ocrConfig;
+
+	bool _stop = false;
+	std::thread _thread;
+};
+
+} // namespace advss
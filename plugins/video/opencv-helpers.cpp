@@ -22,35 +22,179 @@ PatternImageData CreatePatternData(const QImage &pattern)
 	return data;
 }
 
-static void preprocessPatternMatchResult(cv::Mat &mat, bool invert)
+// Not finite values have to be dismissed as they would otherwise be reported
+// as matches. These occur when the image is completely black, the denominator
+// in all normalized algorithms approaches 0 in these cases if the alpha channel
+// is used as mask.
+//
+// So we are clamping the values here to 0.0..1.0 and dismiss not-finite
+// values.
+// Invertion mode is for the TM_SQDIFF_NORMED method.
+//
+// The threshold is applied in the same pass and values not exceeding it are
+// set to zero.
+// Returns the highest value before applying the threshold.
+static double finalizePatternMatchResult(cv::Mat &mat, bool invert,
+					 double threshold)
 {
-	// Not finite values are not handled well by the cv::threshold method.
-	// These occur when the image is completely black, the denominator in all
-	// normalized algorithms approaches 0 in these cases if the alpha channel is
-	// used as mask.
-	//
-	// So we are clamping the values here to 0.0..1.0 and dismiss not-finite
-	// values.
-	// Invertion mode is for the TM_SQDIFF_NORMED method.
-	float value;
+	const float thresholdValue = static_cast<float>(threshold);
+	float bestFit = 0.0f;
 	for (int r = 0; r < mat.rows; r++) {
+		auto row = mat.ptr<float>(r);
 		for (int c = 0; c < mat.cols; c++) {
-			value = mat.at<float>(r, c);
-			if (invert) {
-				value = 1.0f - value;
-			}
-			if (!std::isfinite(value)) {
-				value = 0.0f;
-			}
-			mat.at<float>(r, c) =
-				std::fmaxf(0.0f, std::fminf(1.0f, value));
+			float value = invert ? 1.0f - row[c] : row[c];
+			value = std::isfinite(value) ? value : 0.0f;
+			value = std::fmaxf(0.0f, std::fminf(1.0f, value));
+			bestFit = std::fmaxf(bestFit, value);
+			row[c] = value > thresholdValue ? value : 0.0f;
 		}
 	}
+	return bestFit;
+}
+
+namespace {
+
+struct PatternMatchInput {
+	cv::Mat image;
+	cv::Mat pattern;
+	cv::Mat mask;
+	cv::TemplateMatchModes matchMode;
+	double threshold;
+};
+
+} // namespace
+
+// Matches the pattern against the given area of the image and writes the
+// finalized results to the corresponding area of the result
+static double matchArea(const PatternMatchInput &input, const cv::Rect &area,
+			cv::Mat &result)
+{
+	if (area.width < input.pattern.cols ||
+	    area.height < input.pattern.rows) {
+		return 0.0;
+	}
+
+	cv::Mat areaResult;
+	cv::matchTemplate(input.image(area), input.pattern, areaResult,
+			  input.matchMode, input.mask);
+
+	// A perfect match is represented as "0" for TM_SQDIFF_NORMED
+	//
+	// For TM_CCOEFF_NORMED and TM_CCORR_NORMED a perfect match is
+	// represented as "1"
+	//
+	// -> Invert TM_SQDIFF_NORMED in the finalize step
+	const double bestFit = finalizePatternMatchResult(
+		areaResult, input.matchMode == cv::TM_SQDIFF_NORMED,
+		input.threshold);
+	areaResult.copyTo(result(cv::Rect(area.x, area.y, areaResult.cols,
+					  areaResult.rows)));
+	return bestFit;
+}
+
+// Number of times the image and pattern can be halved in size while still
+// leaving enough detail in the pattern to locate candidates
+static int getPyramidLevels(const cv::Mat &pattern)
+{
+	constexpr int minPatternSize = 16;
+	constexpr int maxLevels = 3;
+	int levels = 0;
+	while (levels < maxLevels &&
+	       std::min(pattern.cols, pattern.rows) >> (levels + 1) >=
+		       minPatternSize) {
+		++levels;
+	}
+	return levels;
+}
+
+static cv::Mat downscale(const cv::Mat &mat, int levels, bool isMask = false)
+{
+	if (mat.empty()) {
+		return mat;
+	}
+	const double scale = 1.0 / (1 << levels);
+	cv::Mat scaled;
+	cv::resize(mat, scaled, cv::Size(), scale, scale,
+		   isMask ? cv::INTER_NEAREST : cv::INTER_AREA);
+	return scaled;
+}
+
+// Locates candidates on a downscaled version of the area and only matches the
+// surroundings of those candidates at full resolution
+static double matchAreaCoarseToFine(const PatternMatchInput &input,
+				    const cv::Rect &area, cv::Mat &result)
+{
+	const int levels = getPyramidLevels(input.pattern);
+	if (levels == 0) {
+		return matchArea(input, area, result);
+	}
+
+	PatternMatchInput coarseInput = input;
+	coarseInput.image = downscale(input.image(area), levels);
+	coarseInput.pattern = downscale(input.pattern, levels);
+	coarseInput.mask = downscale(input.mask, levels, true);
+	// Details are lost when downscaling, so the match quality of the
+	// candidates will be lower than at full resolution
+	constexpr double coarseThresholdMargin = 0.1;
+	coarseInput.threshold =
+		std::max(0.0, input.threshold - coarseThresholdMargin);
+
+	const cv::Rect coarseArea(0, 0, coarseInput.image.cols,
+				  coarseInput.image.rows);
+	cv::Mat coarseResult(
+		std::max(coarseArea.height - coarseInput.pattern.rows + 1, 0),
+		std::max(coarseArea.width - coarseInput.pattern.cols + 1, 0),
+		CV_32F, cv::Scalar(0));
+	if (matchArea(coarseInput, coarseArea, coarseResult) <=
+	    coarseInput.threshold) {
+		return 0.0;
+	}
+
+	cv::Mat1b candidates = coarseResult > 0;
+	std::vector<std::vector<cv::Point>> contours;
+	cv::findContours(candidates, contours, cv::RETR_EXTERNAL,
+			 cv::CHAIN_APPROX_SIMPLE);
+
+	// Searching lots of small areas is slower than a single full search
+	constexpr size_t maxCandidateAreas = 32;
+	if (contours.size() > maxCandidateAreas) {
+		return matchArea(input, area, result);
+	}
+
+	const int scale = 1 << levels;
+	const cv::Rect imageArea(0, 0, input.image.cols, input.image.rows);
+	double bestFit = 0.0;
+	for (const auto &contour : contours) {
+		const auto rect = cv::boundingRect(contour);
+		// Add one coarse pixel of tolerance in each direction and
+		// extend the area to cover the full pattern
+		const cv::Rect candidateArea =
+			cv::Rect(area.x + (rect.x - 1) * scale,
+				 area.y + (rect.y - 1) * scale,
+				 (rect.width + 2) * scale + input.pattern.cols,
+				 (rect.height + 2) * scale +
+					 input.pattern.rows) &
+			imageArea;
+		bestFit = std::max(bestFit,
+				   matchArea(input, candidateArea, result));
+	}
+	return bestFit;
+}
+
+static double matchPattern(const PatternMatchInput &input,
+			   const cv::Rect &area, cv::Mat &result,
+			   bool coarseToFine)
+{
+	if (coarseToFine) {
+		return matchAreaCoarseToFine(input, area, result);
+	}
+	return matchArea(input, area, result);
 }
 
 void MatchPattern(QImage &img, const PatternImageData &patternData,
 		  double threshold, cv::Mat &result, double *pBestFitValue,
-		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode)
+		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode,
+		  const PatternMatchSearchOptions &options)
 {
 	result = cv::Mat(0, 0, CV_32F);
 	if (pBestFitValue) {
@@ -64,41 +208,59 @@ void MatchPattern(QImage &img, const PatternImageData &patternData,
 		return;
 	}
 
-	auto input = QImageToMat(img);
+	PatternMatchInput input;
+	input.matchMode = matchMode;
+	input.threshold = threshold;
 
+	auto image = QImageToMat(img);
 	if (useAlphaAsMask) {
 		// Remove alpha channel of input image as the alpha channel
 		// information is used as a stencil for the pattern instead and
 		// thus should not be used while matching the pattern as well
 		//
 		// Input format is Format_RGBA8888 so discard the 4th channel
-		std::vector<cv::Mat1b> inputChannels;
-		cv::split(input, inputChannels);
-		std::vector<cv::Mat1b> rgbChanlesImage(
-			inputChannels.begin(), inputChannels.begin() + 3);
-		cv::Mat3b rgbInput;
-		cv::merge(rgbChanlesImage, rgbInput);
-
-		cv::matchTemplate(rgbInput, patternData.rgbPattern, result,
-				  matchMode, patternData.mask);
+		cv::cvtColor(image, input.image, cv::COLOR_RGBA2RGB);
+		input.pattern = patternData.rgbPattern;
+		input.mask = patternData.mask;
 	} else {
-		cv::matchTemplate(input, patternData.rgbaPattern, result,
-				  matchMode);
+		input.image = image;
+		input.pattern = patternData.rgbaPattern;
 	}
 
-	// A perfect match is represented as "0" for TM_SQDIFF_NORMED
-	//
-	// For TM_CCOEFF_NORMED and TM_CCORR_NORMED a perfect match is
-	// represented as "1"
-	//
-	// -> Invert TM_SQDIFF_NORMED in the preprocess step
-	preprocessPatternMatchResult(result, matchMode == cv::TM_SQDIFF_NORMED);
+	result = cv::Mat(input.image.rows - input.pattern.rows + 1,
+			 input.image.cols - input.pattern.cols + 1, CV_32F,
+			 cv::Scalar(0));
+	const cv::Rect imageArea(0, 0, input.image.cols, input.image.rows);
+
+	double bestFit = 0.0;
+	bool searchedFullImage = true;
+	if (options.lastMatch) {
+		// Allow the pattern to move by half its size in each direction
+		const int marginX = input.pattern.cols / 2;
+		const int marginY = input.pattern.rows / 2;
+		const cv::Rect window =
+			cv::Rect(options.lastMatch->x - marginX,
+				 options.lastMatch->y - marginY,
+				 input.pattern.cols + 2 * marginX,
+				 input.pattern.rows + 2 * marginY) &
+			imageArea;
+		bestFit = matchPattern(input, window, result,
+				       options.coarseToFine);
+		searchedFullImage = window == imageArea;
+	}
 
-	if (pBestFitValue) {
-		cv::minMaxLoc(result, nullptr, pBestFitValue);
+	// Fall back to searching the whole image if the pattern was not found
+	// around its last known location
+	const bool foundInWindow = bestFit > threshold;
+	if (!options.lastMatch || (!searchedFullImage && !foundInWindow)) {
+		result.setTo(cv::Scalar(0));
+		bestFit = matchPattern(input, imageArea, result,
+				       options.coarseToFine);
 	}
 
-	cv::threshold(result, result, threshold, 0.0, cv::THRESH_TOZERO);
+	if (pBestFitValue) {
+		*pBestFitValue = bestFit;
+	}
 }
 
 void MatchPattern(QImage &img, QImage &pattern, double threshold,
@@ -139,49 +301,47 @@ uchar GetAvgBrightness(QImage &img)
 		return 0;
 	}
 
+	// The brightness is the V component of the HSV color space, which is
+	// simply the maximum of the R, G and B components
 	auto image = QImageToMat(img);
-	cv::Mat hsvImage, rgbImage;
-	cv::cvtColor(image, rgbImage, cv::COLOR_RGBA2RGB);
-	cv::cvtColor(rgbImage, hsvImage, cv::COLOR_RGB2HSV);
-	long long brightnessSum = 0;
-	for (int i = 0; i < hsvImage.rows; ++i) {
-		for (int j = 0; j < hsvImage.cols; ++j) {
-			brightnessSum += hsvImage.at<cv::Vec3b>(i, j)[2];
-		}
-	}
-	return brightnessSum / (hsvImage.rows * hsvImage.cols);
+	std::vector<cv::Mat1b> channels;
+	cv::split(image, channels);
+	cv::Mat1b brightness;
+	cv::max(channels[0], channels[1], brightness);
+	cv::max(brightness, channels[2], brightness);
+	const auto brightnessSum =
+		static_cast<long long>(cv::sum(brightness)[0]);
+	return brightnessSum / (image.rows * image.cols);
 }
 
-static bool colorIsSimilar(const QColor &color1, const QColor &color2,
-			   int maxDiff)
+// Returns a mask of all pixels of the RGBA image, which are within maxDiff
+// of the given color in each of the R, G and B channels
+static cv::Mat1b getPixelsInColorRange(const cv::Mat &image,
+				       const QColor &color, int maxDiff)
 {
-	const int diffRed = std::abs(color1.red() - color2.red());
-	const int diffGreen = std::abs(color1.green() - color2.green());
-	const int diffBlue = std::abs(color1.blue() - color2.blue());
-
-	return diffRed <= maxDiff && diffGreen <= maxDiff &&
-	       diffBlue <= maxDiff;
+	const cv::Scalar lower(color.red() - maxDiff, color.green() - maxDiff,
+			       color.blue() - maxDiff, 0);
+	const cv::Scalar upper(color.red() + maxDiff, color.green() + maxDiff,
+			       color.blue() + maxDiff, 255);
+	cv::Mat1b mask;
+	cv::inRange(image, lower, upper, mask);
+	return mask;
 }
 
 cv::Mat PreprocessForOCR(const QImage &image, const QColor &textColor,
 			 double colorDiff)
 {
-	auto mat = QImageToMat(image);
-
 	// Tesseract works best when matching black text on a white background,
 	// so everything that matches the text color will be displayed black
 	// while the rest of the image should be white.
+	//
+	// Tesseract only needs a single channel, so the image is processed as
+	// grayscale to avoid scaling and converting all four channels.
 	const int diff = colorDiff * 255;
-	for (int y = 0; y < image.height(); y++) {
-		for (int x = 0; x < image.width(); x++) {
-			if (colorIsSimilar(image.pixelColor(x, y), textColor,
-					   diff)) {
-				mat.at<cv::Vec4b>(y, x) = {0, 0, 0, 255};
-			} else {
-				mat.at<cv::Vec4b>(y, x) = {255, 255, 255, 255};
-			}
-		}
-	}
+	const auto textMask =
+		getPixelsInColorRange(QImageToMat(image), textColor, diff);
+	cv::Mat1b mat;
+	cv::bitwise_not(textMask, mat);
 
 	// Scale image up if selected area is very small.
 	// Results will probably still be unsatisfying.
@@ -196,10 +356,7 @@ cv::Mat PreprocessForOCR(const QImage &image, const QColor &textColor,
 			   cv::Size(mat.cols * scale, mat.rows * scale),
 			   cv::INTER_CUBIC);
 	}
-
-	cv::Mat result;
-	mat.copyTo(result);
-	return result;
+	return mat;
 }
 
 std::optional<std::string> RunOCR(tesseract::TessBaseAPI *ocr,
@@ -214,9 +371,7 @@ std::optional<std::string> RunOCR(tesseract::TessBaseAPI *ocr,
 	}
 
 #ifdef OCR_SUPPORT
-	auto mat = PreprocessForOCR(image, color, colorDiff);
-	cv::Mat gray;
-	cv::cvtColor(mat, gray, cv::COLOR_RGBA2GRAY);
+	auto gray = PreprocessForOCR(image, color, colorDiff);
 	ocr->SetImage(gray.data, gray.cols, gray.rows, 1, gray.step);
 	ocr->Recognize(0);
 	std::unique_ptr<char[]> detectedText(ocr->GetUTF8Text());
@@ -235,18 +390,14 @@ bool ContainsPixelsInColorRange(const QImage &image, const QColor &color,
 				double colorDeviationThreshold,
 				double totalPixelMatchThreshold)
 {
+	if (image.isNull()) {
+		return false;
+	}
+
 	int totalPixels = image.width() * image.height();
-	int matchingPixels = 0;
 	int maxColorDiff = static_cast<int>(colorDeviationThreshold * 255.0);
-
-	for (int y = 0; y < image.height(); y++) {
-		for (int x = 0; x < image.width(); x++) {
-			if (colorIsSimilar(image.pixelColor(x, y), color,
-					   maxColorDiff)) {
-				matchingPixels++;
-			}
-		}
-	}
+	const int matchingPixels = cv::countNonZero(
+		getPixelsInColorRange(QImageToMat(image), color, maxColorDiff));
 
 	double matchPercentage =
 		static_cast<double>(matchingPixels) / totalPixels;
@@ -2,6 +2,7 @@
 #include <QImage>
 #undef NO // MacOS macro that can conflict with OpenCV
 #include <cstddef>
+#include <optional>
 #include <opencv2/opencv.hpp>
 
 #ifdef OCR_SUPPORT
@@ -61,10 +62,20 @@ struct PatternImageData {
 	cv::Mat1b mask;
 };
 
+// Options trading the accuracy of pattern matching for speed
+struct PatternMatchSearchOptions {
+	// Locate candidates on a downscaled image first and only match their
+	// surroundings at full resolution
+	bool coarseToFine = false;
+	// Search the area around the last match first
+	std::optional<cv::Point> lastMatch;
+};
+
 PatternImageData CreatePatternData(const QImage &pattern);
 void MatchPattern(QImage &img, const PatternImageData &patternData,
 		  double threshold, cv::Mat &result, double *pBestFitValue,
-		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode);
+		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode,
+		  const PatternMatchSearchOptions &options = {});
 void MatchPattern(QImage &img, QImage &pattern, double threshold,
 		  cv::Mat &result, double *pBestFitValue, bool useAlphaAsMask,
 		  cv::TemplateMatchModes matchMode);
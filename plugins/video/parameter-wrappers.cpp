@@ -13,6 +13,8 @@ bool PatternMatchParameters::Save(obs_data_t *obj) const
 	threshold.Save(data, "threshold");
 	obs_data_set_bool(data, "useAlphaAsMask", useAlphaAsMask);
 	obs_data_set_int(data, "matchMode", matchMode);
+	obs_data_set_bool(data, "useCoarseToFine", useCoarseToFine);
+	obs_data_set_bool(data, "restrictToLastMatch", restrictToLastMatch);
 	obs_data_set_int(data, "version", 1);
 	obs_data_set_obj(obj, "patternMatchData", data);
 	obs_data_release(data);
@@ -44,6 +46,8 @@ bool PatternMatchParameters::Load(obs_data_t *obj)
 		matchMode = static_cast<cv::TemplateMatchModes>(
 			obs_data_get_int(data, "matchMode"));
 	}
+	useCoarseToFine = obs_data_get_bool(data, "useCoarseToFine");
+	restrictToLastMatch = obs_data_get_bool(data, "restrictToLastMatch");
 	obs_data_release(data);
 	return true;
 }
@@ -279,52 +283,6 @@ static QColor LoadColor(obs_data_t *obj, const char *name)
 	return color;
 }
 
-OCRParameters::OCRParameters()
-{
-	Setup();
-}
-
-OCRParameters::~OCRParameters()
-{
-	if (!initDone) {
-		return;
-	}
-	ocr->End();
-}
-
-OCRParameters::OCRParameters(const OCRParameters &other)
-	: text(other.text),
-	  regex(other.regex),
-	  color(other.color),
-	  colorThreshold(other.colorThreshold),
-	  pageSegMode(other.pageSegMode),
-	  tesseractBasePath(other.tesseractBasePath),
-	  languageCode(other.languageCode),
-	  useConfig(other.useConfig),
-	  configFile(other.configFile)
-{
-	if (!initDone) {
-		Setup();
-	}
-}
-
-OCRParameters &OCRParameters::operator=(const OCRParameters &other)
-{
-	text = other.text;
-	regex = other.regex;
-	color = other.color;
-	colorThreshold = other.colorThreshold;
-	pageSegMode = other.pageSegMode;
-	tesseractBasePath = other.tesseractBasePath;
-	languageCode = other.languageCode;
-	useConfig = other.useConfig;
-	configFile = other.configFile;
-	if (!initDone) {
-		Setup();
-	}
-	return *this;
-}
-
 bool OCRParameters::Save(obs_data_t *obj) const
 {
 	auto data = obs_data_create();
@@ -367,17 +325,12 @@ bool OCRParameters::Load(obs_data_t *obj)
 	pageSegMode = static_cast<tesseract::PageSegMode>(
 		obs_data_get_int(data, "pageSegMode"));
 	obs_data_release(data);
-
-	Setup();
 	return true;
 }
 
 void OCRParameters::SetPageMode(tesseract::PageSegMode mode)
 {
 	pageSegMode = mode;
-	if (ocr) {
-		ocr->SetPageSegMode(mode);
-	}
 }
 
 bool OCRParameters::SetLanguageCode(const std::string &value)
@@ -389,7 +342,6 @@ bool OCRParameters::SetLanguageCode(const std::string &value)
 		return false;
 	}
 	languageCode = value;
-	Setup();
 	return true;
 }
 
@@ -408,7 +360,6 @@ bool OCRParameters::SetTesseractBasePath(const std::string &value)
 		return false;
 	}
 	tesseractBasePath = value;
-	Setup();
 	return true;
 }
 
@@ -420,43 +371,59 @@ std::string OCRParameters::GetTesseractBasePath() const
 void OCRParameters::EnableCustomConfig(bool enable)
 {
 	useConfig = enable;
-	Setup();
 }
 
 void OCRParameters::SetCustomConfigFile(const std::string &filename)
 {
 	configFile = filename;
-	Setup();
 }
 
-void OCRParameters::Setup()
+OCRConfig OCRParameters::GetConfig() const
+{
+	OCRConfig config;
+	config.tesseractBasePath = tesseractBasePath;
+	config.languageCode = languageCode;
+	config.useConfig = useConfig;
+	config.configFile = configFile;
+	config.pageSegMode = pageSegMode;
+	return config;
+}
+
+bool OCRConfig::operator==(const OCRConfig &other) const
+{
+	return tesseractBasePath == other.tesseractBasePath &&
+	       languageCode == other.languageCode &&
+	       useConfig == other.useConfig &&
+	       configFile == other.configFile &&
+	       pageSegMode == other.pageSegMode;
+}
+
+std::unique_ptr<tesseract::TessBaseAPI> CreateOCR(const OCRConfig &config)
 {
-	ocr = std::make_unique<tesseract::TessBaseAPI>();
+	auto ocr = std::make_unique<tesseract::TessBaseAPI>();
 	if (!ocr) {
-		initDone = false;
-		return;
+		return nullptr;
 	}
 
-	const std::string dataPath = std::string(tesseractBasePath) + "/";
-	const std::string modelFile =
-		std::string(languageCode) + ".traineddata";
+	const std::string dataPath = config.tesseractBasePath + "/";
+	const std::string modelFile = config.languageCode + ".traineddata";
 	const auto modelFullPath = QString::fromStdString(dataPath) +
 				   QString::fromStdString(modelFile);
 	QFileInfo modelFileInfo(modelFullPath);
 	if (!modelFileInfo.exists(modelFullPath)) {
-		initDone = false;
 		blog(LOG_WARNING,
 		     "cannot init tesseract! Model path does not exists: %s",
 		     modelFileInfo.absoluteFilePath().toStdString().c_str());
-		return;
+		return nullptr;
 	}
 
+	std::string configFile = config.configFile;
 	auto configPath = QString::fromStdString(configFile);
 	QFileInfo configFileInfo(configPath);
 	bool configFileExists = configFileInfo.exists(configPath);
 
-	bool setupWithConfig = useConfig;
-	if (useConfig && !configFileExists) {
+	bool setupWithConfig = config.useConfig;
+	if (config.useConfig && !configFileExists) {
 		blog(LOG_WARNING,
 		     "tesseract config file will be ignored! File does not exists: %s",
 		     configFileInfo.absoluteFilePath().toStdString().c_str());
@@ -464,18 +431,16 @@ void OCRParameters::Setup()
 	}
 
 	char *configs[] = {configFile.data()};
-	if (ocr->Init(dataPath.c_str(), languageCode.c_str(),
+	if (ocr->Init(dataPath.c_str(), config.languageCode.c_str(),
 		      tesseract::OEM_DEFAULT,
 		      setupWithConfig ? configs : nullptr,
 		      setupWithConfig ? 1 : 0, nullptr, nullptr, false) != 0) {
 		blog(LOG_WARNING, "tesseract init failed!");
-		initDone = false;
-		return;
+		return nullptr;
 	}
 
-	ocr->SetPageSegMode(pageSegMode);
-
-	initDone = true;
+	ocr->SetPageSegMode(config.pageSegMode);
+	return ocr;
 }
 
 bool ColorParameters::Save(obs_data_t *obj) const
@@ -61,6 +61,10 @@ public:
 	bool useAlphaAsMask = false;
 	cv::TemplateMatchModes matchMode = cv::TM_CCORR_NORMED;
 	NumberVariable<double> threshold = 0.999;
+	// Locate candidates on a downscaled image first
+	bool useCoarseToFine = false;
+	// Search around the previous match location before the whole image
+	bool restrictToLastMatch = false;
 };
 
 class ObjDetectParameters {
@@ -87,17 +91,31 @@ private:
 			"/res/cascadeClassifiers/haarcascade_frontalface_alt.xml");
 };
 
+// Settings required to set up a Tesseract instance
+struct OCRConfig {
+	bool operator==(const OCRConfig &) const;
+	bool operator!=(const OCRConfig &other) const
+	{
+		return !(*this == other);
+	}
+
+	std::string tesseractBasePath;
+	std::string languageCode;
+	bool useConfig = false;
+	std::string configFile;
+	tesseract::PageSegMode pageSegMode = tesseract::PSM_SINGLE_BLOCK;
+};
+
+// Returns nullptr if the Tesseract instance could not be initialized
+std::unique_ptr<tesseract::TessBaseAPI> CreateOCR(const OCRConfig &);
+
+// The Tesseract instances are owned by the users of the parameters, as they
+// are expensive to create and only needed while text recognition is running
 class OCRParameters {
 public:
-	OCRParameters();
-	~OCRParameters();
-	OCRParameters(const OCRParameters &other);
-	OCRParameters &operator=(const OCRParameters &);
-
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 
-	bool Initialized() const { return initDone; }
 	void SetPageMode(tesseract::PageSegMode);
 	bool SetLanguageCode(const std::string &);
 	std::string GetLanguageCode() const;
@@ -108,7 +126,7 @@ public:
 	void SetCustomConfigFile(const std::string &);
 	std::string GetCustomConfigFile() const { return configFile; }
 	tesseract::PageSegMode GetPageMode() const { return pageSegMode; }
-	tesseract::TessBaseAPI *GetOCR() const { return ocr.get(); }
+	OCRConfig GetConfig() const;
 
 	StringVariable text = obs_module_text("AdvSceneSwitcher.enterText");
 	RegexConfig regex = RegexConfig::PartialMatchRegexConfig();
@@ -116,8 +134,6 @@ public:
 	DoubleVariable colorThreshold = 0.3;
 
 private:
-	void Setup();
-
 	tesseract::PageSegMode pageSegMode = tesseract::PSM_SINGLE_BLOCK;
 	StringVariable tesseractBasePath =
 		obs_get_module_data_path(obs_current_module()) +
@@ -125,8 +141,6 @@ private:
 	StringVariable languageCode = "eng";
 	bool useConfig = false;
 	std::string configFile = "config.txt";
-	std::unique_ptr<tesseract::TessBaseAPI> ocr;
-	bool initDone = false;
 };
 
 class ColorParameters {
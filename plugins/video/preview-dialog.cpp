@@ -385,12 +385,24 @@ void PreviewImage::MarkOCRMatch(QImage &screenshot,
 			"AdvSceneSwitcher.condition.video.ocrMatchFail"));
 		return;
 	}
-	auto text = RunOCR(ocrParams->GetOCR(), screenshot, ocrParams->color,
-			   ocrParams->colorThreshold);
 
+	const auto config = ocrParams->GetConfig();
+	if (!_ocrConfig || *_ocrConfig != config) {
+		_ocr = CreateOCR(config);
+		_ocrConfig = config;
+	}
+	if (!_ocr) {
+		emit StatusUpdate(obs_module_text(
+			"AdvSceneSwitcher.condition.video.ocrMatchFail"));
+		return;
+	}
+
+	auto text = RunOCR(_ocr.get(), screenshot, ocrParams->color,
+			   ocrParams->colorThreshold);
 	if (!text) {
 		emit StatusUpdate(obs_module_text(
 			"AdvSceneSwitcher.condition.video.ocrMatchFail"));
+		return;
 	}
 
 	QString status(obs_module_text(
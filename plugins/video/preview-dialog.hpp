@@ -9,6 +9,7 @@
 #include <QRubberBand>
 #include <QPoint>
 #include <mutex>
+#include <optional>
 
 namespace advss {
 
@@ -47,6 +48,9 @@ private:
 	void MarkOCRMatch(QImage &, const std::shared_ptr<OCRParameters> &);
 
 	std::mutex &_mtx;
+	// Only set up once text recognition is previewed
+	std::unique_ptr<tesseract::TessBaseAPI> _ocr;
+	std::optional<OCRConfig> _ocrConfig;
 };
 
 class PreviewDialog : public QDialog {
@@ -52,6 +52,35 @@ TEST_CASE("MatchJson", "[json-helpers]")
 	REQUIRE(result == false);
 }
 
+TEST_CASE("JsonMatcher", "[json-helpers]")
+{
+	advss::RegexConfig regex;
+	advss::JsonMatcher matcher;
+	REQUIRE(matcher.Matches("{}", "{}", regex));
+	REQUIRE(matcher.Matches("{\"test\":true}",
+				"{\n    \"test\": true\n}\n", regex));
+	REQUIRE(matcher.Matches("{\"a\":1,\"b\":\"2\"}",
+				"{\"b\":\"2\",\"a\":1.0}", regex));
+	REQUIRE_FALSE(matcher.Matches("{\"a\":1}", "{\"a\":\"1\"}", regex));
+	REQUIRE_FALSE(matcher.Matches("{\"a\":1}", "{\"a\":1,\"b\":2}", regex));
+	REQUIRE_FALSE(matcher.Matches("{\"a\":[1,2]}", "{\"a\":[2,1]}", regex));
+	REQUIRE_FALSE(matcher.Matches("{}", "abc", regex));
+	REQUIRE(matcher.Matches("abc", "abc", regex));
+
+	regex.SetEnabled(true);
+	REQUIRE(matcher.Matches("{\"url\":\"https://test.com\"}",
+				"{\"url\":\"https://.*\"}", regex));
+	REQUIRE_FALSE(matcher.Matches("{\"url\":\"http://test.com\"}",
+				      "{\"url\":\"https://.*\"}", regex));
+	// Expressions are applied to the whole document
+	REQUIRE(matcher.Matches("{\"https://test.com\":1}",
+				"{\"https://.*\":1}", regex));
+	REQUIRE(matcher.Matches("{\"a\":123,\"b\":2}",
+				"(.|\\n)*\"a\": 1\\d+(.|\\n)*", regex));
+	REQUIRE(matcher.Matches("{\"test\":true}", "(.|\\n)*", regex));
+	REQUIRE_FALSE(matcher.Matches("{\"test\":true}", "(", regex));
+}
+
 TEST_CASE("GetJsonField", "[json-helpers]")
 {
 	auto result = advss::GetJsonField("{}", "");
@@ -0,0 +1,63 @@
+#include "catch.hpp"
+
+#include <latency-histogram.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Empty", "[latency-histogram]")
+{
+	advss::LatencyHistogram histogram;
+	REQUIRE(histogram.Count() == 0);
+	REQUIRE(histogram.Max() == 0us);
+	REQUIRE(histogram.Percentile(50.0) == 0us);
+}
+
+TEST_CASE("Percentile", "[latency-histogram]")
+{
+	advss::LatencyHistogram histogram;
+	for (int i = 1; i <= 1000; i++) {
+		histogram.Record(std::chrono::microseconds(i));
+	}
+	REQUIRE(histogram.Count() == 1000);
+	REQUIRE(histogram.Max() == 1000us);
+
+	// Relative error is bounded by the sub-bucket resolution
+	const auto withinError = [](std::chrono::microseconds value,
+				    std::chrono::microseconds expected) {
+		return value >= expected && value <= expected * 1125 / 1000;
+	};
+	REQUIRE(withinError(histogram.Percentile(50.0), 500us));
+	REQUIRE(withinError(histogram.Percentile(95.0), 950us));
+	REQUIRE(withinError(histogram.Percentile(99.0), 990us));
+	REQUIRE(histogram.Percentile(100.0) == 1000us);
+
+	const auto summary = histogram.GetSummary();
+	REQUIRE(summary.count == 1000);
+	REQUIRE(summary.p50 == histogram.Percentile(50.0));
+	REQUIRE(summary.max == 1000us);
+}
+
+TEST_CASE("Small and large values", "[latency-histogram]")
+{
+	advss::LatencyHistogram histogram;
+	histogram.Record(500ns);
+	REQUIRE(histogram.Percentile(100.0) == 0us);
+
+	histogram.Record(5us);
+	REQUIRE(histogram.Percentile(100.0) == 5us);
+
+	histogram.Record(std::chrono::hours(24 * 365));
+	REQUIRE(histogram.Count() == 3);
+	REQUIRE(histogram.Max() == std::chrono::hours(24 * 365));
+	REQUIRE(histogram.Percentile(100.0) > std::chrono::hours(24));
+}
+
+TEST_CASE("Reset", "[latency-histogram]")
+{
+	advss::LatencyHistogram histogram;
+	histogram.Record(10ms);
+	histogram.Reset();
+	REQUIRE(histogram.Count() == 0);
+	REQUIRE(histogram.Max() == 0us);
+	REQUIRE(histogram.Percentile(99.0) == 0us);
+}
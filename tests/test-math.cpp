@@ -119,6 +119,57 @@ TEST_CASE("GetInt", "[math-helpers]")
 	REQUIRE_FALSE(advss::GetInt("1.0").has_value());
 }
 
+TEST_CASE("Expressions with variables", "[math-helpers]")
+{
+	auto expressionResult = advss::EvalMathExpression(
+		"a * 2 + b", {{"a", 1.0}, {"b", 2.0}});
+	auto *doubleValuePtr = std::get_if<double>(&expressionResult);
+
+	REQUIRE(doubleValuePtr != nullptr);
+	REQUIRE(*doubleValuePtr == 4.0);
+
+	expressionResult = advss::EvalMathExpression(
+		"a * 2 + b", {{"a", 3.0}, {"b", 4.0}});
+	doubleValuePtr = std::get_if<double>(&expressionResult);
+
+	REQUIRE(doubleValuePtr != nullptr);
+	REQUIRE(*doubleValuePtr == 10.0);
+
+	expressionResult = advss::EvalMathExpression("a * 2 + b", {{"a", 3.0}});
+	REQUIRE(std::holds_alternative<std::string>(expressionResult));
+
+	expressionResult = advss::EvalMathExpression("a * 2 + b");
+	REQUIRE(std::holds_alternative<std::string>(expressionResult));
+}
+
+TEST_CASE("Expressions with substituted values", "[math-helpers]")
+{
+	auto eval = [](const std::vector<advss::MathExpressionPart> &parts) {
+		auto result = advss::EvalMathExpression(parts);
+		auto *value = std::get_if<double>(&result);
+		REQUIRE(value != nullptr);
+		return *value;
+	};
+
+	REQUIRE(eval({{"5", true}, {" * 2", false}}) == 10.0);
+	REQUIRE(eval({{"7", true}, {" * 2", false}}) == 14.0);
+	REQUIRE(eval({{"(", false}, {"1.5", true}, {")", false}}) == 1.5);
+
+	// Values which are not delimited by operators are substituted as text
+	REQUIRE(eval({{"10", false}, {"5", true}}) == 105.0);
+	REQUIRE(eval({{"5", true}, {"0 + 1", false}}) == 51.0);
+	REQUIRE(eval({{"1", true}, {"2", true}}) == 12.0);
+
+	// Negative values are substituted as text to keep the precedence of
+	// the unary minus
+	REQUIRE(eval({{"-3", true}, {"^2", false}}) == -9.0);
+	REQUIRE(eval({{"2 - ", false}, {"-3", true}}) == 5.0);
+
+	auto result = advss::EvalMathExpression(
+		{{"abc", true}, {" * 2", false}});
+	REQUIRE(std::holds_alternative<std::string>(result));
+}
+
 TEST_CASE("GetDouble", "[math-helpers]")
 {
 	auto result = advss::GetDouble("1");
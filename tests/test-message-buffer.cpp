@@ -0,0 +1,140 @@
+#include "catch.hpp"
+
+#include <message-buffer.hpp>
+
+#include <string>
+#include <thread>
+
+using Buffer = advss::MessageBuffer<std::string>;
+
+TEST_CASE("Append and consume", "[message-buffer]")
+{
+	Buffer buffer(4);
+	REQUIRE(buffer.Empty());
+	REQUIRE_FALSE(buffer.ConsumeMessage());
+
+	buffer.AppendMessage("a");
+	buffer.AppendMessage("b");
+	REQUIRE_FALSE(buffer.Empty());
+	REQUIRE(*buffer.ConsumeMessage() == "a");
+	REQUIRE(*buffer.ConsumeMessage() == "b");
+	REQUIRE(buffer.Empty());
+
+	buffer.AppendMessage("c");
+	buffer.Clear();
+	REQUIRE(buffer.Empty());
+	REQUIRE_FALSE(buffer.ConsumeMessage());
+}
+
+TEST_CASE("Capacity", "[message-buffer]")
+{
+	REQUIRE(Buffer(0).Capacity() == 2);
+	REQUIRE(Buffer(4).Capacity() == 4);
+	REQUIRE(Buffer(5).Capacity() == 8);
+}
+
+TEST_CASE("Overflow", "[message-buffer]")
+{
+	SECTION("Drop oldest")
+	{
+		Buffer buffer(2, Buffer::OverflowPolicy::DROP_OLDEST);
+		buffer.AppendMessage("a");
+		buffer.AppendMessage("b");
+		buffer.AppendMessage("c");
+		REQUIRE(buffer.GetDroppedMessageCount() == 1);
+		REQUIRE(*buffer.ConsumeMessage() == "b");
+		REQUIRE(*buffer.ConsumeMessage() == "c");
+		REQUIRE_FALSE(buffer.ConsumeMessage());
+	}
+
+	SECTION("Drop newest")
+	{
+		Buffer buffer(2, Buffer::OverflowPolicy::DROP_NEWEST);
+		buffer.AppendMessage("a");
+		buffer.AppendMessage("b");
+		buffer.AppendMessage("c");
+		REQUIRE(buffer.GetDroppedMessageCount() == 1);
+		REQUIRE(*buffer.ConsumeMessage() == "a");
+		REQUIRE(*buffer.ConsumeMessage() == "b");
+		REQUIRE_FALSE(buffer.ConsumeMessage());
+	}
+
+	SECTION("Block")
+	{
+		Buffer buffer(2, Buffer::OverflowPolicy::BLOCK);
+		std::thread producer([&buffer]() {
+			for (int i = 0; i < 100; i++) {
+				buffer.AppendMessage(std::to_string(i));
+			}
+		});
+
+		int expected = 0;
+		while (expected < 100) {
+			auto message = buffer.ConsumeMessage();
+			if (!message) {
+				continue;
+			}
+			REQUIRE(*message == std::to_string(expected));
+			expected++;
+		}
+		producer.join();
+		REQUIRE(buffer.GetDroppedMessageCount() == 0);
+	}
+}
+
+TEST_CASE("Shared messages", "[message-buffer]")
+{
+	Buffer buffer1;
+	Buffer buffer2;
+	auto message = std::make_shared<const std::string>("a");
+	buffer1.AppendMessage(message);
+	buffer2.AppendMessage(message);
+	REQUIRE(buffer1.ConsumeMessage() == message);
+	REQUIRE(buffer2.ConsumeMessage() == message);
+}
+
+TEST_CASE("Consume batch", "[message-buffer]")
+{
+	Buffer buffer;
+	for (int i = 0; i < 10; i++) {
+		buffer.AppendMessage(std::to_string(i));
+	}
+
+	std::vector<Buffer::Message> messages;
+	REQUIRE(buffer.ConsumeMessages(messages, 4) == 4);
+	REQUIRE(messages.size() == 4);
+	REQUIRE(*messages[0] == "0");
+	REQUIRE(*messages[3] == "3");
+
+	REQUIRE(buffer.ConsumeMessages(messages) == 6);
+	REQUIRE(messages.size() == 10);
+	REQUIRE(*messages[9] == "9");
+	REQUIRE(buffer.Empty());
+}
+
+TEST_CASE("Multiple producers", "[message-buffer]")
+{
+	Buffer buffer(64, Buffer::OverflowPolicy::BLOCK);
+	constexpr int producerCount = 4;
+	constexpr int messageCount = 1000;
+
+	std::vector<std::thread> producers;
+	for (int i = 0; i < producerCount; i++) {
+		producers.emplace_back([&buffer]() {
+			for (int j = 0; j < messageCount; j++) {
+				buffer.AppendMessage("message");
+			}
+		});
+	}
+
+	int consumed = 0;
+	while (consumed < producerCount * messageCount) {
+		if (buffer.ConsumeMessage()) {
+			consumed++;
+		}
+	}
+	for (auto &producer : producers) {
+		producer.join();
+	}
+	REQUIRE(buffer.Empty());
+}
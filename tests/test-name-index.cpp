@@ -0,0 +1,67 @@
+#include "catch.hpp"
+
+#include <name-index.hpp>
+
+namespace {
+
+struct NamedObject {
+	NamedObject(const std::string &name) : _name(name) {}
+	std::string Name() const { return _name; }
+	std::string _name;
+};
+
+uint64_t generation = 0;
+
+uint64_t getGeneration()
+{
+	return generation;
+}
+
+} // namespace
+
+TEST_CASE("Find", "[name-index]")
+{
+	std::deque<std::shared_ptr<NamedObject>> objects;
+	advss::NameIndex<NamedObject> index(objects, getGeneration);
+	REQUIRE_FALSE(index.Find("a"));
+
+	objects.emplace_back(std::make_shared<NamedObject>("a"));
+	objects.emplace_back(std::make_shared<NamedObject>("b"));
+	REQUIRE(index.Find("a") == objects[0]);
+	REQUIRE(index.Find("b") == objects[1]);
+	REQUIRE_FALSE(index.Find("c"));
+
+	// Duplicates resolve to the first element
+	objects.emplace_back(std::make_shared<NamedObject>("a"));
+	REQUIRE(index.Find("a") == objects[0]);
+}
+
+TEST_CASE("Rename", "[name-index]")
+{
+	std::deque<std::shared_ptr<NamedObject>> objects;
+	advss::NameIndex<NamedObject> index(objects, getGeneration);
+	objects.emplace_back(std::make_shared<NamedObject>("a"));
+	auto object = index.Find("a");
+	REQUIRE(object);
+
+	object->_name = "renamed";
+	++generation;
+	REQUIRE_FALSE(index.Find("a"));
+	REQUIRE(index.Find("renamed") == object);
+}
+
+TEST_CASE("Reorder and remove", "[name-index]")
+{
+	std::deque<std::shared_ptr<NamedObject>> objects;
+	advss::NameIndex<NamedObject> index(objects, getGeneration);
+	objects.emplace_back(std::make_shared<NamedObject>("a"));
+	objects.emplace_back(std::make_shared<NamedObject>("b"));
+	auto a = index.Find("a");
+
+	std::swap(objects[0], objects[1]);
+	REQUIRE(index.Find("a") == a);
+
+	objects.pop_back();
+	REQUIRE_FALSE(index.Find("a"));
+	REQUIRE(index.Find("b") == objects[0]);
+}
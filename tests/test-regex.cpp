@@ -81,6 +81,118 @@ TEST_CASE("Matches (PartialMatchRegexConfig)", "[regex-config]")
 	REQUIRE(result == true);
 }
 
+TEST_CASE("Matches (cached expression)", "[regex-config]")
+{
+	advss::RegexConfig regex(true);
+	for (int i = 0; i < 3; i++) {
+		REQUIRE(regex.Matches(std::string("abc"), "a.c"));
+		REQUIRE(regex.Matches(QString("abc"), QString("a.c")));
+		REQUIRE_FALSE(regex.Matches(std::string("abc"), "a\\.c"));
+		REQUIRE(regex.Matches(std::string("a.c"), "a\\.c"));
+	}
+
+	REQUIRE(regex.Matches(std::string("abc"), "abc"));
+	REQUIRE_FALSE(regex.Matches(std::string("abcd"), "abc"));
+	REQUIRE(regex.Matches(QString("abc"), QString("abc")));
+	REQUIRE_FALSE(regex.Matches(QString("abcd"), QString("abc")));
+
+	auto copy = regex;
+	copy.SetPatternOptions(QRegularExpression::CaseInsensitiveOption);
+	REQUIRE(copy.Matches(std::string("ABC"), "abc"));
+	REQUIRE_FALSE(regex.Matches(std::string("ABC"), "abc"));
+
+	// Copies matching different expressions do not affect each other
+	advss::RegexConfig other;
+	other = regex;
+	for (int i = 0; i < 3; i++) {
+		REQUIRE(regex.Matches(std::string("abc"), "a.c"));
+		REQUIRE(other.Matches(std::string("xyz"), "x.z"));
+		REQUIRE_FALSE(other.Matches(std::string("abc"), "x.z"));
+	}
+}
+
+TEST_CASE("GetRegularExpression", "[regex-config]")
+{
+	advss::RegexConfig regex(true);
+	auto expr = regex.GetRegularExpression(std::string("(a)(b)"));
+	REQUIRE(expr.isValid());
+	auto match = expr.match("ab");
+	REQUIRE(match.hasMatch());
+	REQUIRE(match.captured(2) == "b");
+
+	expr = regex.GetRegularExpression(QString("abc"));
+	REQUIRE(expr.match("abc").hasMatch());
+	REQUIRE_FALSE(expr.match("abcd").hasMatch());
+
+	regex = advss::RegexConfig::PartialMatchRegexConfig(true);
+	expr = regex.GetRegularExpression(QString("abc"));
+	REQUIRE(expr.match("abcd").hasMatch());
+}
+
+TEST_CASE("GetRegexLiteral", "[regex-config]")
+{
+	using Type = advss::RegexLiteral::Type;
+	auto literalMatches = [](const std::string &expression,
+				 const advss::RegexConfig &regex, Type type,
+				 const std::string &text = "") {
+		const auto literal = advss::GetRegexLiteral(expression, regex);
+		return literal.type == type && literal.text == text;
+	};
+
+	advss::RegexConfig regex(false);
+	REQUIRE(literalMatches("a.*", regex, Type::EXACT, "a.*"));
+
+	// Full match
+	regex.SetEnabled(true);
+	REQUIRE(literalMatches("abc", regex, Type::EXACT, "abc"));
+	REQUIRE(literalMatches("^abc", regex, Type::EXACT, "abc"));
+	REQUIRE(literalMatches("abc$", regex, Type::PREFIX, "abc"));
+	REQUIRE(literalMatches("abc.*", regex, Type::PREFIX, "abc"));
+	REQUIRE(literalMatches(".*abc", regex, Type::ANY));
+
+	// Partial match
+	auto partialRegex = advss::RegexConfig::PartialMatchRegexConfig(true);
+	REQUIRE(literalMatches("abc", partialRegex, Type::CONTAINS, "abc"));
+	REQUIRE(literalMatches("^abc", partialRegex, Type::PREFIX, "abc"));
+	REQUIRE(literalMatches("^abc.", partialRegex, Type::PREFIX, "abc"));
+	REQUIRE(literalMatches("abc$", partialRegex, Type::ANY));
+	REQUIRE(literalMatches("a.c", partialRegex, Type::ANY));
+
+	// Quantifiers make the last character optional
+	REQUIRE(literalMatches("abc?", regex, Type::PREFIX, "ab"));
+	REQUIRE(literalMatches("abc*", regex, Type::PREFIX, "ab"));
+	REQUIRE(literalMatches("abc+", regex, Type::PREFIX, "ab"));
+	REQUIRE(literalMatches("abc{2}", regex, Type::PREFIX, "ab"));
+	REQUIRE(literalMatches("a?", regex, Type::ANY));
+	REQUIRE(literalMatches("^a*", partialRegex, Type::ANY));
+
+	// Escaped characters
+	REQUIRE(literalMatches("ab\\.c", regex, Type::PREFIX, "ab"));
+	REQUIRE(literalMatches("\\d+", regex, Type::ANY));
+	REQUIRE(literalMatches("a\\.c", partialRegex, Type::ANY));
+
+	// Alternatives
+	REQUIRE(literalMatches("ab|cd", regex, Type::ANY));
+	REQUIRE(literalMatches("^ab|cd", partialRegex, Type::ANY));
+
+	// Non-ASCII characters
+	const std::string e = "\xC3\xA9"; // U+00E9
+	REQUIRE(literalMatches("ab" + e, regex, Type::EXACT, "ab" + e));
+	REQUIRE(literalMatches("ab" + e + "?", regex, Type::PREFIX, "ab"));
+	REQUIRE(literalMatches(e + e + "+", regex, Type::PREFIX, e));
+	REQUIRE(literalMatches(e + "*", regex, Type::ANY));
+	REQUIRE(literalMatches("^" + e + ".", partialRegex, Type::PREFIX, e));
+	REQUIRE(literalMatches(e, partialRegex, Type::CONTAINS, e));
+
+	// Options
+	regex.SetPatternOptions(QRegularExpression::CaseInsensitiveOption);
+	REQUIRE(literalMatches("abc", regex, Type::ANY));
+	regex.SetPatternOptions(QRegularExpression::MultilineOption);
+	REQUIRE(literalMatches("^abc", regex, Type::ANY));
+	regex.SetPatternOptions(QRegularExpression::DotMatchesEverythingOption);
+	REQUIRE(literalMatches("abc.*", regex, Type::PREFIX, "abc"));
+}
+
 TEST_CASE("EscapeForRegex , [text-helpers]")
 {
 	REQUIRE(advss::EscapeForRegex("") == "");
@@ -0,0 +1,74 @@
+#include "catch.hpp"
+
+#include <thread-pool.hpp>
+
+TEST_CASE("Submit", "[thread-pool]")
+{
+	advss::ThreadPool pool;
+	pool.SetThreadCount(4);
+	REQUIRE(pool.GetThreadCount() == 4);
+
+	std::atomic_int counter = 0;
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < 100; i++) {
+		futures.emplace_back(pool.Submit([&counter]() { ++counter; }));
+	}
+	for (const auto &future : futures) {
+		pool.Wait(future);
+	}
+	REQUIRE(counter == 100);
+}
+
+TEST_CASE("SetThreadCount", "[thread-pool]")
+{
+	advss::ThreadPool pool;
+	REQUIRE(pool.GetThreadCount() == 0);
+
+	// Tasks are run on the calling thread if no workers are available
+	bool done = false;
+	auto inlineTask = pool.Submit([&done]() { done = true; });
+	REQUIRE(done);
+
+	std::atomic_int counter = 0;
+	std::vector<std::future<void>> futures;
+	for (size_t count : {3, 1, 0, 2}) {
+		pool.SetThreadCount(count);
+		REQUIRE(pool.GetThreadCount() == count);
+		for (int i = 0; i < 10; i++) {
+			futures.emplace_back(
+				pool.Submit([&counter]() { ++counter; }));
+		}
+	}
+	for (const auto &future : futures) {
+		pool.Wait(future);
+	}
+	REQUIRE(counter == 40);
+}
+
+TEST_CASE("Stop", "[thread-pool]")
+{
+	advss::ThreadPool pool;
+	pool.SetThreadCount(1);
+
+	std::atomic_int counter = 0;
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < 10; i++) {
+		futures.emplace_back(pool.Submit([&counter]() {
+			std::this_thread::sleep_for(
+				std::chrono::milliseconds(1));
+			++counter;
+		}));
+	}
+
+	// All remaining tasks are processed before stopping
+	pool.Stop();
+	REQUIRE(counter == 10);
+	for (const auto &future : futures) {
+		REQUIRE(future.wait_for(std::chrono::seconds(0)) ==
+			std::future_status::ready);
+	}
+
+	bool done = false;
+	auto inlineTask = pool.Submit([&done]() { done = true; });
+	REQUIRE(done);
+}
@@ -1,6 +1,9 @@
 #include "catch.hpp"
 
 #include <variable.hpp>
+#include <variable-string.hpp>
+
+#include <algorithm>
 #include <thread>
 
 TEST_CASE("Variable", "[variable]")
@@ -14,11 +17,16 @@ TEST_CASE("Variable", "[variable]")
 	REQUIRE(variable.GetSaveAction() ==
 		advss::Variable::SaveAction::DONT_SAVE);
 	REQUIRE(variable.GetValueChangeCount() == 0);
+	REQUIRE(variable.GetValueGeneration() == 0);
 
 	variable.SetValue("testing");
 	REQUIRE(variable.Value() == "testing");
 	REQUIRE(variable.GetPreviousValue() == "");
 	REQUIRE(variable.GetValueChangeCount() == 1);
+	REQUIRE(variable.GetValueGeneration() == 1);
+
+	variable.SetValue("testing");
+	REQUIRE(variable.GetValueGeneration() == 1);
 
 	variable.SetValue(123);
 	REQUIRE(variable.Value() == "123");
@@ -50,3 +58,115 @@ TEST_CASE("Variable", "[variable]")
 	variable.SetValue(123);
 	REQUIRE(*variable.GetSecondsSinceLastChange() > 0);
 }
+
+static std::shared_ptr<advss::Variable> addVariable(const std::string &name,
+						    const std::string &value)
+{
+	auto variable = std::make_shared<advss::Variable>();
+	variable->SetName(name);
+	variable->SetValue(value);
+	advss::GetVariables().emplace_back(variable);
+	return variable;
+}
+
+static void removeVariable(const std::string &name)
+{
+	auto &variables = advss::GetVariables();
+	variables.erase(std::remove_if(variables.begin(), variables.end(),
+				       [&name](const auto &variable) {
+					       return variable->Name() == name;
+				       }),
+			variables.end());
+}
+
+TEST_CASE("StringVariable", "[variable]")
+{
+	auto a = addVariable("a", "1");
+	auto b = addVariable("b", "2");
+
+	SECTION("Plain text")
+	{
+		advss::StringVariable text = "no variables";
+		REQUIRE(std::string(text) == "no variables");
+	}
+
+	SECTION("Referenced twice")
+	{
+		advss::StringVariable text = "${a}-${a}";
+		REQUIRE(std::string(text) == "1-1");
+		a->SetValue("3");
+		REQUIRE(std::string(text) == "3-3");
+	}
+
+	SECTION("Only the changed variable is updated")
+	{
+		advss::StringVariable text = "${a} ${b}";
+		REQUIRE(std::string(text) == "1 2");
+		b->SetValue("4");
+		REQUIRE(std::string(text) == "1 4");
+		a->SetValue("5");
+		REQUIRE(std::string(text) == "5 4");
+	}
+
+	SECTION("Adjacent placeholders")
+	{
+		advss::StringVariable text = "${a}${b}${a}";
+		REQUIRE(std::string(text) == "121");
+	}
+
+	SECTION("Missing closing brace")
+	{
+		advss::StringVariable text = "${a";
+		REQUIRE(std::string(text) == "${a");
+		text = "${a}${b";
+		REQUIRE(std::string(text) == "1${b");
+		text = "${";
+		REQUIRE(std::string(text) == "${");
+	}
+
+	SECTION("Nested placeholders")
+	{
+		// Variable values are not expanded a second time
+		advss::StringVariable text = "${${a}}";
+		REQUIRE(std::string(text) == "${1}");
+		a->SetValue("${b}");
+		text = "${a}";
+		REQUIRE(std::string(text) == "${b}");
+	}
+
+	SECTION("Unknown variable")
+	{
+		advss::StringVariable text = "${c}";
+		REQUIRE(std::string(text) == "${c}");
+
+		auto c = addVariable("c", "6");
+		REQUIRE(std::string(text) == "6");
+		removeVariable("c");
+	}
+
+	SECTION("Renamed variable")
+	{
+		advss::StringVariable oldName = "${a}";
+		advss::StringVariable newName = "${d}";
+		REQUIRE(std::string(oldName) == "1");
+		REQUIRE(std::string(newName) == "${d}");
+
+		a->SetName("d");
+		REQUIRE(std::string(oldName) == "${a}");
+		REQUIRE(std::string(newName) == "1");
+	}
+
+	SECTION("Removed variable")
+	{
+		advss::StringVariable text = "${b}!";
+		REQUIRE(std::string(text) == "2!");
+
+		removeVariable("b");
+		b.reset();
+		REQUIRE(std::string(text) == "${b}!");
+	}
+
+	removeVariable("a");
+	removeVariable("b");
+	removeVariable("d");
+}